@@ -0,0 +1,233 @@
+#include "Simulation.h"
+
+#include "Game.h"
+#include "GameContext.h"
+#include "GameState.h"
+#include "Utility.h"
+#include "Input/InputSource.h"
+#include "Input/BotInput.h"
+#include "Bot/Board.h"
+#include "Bot/Expectimax.h"
+#include "Replay.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Sweeps pieces out to both walls and back, spreading them across the width of the matrix.
+static const std::vector<playerInput_t> defaultScript = {
+	playerInput_t::MOVE_LEFT, playerInput_t::MOVE_LEFT, playerInput_t::MOVE_LEFT, playerInput_t::MOVE_LEFT, playerInput_t::HARD_DROP,
+	playerInput_t::ROTATE_CLOCKWISE, playerInput_t::MOVE_LEFT, playerInput_t::MOVE_LEFT, playerInput_t::HARD_DROP,
+	playerInput_t::HARD_DROP,
+	playerInput_t::MOVE_RIGHT, playerInput_t::MOVE_RIGHT, playerInput_t::HARD_DROP,
+	playerInput_t::ROTATE_COUNTERCLOCKWISE, playerInput_t::MOVE_RIGHT, playerInput_t::MOVE_RIGHT, playerInput_t::MOVE_RIGHT, playerInput_t::MOVE_RIGHT, playerInput_t::HARD_DROP,
+	playerInput_t::SOFT_DROP, playerInput_t::SOFT_DROP, playerInput_t::HARD_DROP
+};
+
+static Bot::expectimaxSettings_t GetSearchSettings(const simulationSettings_t& settings)
+{
+	Bot::expectimaxSettings_t search;
+	if (settings.searchDepth > 0)
+		search.depth = settings.searchDepth;
+	return search;
+}
+
+static std::unique_ptr<InputSource> CreateInputSource(const simulationSettings_t& settings, const uint32_t& seed)
+{
+	switch (settings.inputSource)
+	{
+	case inputSourceType_t::SCRIPTED:
+		return std::make_unique<ScriptedInput>(defaultScript, settings.inputInterval);
+	case inputSourceType_t::RANDOM:
+		return std::make_unique<RandomInput>(seed, settings.inputInterval);
+	case inputSourceType_t::BOT:
+		// Games already run one to a thread, so the bot scores its candidates serially.
+		if (settings.searchDepth > 0)
+			return std::make_unique<BotInput>(GetSearchSettings(settings), Bot::weights_t(), nullptr, settings.inputInterval);
+		return std::make_unique<BotInput>(Bot::weights_t(), nullptr, settings.inputInterval);
+	default:
+		throw std::runtime_error("Unknown input source type!");
+	}
+}
+
+// Sets up a game on the registry and starts it, with the bag dealing from the seed.
+static void StartGame(entt::registry& registry, const simulationSettings_t& settings, const uint32_t& seed)
+{
+	Replay::header_t header;
+	header.seed = seed;
+	header.pieceRandomizer = settings.pieceRandomizer;
+	header.tickLength = settings.tickLength;
+	header.checksumInterval = settings.checksumInterval;
+	Replay::StartGame(registry, header);
+
+	GetGameContext(registry).profileSystems = settings.profileSystems;
+}
+
+gameResult_t RunGame(const simulationSettings_t& settings, const uint32_t& seed)
+{
+	entt::registry registry;
+	StartGame(registry, settings, seed);
+
+	const auto& context = GetGameContext(registry);
+	auto input = CreateInputSource(settings, seed);
+
+	std::unique_ptr<Replay::Recorder> recorder;
+	if (!settings.recordPath.empty())
+	{
+		Replay::header_t header = Replay::ReadHeader(registry);
+		header.checksumInterval = settings.checksumInterval;
+		recorder = std::make_unique<Replay::Recorder>(settings.recordPath, header);
+	}
+
+	gameResult_t result;
+	result.seed = seed;
+
+	for (; result.ticks < settings.tickLimit; result.ticks++)
+	{
+		if (GameState::GetState(registry) != gameState_t::PLAY)
+			break;
+
+		const playerInput_t playerInput = input->GetInput(registry, result.ticks);
+		if (recorder)
+			recorder->Record(context.tick, playerInput);
+
+		ApplyPlayerInput(registry, playerInput);
+		Game::Tick(registry);
+
+		if (settings.checksumInterval > 0 && context.tick % settings.checksumInterval == 0)
+		{
+			result.checksums.push_back(context.checksum);
+			if (recorder)
+				recorder->RecordChecksum(context.tick, context.checksum);
+		}
+	}
+
+	if (recorder)
+		recorder->Finish(context.tick);
+
+	result.pieces = context.piecesDealt;
+	result.score = context.gameScore;
+	result.lines = context.linesClearedTotal;
+	result.level = context.gameLevel;
+	result.toppedOut = GameState::GetState(registry) == gameState_t::GAME_OVER;
+	result.checksum = context.checksum;
+	result.systemSeconds = context.systemSeconds;
+
+	if (const auto* bot = dynamic_cast<const BotInput*>(input.get()))
+	{
+		result.botPlans = bot->GetPlanCount();
+		result.botPlanSeconds = bot->GetPlanSeconds();
+	}
+
+	return result;
+}
+
+struct searchPosition_t
+{
+	Bot::rows_t blocks;
+	moveDirection_t orientation;
+	Bot::piece_t piece;
+	std::vector<tetrominoType_t> preview;
+	Bot::bagState_t bag;
+};
+
+std::vector<searchBenchmarkResult_t> RunSearchBenchmark(const simulationSettings_t& settings, const uint32_t& seed, const unsigned int& positionCount, const std::vector<unsigned int>& threadCounts)
+{
+	const Bot::expectimaxSettings_t searchSettings = GetSearchSettings(settings);
+
+	entt::registry registry;
+	StartGame(registry, settings, seed);
+
+	// The plain bot plays, so positions come quickly and look like real play.
+	BotInput input(Bot::weights_t(), nullptr, settings.inputInterval);
+	const Bot::field_t field = Bot::ReadField(registry);
+
+	std::vector<searchPosition_t> positions;
+	unsigned int pieceNumber = 0;
+	for (unsigned int tick = 0; tick < settings.tickLimit && positions.size() < positionCount; tick++)
+	{
+		if (GameState::GetState(registry) != gameState_t::PLAY)
+			break;
+
+		searchPosition_t position;
+		const unsigned int piecesDealt = GetGameContext(registry).piecesDealt;
+		if (piecesDealt != pieceNumber && Bot::ReadActivePiece(registry, position.piece))
+		{
+			pieceNumber = piecesDealt;
+
+			const Bot::Board board = Bot::ReadBoard(registry, field);
+			position.blocks = board.GetBlockRows();
+			position.orientation = board.GetOrientation();
+			Bot::ReadUpcoming(registry, searchSettings.previewShown, position.preview, position.bag);
+			positions.push_back(position);
+		}
+
+		ApplyPlayerInput(registry, input.GetInput(registry, tick));
+		Game::Tick(registry);
+	}
+
+	std::vector<searchBenchmarkResult_t> results;
+	for (const auto& threadCount : threadCounts)
+	{
+		ThreadPool pool(threadCount);
+		Bot::Expectimax search(Bot::weights_t(), searchSettings);
+
+		searchBenchmarkResult_t result;
+		result.threadCount = pool.GetThreadCount();
+
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& position : positions)
+		{
+			Bot::piece_t target;
+			search.Choose(Bot::Board(field, position.blocks, position.orientation), position.piece, position.preview, position.bag, &pool, target);
+			result.searches++;
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const Bot::searchStats_t stats = search.GetStats();
+		result.nodes = stats.nodes;
+		result.tableHits = stats.tableHits;
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+replayResult_t RunReplay(const std::string& path, const unsigned int& keyframeInterval, const uint64_t& seekTick)
+{
+	Replay::Player player(Replay::Load(path), keyframeInterval);
+	const Replay::recording_t& recording = player.GetRecording();
+
+	replayResult_t result;
+	result.seed = recording.header.seed;
+	result.inputs = recording.events.size();
+
+	auto start = std::chrono::steady_clock::now();
+	while (player.Step())
+	{
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const auto& context = GetGameContext(player.GetRegistry());
+	result.ticks = context.tick;
+	result.pieces = context.piecesDealt;
+	result.score = context.gameScore;
+	result.lines = context.linesClearedTotal;
+	result.toppedOut = GameState::GetState(player.GetRegistry()) == gameState_t::GAME_OVER;
+	result.keyframes = player.GetKeyframeCount();
+
+	const Replay::verification_t& verification = player.GetVerification();
+	result.checksumsChecked = verification.checked;
+	result.diverged = verification.diverged;
+	result.lastMatchedTick = verification.lastMatchedTick;
+	result.divergedTick = verification.divergedTick;
+
+	result.seekTick = seekTick > 0 ? seekTick : result.ticks / 2;
+	start = std::chrono::steady_clock::now();
+	player.Seek(result.seekTick);
+	result.seekSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return result;
+}
\ No newline at end of file
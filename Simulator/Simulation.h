@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Globals.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class inputSourceType_t
+{
+	SCRIPTED,
+	RANDOM,
+	BOT
+};
+
+struct simulationSettings_t
+{
+	unsigned int tickLimit = 60 * 60 * 5; // Most ticks a game runs for. Five minutes of play at the default tick length.
+	double tickLength = 1.0 / 60.0; // Seconds of game time per tick.
+	randomizerType_t pieceRandomizer = randomizerType_t::SEVEN_BAG;
+	inputSourceType_t inputSource = inputSourceType_t::SCRIPTED;
+	unsigned int inputInterval = 6; // Ticks between inputs.
+	unsigned int searchDepth = 0; // Pieces the bot's expectimax search places down each line. 0 for the plain search over the current and next piece.
+	bool profileSystems = true;
+	std::string recordPath; // Where to record the game's inputs to, if anywhere. Only for runs of a single game.
+	unsigned int checksumInterval = 60; // Ticks between the checksums kept of each game, and recorded with its inputs. 0 for none.
+};
+
+struct gameResult_t
+{
+	uint32_t seed = 0;
+	unsigned int ticks = 0;
+	unsigned int pieces = 0;
+	int score = 0;
+	int lines = 0;
+	int level = 0;
+	bool toppedOut = false;
+	uint64_t checksum = 0; // The game's checksum once it ended.
+	std::vector<uint64_t> checksums; // Once every checksumInterval ticks.
+	unsigned int botPlans = 0; // Placements the bot chose. Zero for other inputs.
+	double botPlanSeconds = 0.0;
+	std::array<double, static_cast<size_t>(gameSystem_t::COUNT)> systemSeconds = {};
+};
+
+struct searchBenchmarkResult_t
+{
+	unsigned int threadCount = 0;
+	unsigned int searches = 0;
+	uint64_t nodes = 0;
+	uint64_t tableHits = 0;
+	double seconds = 0.0;
+};
+
+struct replayResult_t
+{
+	uint32_t seed = 0;
+	uint64_t ticks = 0;
+	size_t inputs = 0;
+	unsigned int pieces = 0;
+	int score = 0;
+	int lines = 0;
+	bool toppedOut = false;
+	size_t keyframes = 0;
+	double seconds = 0.0; // Playing the whole recording through.
+	uint64_t seekTick = 0;
+	double seekSeconds = 0.0; // Going back to seekTick from the end.
+	size_t checksumsChecked = 0;
+	bool diverged = false;
+	uint64_t lastMatchedTick = 0;
+	uint64_t divergedTick = 0; // The first checksum that didn't match the recording.
+};
+
+// Plays one game on its own registry until it tops out or reaches the tick limit. The seed decides both the pieces and any random input.
+gameResult_t RunGame(const simulationSettings_t& settings, const uint32_t& seed);
+
+// Plays a game with the bot to collect up to positionCount positions, then runs the expectimax search on every one of them once per thread count.
+// Each thread count starts from an empty table, so the counts are comparable.
+std::vector<searchBenchmarkResult_t> RunSearchBenchmark(const simulationSettings_t& settings, const uint32_t& seed, const unsigned int& positionCount, const std::vector<unsigned int>& threadCounts);
+
+// Plays a recorded game through from start to end, checking it against the checksums recorded, then seeks back to seekTick, or halfway with 0, timing both.
+replayResult_t RunReplay(const std::string& path, const unsigned int& keyframeInterval, const uint64_t& seekTick);
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "Simulation.h"
+
+#include "Game.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*
+* Runs many games at once with no window, sound or keyboard, and reports how fast they ran and how they scored.
+* For tuning the game's numbers, and for measuring engine changes at scale.
+*/
+
+struct runnerSettings_t
+{
+	unsigned int gameCount = 1000;
+	unsigned int threadCount = 0; // One per hardware thread.
+	uint32_t firstSeed = 1; // Game i is played with seed firstSeed + i.
+	unsigned int benchPositions = 0; // Positions to time the bot's search on instead of playing games. 0 plays games.
+	std::string replayPath; // A recording to play back instead of playing games.
+	unsigned int keyframeInterval = 600;
+	unsigned int seekTick = 0; // 0 for halfway through the recording.
+	bool verify = false; // Play every game again serially afterwards, and check it went exactly the same.
+	simulationSettings_t simulation;
+};
+
+static void PrintUsage()
+{
+	cout << "Usage: Simulator [options]" << endl;
+	cout << "  --games N          Games to play (default 1000)" << endl;
+	cout << "  --ticks N          Most ticks per game (default 18000)" << endl;
+	cout << "  --threads N        Worker threads, 0 for one per hardware thread (default 0)" << endl;
+	cout << "  --seed N           Seed of the first game (default 1)" << endl;
+	cout << "  --input NAME       scripted, random or bot (default scripted)" << endl;
+	cout << "  --interval N       Ticks between inputs (default 6)" << endl;
+	cout << "  --depth N          Pieces the bot's expectimax search looks at, 0 for its plain search (default 0)" << endl;
+	cout << "  --bench-search N   Time the expectimax search on N positions at each thread count up to --threads" << endl;
+	cout << "  --record FILE      Record the game's inputs to FILE. Needs --games 1" << endl;
+	cout << "  --replay FILE      Play the recording in FILE back as fast as it'll go, then seek back into it" << endl;
+	cout << "  --keyframes N      Ticks between the copies of the game kept for seeking (default 600)" << endl;
+	cout << "  --seek N           Tick to seek back to once the recording's played, 0 for halfway (default 0)" << endl;
+	cout << "  --checksums N      Ticks between the checksums kept of each game and recorded, 0 for none (default 60)" << endl;
+	cout << "  --verify           Play every game again on one thread afterwards, and report any that went differently" << endl;
+	cout << "  --randomizer NAME  7bag, 14bag or tgm (default 7bag)" << endl;
+	cout << "  --no-profile       Don't time the individual systems" << endl;
+}
+
+static unsigned int ParseCount(const std::string& value)
+{
+	size_t used = 0;
+	const unsigned long parsed = std::stoul(value, &used);
+	if (used != value.size())
+		throw std::runtime_error("Not a number: " + value);
+	return static_cast<unsigned int>(parsed);
+}
+
+static runnerSettings_t ParseArguments(int argc, char** argv)
+{
+	runnerSettings_t settings;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--no-profile")
+		{
+			settings.simulation.profileSystems = false;
+			continue;
+		}
+
+		if (argument == "--verify")
+		{
+			settings.verify = true;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+			throw std::runtime_error("Missing value for " + argument);
+		const std::string value = argv[++i];
+
+		if (argument == "--games")
+			settings.gameCount = ParseCount(value);
+		else if (argument == "--ticks")
+			settings.simulation.tickLimit = ParseCount(value);
+		else if (argument == "--threads")
+			settings.threadCount = ParseCount(value);
+		else if (argument == "--seed")
+			settings.firstSeed = ParseCount(value);
+		else if (argument == "--interval")
+			settings.simulation.inputInterval = ParseCount(value);
+		else if (argument == "--depth")
+			settings.simulation.searchDepth = ParseCount(value);
+		else if (argument == "--bench-search")
+			settings.benchPositions = ParseCount(value);
+		else if (argument == "--record")
+			settings.simulation.recordPath = value;
+		else if (argument == "--replay")
+			settings.replayPath = value;
+		else if (argument == "--keyframes")
+			settings.keyframeInterval = ParseCount(value);
+		else if (argument == "--seek")
+			settings.seekTick = ParseCount(value);
+		else if (argument == "--checksums")
+			settings.simulation.checksumInterval = ParseCount(value);
+		else if (argument == "--input")
+		{
+			if (value == "scripted")
+				settings.simulation.inputSource = inputSourceType_t::SCRIPTED;
+			else if (value == "random")
+				settings.simulation.inputSource = inputSourceType_t::RANDOM;
+			else if (value == "bot")
+				settings.simulation.inputSource = inputSourceType_t::BOT;
+			else
+				throw std::runtime_error("Unknown input source: " + value);
+		}
+		else if (argument == "--randomizer")
+		{
+			if (value == "7bag")
+				settings.simulation.pieceRandomizer = randomizerType_t::SEVEN_BAG;
+			else if (value == "14bag")
+				settings.simulation.pieceRandomizer = randomizerType_t::FOURTEEN_BAG;
+			else if (value == "tgm")
+				settings.simulation.pieceRandomizer = randomizerType_t::TGM_HISTORY;
+			else
+				throw std::runtime_error("Unknown randomizer: " + value);
+		}
+		else
+			throw std::runtime_error("Unknown option: " + argument);
+	}
+
+	if (!settings.simulation.recordPath.empty() && settings.gameCount != 1)
+		throw std::runtime_error("--record only records a single game");
+
+	return settings;
+}
+
+// The value below which the given fraction of the sorted values fall.
+template<typename T>
+static T Percentile(const std::vector<T>& sorted, const double& fraction)
+{
+	const size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+static void PrintReport(const runnerSettings_t& settings, const unsigned int& threadCount, const std::vector<gameResult_t>& results, const double& wallSeconds)
+{
+	unsigned long long totalTicks = 0;
+	unsigned long long totalPieces = 0;
+	unsigned long long totalLines = 0;
+	unsigned int toppedOut = 0;
+	unsigned long long botPlans = 0;
+	double botPlanSeconds = 0.0;
+	std::array<double, static_cast<size_t>(gameSystem_t::COUNT)> systemSeconds = {};
+	std::vector<int> scores;
+	scores.reserve(results.size());
+
+	for (const auto& result : results)
+	{
+		totalTicks += result.ticks;
+		totalPieces += result.pieces;
+		totalLines += result.lines;
+		toppedOut += result.toppedOut ? 1 : 0;
+		botPlans += result.botPlans;
+		botPlanSeconds += result.botPlanSeconds;
+		scores.push_back(result.score);
+
+		for (size_t i = 0; i < systemSeconds.size(); i++)
+			systemSeconds[i] += result.systemSeconds[i];
+	}
+	std::sort(scores.begin(), scores.end());
+
+	const double gameCount = static_cast<double>(results.size());
+
+	cout << std::fixed << std::setprecision(1);
+	cout << "Games:      " << results.size() << " on " << threadCount << " threads, " << wallSeconds << " s" << endl;
+	cout << "Throughput: " << totalTicks / wallSeconds << " ticks/s, " << totalPieces / wallSeconds << " pieces/s, " << gameCount / wallSeconds << " games/s" << endl;
+	cout << "Per game:   " << totalTicks / gameCount << " ticks, " << totalPieces / gameCount << " pieces, " << totalLines / gameCount << " lines, " << 100.0 * toppedOut / gameCount << "% topped out" << endl;
+
+	const double meanScore = std::accumulate(scores.begin(), scores.end(), 0.0) / gameCount;
+	cout << "Score:      min " << scores.front() << ", p10 " << Percentile(scores, 0.1) << ", median " << Percentile(scores, 0.5)
+		<< ", p90 " << Percentile(scores, 0.9) << ", max " << scores.back() << ", mean " << meanScore << endl;
+
+	if (botPlans > 0)
+		cout << "Bot:        " << botPlans << " plans, " << 1e6 * botPlanSeconds / botPlans << " us/plan" << endl;
+
+	if (!settings.simulation.profileSystems)
+		return;
+
+	const double totalSystemSeconds = std::accumulate(systemSeconds.begin(), systemSeconds.end(), 0.0);
+	cout << "Systems:" << endl;
+	for (size_t i = 0; i < systemSeconds.size(); i++)
+	{
+		const double share = totalSystemSeconds > 0.0 ? 100.0 * systemSeconds[i] / totalSystemSeconds : 0.0;
+		const double nanosecondsPerTick = totalTicks > 0 ? 1e9 * systemSeconds[i] / totalTicks : 0.0;
+		cout << "  " << std::left << std::setw(14) << Game::GetNameOfSystem(static_cast<gameSystem_t>(i)) << std::right
+			<< std::setw(10) << nanosecondsPerTick << " ns/tick" << std::setw(8) << share << "%" << endl;
+	}
+}
+
+// Nodes are placements scored. Powers of two up to the most threads, and the most threads itself.
+static int RunSearchBench(const runnerSettings_t& settings)
+{
+	const unsigned int maxThreads = ThreadPool(settings.threadCount).GetThreadCount();
+	std::vector<unsigned int> threadCounts;
+	for (unsigned int threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	std::vector<searchBenchmarkResult_t> results;
+	try
+	{
+		results = RunSearchBenchmark(settings.simulation, settings.firstSeed, settings.benchPositions, threadCounts);
+	}
+	catch (const std::exception& ex)
+	{
+		cerr << "Benchmark failed: " << ex.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	if (results.front().searches == 0)
+	{
+		cerr << "Benchmark failed: the game ended before any positions came up" << endl;
+		return EXIT_FAILURE;
+	}
+
+	cout << std::fixed << std::setprecision(1);
+	cout << "Search:     depth " << (settings.simulation.searchDepth > 0 ? settings.simulation.searchDepth : 3) << ", " << results.front().searches << " positions" << endl;
+
+	const double baseRate = results.front().nodes / results.front().seconds;
+	for (const auto& result : results)
+	{
+		const double rate = result.nodes / result.seconds;
+		cout << "  " << std::setw(3) << result.threadCount << " threads" << std::setw(12) << rate << " nodes/s" << std::setw(8) << rate / baseRate << "x"
+			<< std::setw(10) << 1e3 * result.seconds / result.searches << " ms/search" << std::setw(10) << result.tableHits << " table hits" << endl;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+static int RunReplayPlayback(const runnerSettings_t& settings)
+{
+	replayResult_t result;
+	try
+	{
+		result = RunReplay(settings.replayPath, settings.keyframeInterval, settings.seekTick);
+	}
+	catch (const std::exception& ex)
+	{
+		cerr << "Replay failed: " << ex.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	cout << std::fixed << std::setprecision(1);
+	cout << "Replay:     seed " << result.seed << ", " << result.ticks << " ticks, " << result.inputs << " inputs, " << result.keyframes << " keyframes" << endl;
+	cout << "Result:     " << result.pieces << " pieces, " << result.lines << " lines, score " << result.score << (result.toppedOut ? ", topped out" : "") << endl;
+	cout << "Playback:   " << result.seconds << " s, " << result.ticks / result.seconds << " ticks/s" << endl;
+	cout << "Seek:       to tick " << result.seekTick << " in " << 1e3 * result.seekSeconds << " ms" << endl;
+
+	if (result.diverged)
+	{
+		cout << "Diverged:   by tick " << result.divergedTick << ", last matched at tick " << result.lastMatchedTick << endl;
+		return EXIT_FAILURE;
+	}
+
+	if (result.checksumsChecked == 0)
+		cout << "Checksums:  none recorded" << endl;
+	else
+		cout << "Checksums:  " << result.checksumsChecked << " checked, all matched" << endl;
+	return EXIT_SUCCESS;
+}
+
+// Plays every game again, one after another on this thread, and compares its checksums with the run on the pool.
+static bool VerifyResults(const runnerSettings_t& settings, const std::vector<gameResult_t>& results)
+{
+	const uint64_t interval = settings.simulation.checksumInterval;
+
+	unsigned int divergedCount = 0;
+	for (const auto& result : results)
+	{
+		const gameResult_t again = RunGame(settings.simulation, result.seed);
+		if (again.checksums == result.checksums && again.checksum == result.checksum && again.ticks == result.ticks)
+			continue;
+
+		divergedCount++;
+
+		size_t first = 0;
+		while (first < result.checksums.size() && first < again.checksums.size() && result.checksums[first] == again.checksums[first])
+			first++;
+
+		// Checksum i is taken once (i + 1) * interval ticks have run.
+		if (first < result.checksums.size() && first < again.checksums.size())
+			cout << "Diverged:   seed " << result.seed << " by tick " << (first + 1) * interval << ", last matched at tick " << first * interval << endl;
+		else
+			cout << "Diverged:   seed " << result.seed << " after tick " << first * interval << endl;
+	}
+
+	cout << "Verified:   " << results.size() - divergedCount << " of " << results.size() << " games played the same again serially" << endl;
+	return divergedCount == 0;
+}
+
+int main(int argc, char** argv)
+{
+	runnerSettings_t settings;
+	try
+	{
+		settings = ParseArguments(argc, argv);
+	}
+	catch (const std::exception& ex)
+	{
+		cerr << ex.what() << endl;
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	if (settings.benchPositions > 0)
+		return RunSearchBench(settings);
+
+	if (!settings.replayPath.empty())
+		return RunReplayPlayback(settings);
+
+	if (settings.gameCount == 0)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	ThreadPool pool(settings.threadCount);
+	std::vector<gameResult_t> results(settings.gameCount);
+
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		// Every game writes only its own result, so nothing is shared while they run.
+		pool.ParallelFor(settings.gameCount, [&](size_t i)
+			{
+				results[i] = RunGame(settings.simulation, settings.firstSeed + static_cast<uint32_t>(i));
+			});
+	}
+	catch (const std::exception& ex)
+	{
+		cerr << "Simulation failed: " << ex.what() << endl;
+		return EXIT_FAILURE;
+	}
+	const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	PrintReport(settings, pool.GetThreadCount(), results, wallSeconds);
+
+	if (settings.verify)
+	{
+		try
+		{
+			if (!VerifyResults(settings, results))
+				return EXIT_FAILURE;
+		}
+		catch (const std::exception& ex)
+		{
+			cerr << "Verification failed: " << ex.what() << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
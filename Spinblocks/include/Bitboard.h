@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+* Line kernels over per-row occupancy bitmasks, one 64 bit word per row (bit x is column x).
+* These back line detection and compaction for boards up to 64 cells wide, in any orientation.
+* The hot loops use AVX2 or SSE when the compiler targets them, with a scalar fallback otherwise.
+*/
+namespace Bitboard
+{
+	unsigned int PopCount(uint64_t bits);
+
+	// Index of the lowest and highest set bit. bits must not be zero.
+	unsigned int LowestBit(uint64_t bits);
+	unsigned int HighestBit(uint64_t bits);
+
+	// A mask of the given number of consecutive bits, starting at offset.
+	uint64_t SpanMask(const unsigned int& offset, const unsigned int& length);
+
+	// Bit i of the result is set when every bit of lineMask is set in rows[i]. rowCount may be at most 64.
+	uint64_t FindFullRows(const uint64_t* rows, const unsigned int& rowCount, const uint64_t& lineMask);
+
+	// The bits of columnMask that are set in every one of the given rows.
+	uint64_t FindFullColumns(const uint64_t* rows, const unsigned int& rowCount, const uint64_t& columnMask);
+
+	// Bit i of the result is set when rows[i] has exactly count bits set. rowCount may be at most 64.
+	uint64_t FindRowsWithCount(const uint64_t* rows, const unsigned int& rowCount, const unsigned int& count);
+
+	// Bit x of the result is set when exactly count of the given rows have bit x set.
+	uint64_t FindColumnsWithCount(const uint64_t* rows, const unsigned int& rowCount, const unsigned int& count);
+
+	// Removes the cleared rows (bit i of clearedRows for rows[i]), sliding the rest together towards row 0 or towards the last row.
+	// The rows vacated at the far end are zeroed. rowCount may be at most 64.
+	void CompactRows(uint64_t* rows, const unsigned int& rowCount, const uint64_t& clearedRows, const bool& towardsFirst);
+
+	// Removes the cleared columns from within spanMask of every row, sliding what's left together towards the low or high bits of the span.
+	// Bits outside spanMask are left alone.
+	uint64_t CompactColumnsOfRow(const uint64_t& row, const uint64_t& clearedColumns, const uint64_t& spanMask, const bool& towardsLow);
+	void CompactColumns(uint64_t* rows, const unsigned int& rowCount, const uint64_t& clearedColumns, const uint64_t& spanMask, const bool& towardsLow);
+}
\ No newline at end of file
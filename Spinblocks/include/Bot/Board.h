@@ -0,0 +1,127 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+#include "glm/vec2.hpp"
+
+#include "Globals.h"
+
+#include <array>
+#include <cstdint>
+
+/*
+* A copy of the matrix a bot can play on without touching the registry. One 64 bit word per row, as the container keeps it.
+* Moves, rotations, line clears and board rotations follow what MovePiece, RotatePiece and the systems do in Game::Tick,
+* so a placement found here plays out the same way in the game.
+*/
+namespace Bot
+{
+	inline constexpr unsigned int MaxRows = 64;
+	inline constexpr unsigned int OrientationCount = 4;
+	inline constexpr unsigned int TypeCount = 7;
+
+	using rows_t = std::array<uint64_t, MaxRows>;
+
+	// What stays put through a game: the matrix's cells, its walls in every play area orientation, and where each piece spawns.
+	struct field_t
+	{
+		glm::ivec2 dimensions{ 0, 0 };
+		glm::ivec2 playAreaLower{ 0, 0 }; // The play area is the cells the walls fence in, from lower up to but not including upper.
+		glm::ivec2 playAreaUpper{ 0, 0 };
+		rows_t cells{}; // Cells that exist. Anywhere else is as good as a wall.
+		std::array<rows_t, OrientationCount> walls{};
+		std::array<std::array<glm::ivec2, TypeCount>, OrientationCount> spawns{};
+		std::array<std::array<bool, TypeCount>, OrientationCount> hasSpawn{};
+	};
+
+	// A piece by its center coordinate, as a Tetromino entity's Coordinate holds it.
+	struct piece_t
+	{
+		tetrominoType_t type = tetrominoType_t::T;
+		moveDirection_t orientation = moveDirection_t::NORTH;
+		glm::ivec2 position{ 0, 0 };
+
+		bool operator==(const piece_t& other) const
+		{
+			return type == other.type && orientation == other.orientation && position == other.position;
+		}
+
+		bool operator!=(const piece_t& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	struct placeResult_t
+	{
+		int linesCleared = 0;
+		rotationDirection_t boardRotation = rotationDirection_t::NONE;
+	};
+
+	class Board
+	{
+	private:
+		const field_t* m_field;
+		rows_t m_blocks{};
+		moveDirection_t m_orientation;
+		uint64_t m_hash; // Zobrist hash of the blocks and orientation.
+
+		bool IsFree(const glm::ivec2& cell) const;
+		uint64_t ComputeHash() const;
+		int ClearLines();
+		void Collapse();
+
+	public:
+		Board(const field_t& field, const rows_t& blocks, const moveDirection_t& orientation);
+
+		const field_t& GetField() const
+		{
+			return *m_field;
+		}
+
+		const rows_t& GetBlockRows() const
+		{
+			return m_blocks;
+		}
+
+		// The play area's orientation, which decides which way is down.
+		const moveDirection_t& GetOrientation() const
+		{
+			return m_orientation;
+		}
+
+		// Kept up to date as pieces are placed. Boards with the same blocks and orientation hash the same however they got there.
+		uint64_t GetHash() const
+		{
+			return m_hash;
+		}
+
+		bool IsBlockSet(const glm::ivec2& cell) const;
+
+		static std::array<glm::ivec2, 4> GetCells(const piece_t& piece);
+
+		bool Fits(const piece_t& piece) const;
+
+		// One step along the given direction, if the piece fits there.
+		bool Shift(const piece_t& piece, const moveDirection_t& direction, piece_t& moved) const;
+
+		// Turns the piece about its center, if RotatePiece would let it.
+		bool Rotate(const piece_t& piece, const rotationDirection_t& rotation, piece_t& rotated) const;
+
+		// Where the piece comes to rest falling straight down from here.
+		piece_t Drop(const piece_t& piece) const;
+
+		// Locks the piece where it is, clears any lines, and rotates the board if the clear was big enough.
+		placeResult_t Place(const piece_t& piece);
+
+		// The piece as it would come into the matrix right now. False when there's no spawn marker for it.
+		bool GetSpawn(const tetrominoType_t& type, piece_t& piece) const;
+	};
+
+	field_t ReadField(entt::registry& registry);
+
+	// The settled blocks and play area orientation as they stand. The field has to outlive the board.
+	Board ReadBoard(entt::registry& registry, const field_t& field);
+
+	// The controllable piece, if there is one in the matrix.
+	bool ReadActivePiece(entt::registry& registry, piece_t& piece);
+}
\ No newline at end of file
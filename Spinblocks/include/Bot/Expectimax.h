@@ -0,0 +1,85 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+#include "Bot/Board.h"
+#include "Bot/PlacementSearch.h"
+#include "Bot/TranspositionTable.h"
+#include "Globals.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/*
+* Looks several pieces ahead. The pieces on show are placed as they come, and past those every piece the bag could deal next
+* is tried in turn, with the results averaged by how likely each one is. Positions reached more than one way are only searched once,
+* by way of a transposition table keyed on a Zobrist hash of the board, the pieces to come, the bag and the play area's orientation.
+*/
+namespace Bot
+{
+	// What's left in the bag after the pieces on show. With no copies, nothing's known and every type is as likely as any other.
+	struct bagState_t
+	{
+		std::array<uint8_t, TypeCount> remaining{};
+		uint8_t copies = 0; // Of each type in a full bag.
+	};
+
+	struct expectimaxSettings_t
+	{
+		unsigned int depth = 3; // Pieces placed down any line of the search, counting the current one.
+		unsigned int previewShown = 1; // Preview pieces the search is told about. Anything past them is left to chance.
+		size_t width = 6; // Best candidates looked at further at each piece. The rest are only scored as they land.
+		unsigned int tableSizeLog2 = 18;
+	};
+
+	struct searchStats_t
+	{
+		uint64_t nodes = 0; // Placements scored.
+		uint64_t tableHits = 0;
+	};
+
+	class Expectimax
+	{
+	private:
+		weights_t m_weights;
+		expectimaxSettings_t m_settings;
+		TranspositionTable m_table;
+		std::atomic<uint64_t> m_nodes{ 0 };
+		std::atomic<uint64_t> m_tableHits{ 0 };
+
+		double ScorePosition(const Board& board, const std::vector<tetrominoType_t>& queue, const size_t& next, const bagState_t& bag, const unsigned int& depth, ThreadPool* pool);
+		double ScorePiece(const Board& board, const tetrominoType_t& type, const std::vector<tetrominoType_t>& queue, const size_t& next, const bagState_t& bag, const unsigned int& depth, ThreadPool* pool);
+
+	public:
+		Expectimax(const weights_t& weights = weights_t(), const expectimaxSettings_t& settings = expectimaxSettings_t());
+
+		const expectimaxSettings_t& GetSettings() const
+		{
+			return m_settings;
+		}
+
+		// Picks where the current piece goes. The table carries over from one call to the next, since its keys cover everything a result depends on.
+		// Work is split across the pool when there is one, and the choice doesn't depend on how many threads did it.
+		bool Choose(const Board& board, const piece_t& current, const std::vector<tetrominoType_t>& preview, const bagState_t& bag, ThreadPool* pool, piece_t& target);
+
+		// Totals over every search so far.
+		searchStats_t GetStats() const;
+
+		void ResetStats();
+
+		void ClearTable()
+		{
+			m_table.Clear();
+		}
+	};
+
+	// The bag as it stands, put back to how it was before the hidden preview pieces were dealt from it.
+	bagState_t RewindBag(const bagState_t& bag, const std::vector<tetrominoType_t>& hidden);
+
+	// The first shown pieces of the preview, and what the bag could deal after them.
+	void ReadUpcoming(entt::registry& registry, const unsigned int& shown, std::vector<tetrominoType_t>& preview, bagState_t& bag);
+}
\ No newline at end of file
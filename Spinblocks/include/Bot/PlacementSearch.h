@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Bot/Board.h"
+#include "Globals.h"
+
+#include <vector>
+
+class ThreadPool;
+
+/*
+* Finds everywhere a piece can end up and scores each one, to pick where it goes.
+* Reachability follows the inputs a player has: left and right, a turn either way, and soft drop, all relative to the play area's orientation.
+*/
+namespace Bot
+{
+	// How much each feature of a board counts for. Higher scores are better, so anything unwanted is weighted below zero.
+	struct weights_t
+	{
+		double lines = 0.76;
+		double holes = -0.36;
+		double bumpiness = -0.18;
+		double aggregateHeight = -0.51;
+		double maxHeight = -0.1;
+		double boardRotation = -0.5; // A rotation turns the whole stack on its side, which is rarely worth it.
+		double topOut = -1000.0;
+	};
+
+	// The shape of a board, measured along the play area's gravity.
+	struct boardFeatures_t
+	{
+		int holes = 0;
+		int bumpiness = 0;
+		int aggregateHeight = 0;
+		int maxHeight = 0;
+	};
+
+	// Every distinct place the piece can come to rest, as reached from where it is now. Pieces that land on the same cells only appear once.
+	std::vector<piece_t> FindPlacements(const Board& board, const piece_t& piece);
+
+	boardFeatures_t MeasureBoard(const Board& board);
+
+	// What placing the piece did, on top of the board it left.
+	double ScoreResult(const placeResult_t& result, const weights_t& weights);
+
+	double ScoreBoard(const Board& board, const weights_t& weights);
+
+	// ScoreResult and ScoreBoard together.
+	double Evaluate(const Board& board, const placeResult_t& result, const weights_t& weights);
+
+	// Picks where the current piece goes. The best candidates on their own are looked at again with the first piece of the preview, if one's given.
+	// Candidates are scored across the pool when there is one, and the choice doesn't depend on how many threads did it.
+	bool ChoosePlacement(const Board& board, const piece_t& current, const std::vector<tetrominoType_t>& preview, const weights_t& weights, ThreadPool* pool, piece_t& target);
+
+	// The inputs that take a piece to where it drops onto a target, and the piece after each of them.
+	struct path_t
+	{
+		std::vector<piece_t> pieces; // Starts with where the piece is, and ends lined up over the target.
+		std::vector<playerInput_t> moves; // moves[i] takes pieces[i] to pieces[i + 1].
+	};
+
+	// The shortest path from the current piece to the target. False if the target can't be reached from here.
+	bool FindPath(const Board& board, const piece_t& current, const piece_t& target, path_t& path);
+
+	// The next input that takes the piece towards the target, along the shortest path there.
+	// HARD_DROP once it's lined up, and NONE if the target can't be reached from here anymore.
+	playerInput_t NextInput(const Board& board, const piece_t& current, const piece_t& target);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+/*
+* Search results by position hash, shared by every thread searching without any locks.
+* Each slot holds the value and the key XOR the value, written separately. A reader only takes the value if the two still
+* XOR back to its key, so a slot torn by two threads writing it at once reads as a miss instead of someone else's result.
+* Slots are picked by the low bits of the key and always overwritten, so the table never grows.
+*/
+namespace Bot
+{
+	class TranspositionTable
+	{
+	private:
+		struct entry_t
+		{
+			std::atomic<uint64_t> check{ 0 }; // The key XOR data.
+			std::atomic<uint64_t> data{ 0 };
+		};
+
+		std::unique_ptr<entry_t[]> m_entries;
+		uint64_t m_mask;
+
+		static uint64_t ToBits(const double& value)
+		{
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		static double FromBits(const uint64_t& bits)
+		{
+			double value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+	public:
+		// Holds 2^sizeLog2 results.
+		explicit TranspositionTable(const unsigned int& sizeLog2) : m_mask((uint64_t(1) << sizeLog2) - 1)
+		{
+			if (sizeLog2 == 0 || sizeLog2 > 30)
+				throw std::runtime_error("Unsupported transposition table size!");
+
+			m_entries = std::make_unique<entry_t[]>(static_cast<size_t>(m_mask + 1));
+		}
+
+		size_t GetSize() const
+		{
+			return static_cast<size_t>(m_mask + 1);
+		}
+
+		// An empty slot reads as the key 0, which a random key is no more likely to be than to collide with any other.
+		bool Probe(const uint64_t& key, double& value) const
+		{
+			const entry_t& entry = m_entries[key & m_mask];
+			const uint64_t data = entry.data.load(std::memory_order_relaxed);
+			const uint64_t check = entry.check.load(std::memory_order_relaxed);
+			if ((check ^ data) != key)
+				return false;
+
+			value = FromBits(data);
+			return true;
+		}
+
+		void Store(const uint64_t& key, const double& value)
+		{
+			entry_t& entry = m_entries[key & m_mask];
+			const uint64_t data = ToBits(value);
+			entry.check.store(key ^ data, std::memory_order_relaxed);
+			entry.data.store(data, std::memory_order_relaxed);
+		}
+
+		// Not safe while a search is using the table.
+		void Clear()
+		{
+			for (size_t i = 0; i < GetSize(); i++)
+			{
+				m_entries[i].check.store(0, std::memory_order_relaxed);
+				m_entries[i].data.store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+}
\ No newline at end of file
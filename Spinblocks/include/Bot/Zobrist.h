@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Bot/Board.h"
+#include "Randomizer.h"
+
+#include <array>
+#include <cstdint>
+
+/*
+* Random keys for hashing search positions. A position's hash is the XOR of the keys for everything in it,
+* so placing a block or turning the play area updates the hash with an XOR or two rather than a pass over the whole matrix.
+* The keys come from a fixed seed, so hashes are the same in every run and on every platform.
+*/
+namespace Bot
+{
+	// Deepest search, in pieces, the keys cover.
+	inline constexpr unsigned int ZobristMaxDepth = 16;
+
+	struct zobristKeys_t
+	{
+		std::array<std::array<uint64_t, 64>, MaxRows> cells{}; // [y][x] for a block there.
+		std::array<uint64_t, OrientationCount> orientations{}; // The play area's orientation.
+		std::array<std::array<uint64_t, TypeCount>, ZobristMaxDepth> queue{}; // [place in the queue][type] for the pieces still to come.
+		std::array<std::array<uint64_t, Randomizers::BagRandomizer::MaximumCopies + 1>, TypeCount> bag{}; // [type][how many are left in the bag]
+		std::array<uint64_t, ZobristMaxDepth + 1> depths{}; // How many pieces deep a result was searched.
+	};
+
+	const zobristKeys_t& GetZobristKeys();
+}
\ No newline at end of file
@@ -4,7 +4,6 @@
 #include <string>
 #include <unordered_map>
 #include <stdexcept>
-#include "Components/Includes.h"
 
 class CachedTagLookup
 {
@@ -22,6 +21,4 @@ public:
 	{
 		m_lookupTable.clear();
 	}
-};
-
-extern CachedTagLookup cachedTagLookup;
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+#include <cstdint>
+
+/*
+* A hash of everything that decides how a game plays on: the settled blocks, the piece in play, the bag and the preview,
+* the score and level, the fall and lock timers, and which way the play area faces. Game::Tick works it out at the end of every tick,
+* so two runs of the same game can be compared tick by tick. The settled blocks are the bulk of it, and the matrix keeps their part
+* up to date itself as blocks come and go, leaving only a fixed handful of values to fold in each tick.
+*/
+namespace Checksum
+{
+	// SplitMix64's finaliser. Any change to the input flips about half the bits of the output, and it's the same on every platform.
+	inline uint64_t Mix(uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+
+	// Folds value into hash. A multiply by an odd constant can't lose bits, so changing any one value always changes the result,
+	// and it's a fraction of the cost of a full Mix. Anything built this way wants a Mix at the end to spread the bits out.
+	inline uint64_t Combine(const uint64_t& hash, const uint64_t& value)
+	{
+		return (hash ^ value) * 0x9E3779B97F4A7C15ull;
+	}
+
+	// XORed in and out of a hash as a block comes and goes from the cell, so the hash doesn't depend on the order blocks were placed in.
+	inline uint64_t GetCellKey(const unsigned int& x, const unsigned int& y)
+	{
+		return Mix(((static_cast<uint64_t>(y) << 32) | x) + 0x9E3779B97F4A7C15ull);
+	}
+
+	uint64_t ComputeChecksum(entt::registry& registry);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Components/Component.h"
+
+namespace Components
+{
+	// Marks an entity that still has movement to work through. Settled and parked entities drop it, so the per-tick systems only visit what's in motion.
+	class Awake : public Component
+	{
+	public:
+		Awake() : Component()
+		{
+		}
+	};
+}
\ No newline at end of file
@@ -1,49 +1,85 @@
 #pragma once
 
 #include "Components/Component.h"
+#include "Checksum.h"
+#include "Randomizer.h"
 
-#include <deque>
-#include <random>
+#include <array>
+#include <cstdint>
+#include <memory>
 
 namespace Components
 {
+	// Where new pieces come from. The sequence itself is dealt by whichever randomizer the bag was made with.
 	class Bag : public Component
 	{
 	private:
-		std::deque<tetrominoType_t> m_tetrominos;
-		std::mt19937 m_pseudorandom;
+		std::unique_ptr<Randomizers::Randomizer> m_randomizer;
+		uint32_t m_seed; // What the sequence was last started from, so the game can be dealt again.
+		uint64_t m_dealtHash; // The seed and every piece dealt since, which between them pin down where the sequence has got to.
 
 	public:
-		Bag() : m_pseudorandom((std::random_device())())
+		Bag(const randomizerType_t& randomizerType = randomizerType_t::SEVEN_BAG) : Bag(randomizerType, Randomizers::GenerateSeed())
 		{
 		}
 
+		Bag(const randomizerType_t& randomizerType, const uint32_t& seed) : m_randomizer(Randomizers::CreateRandomizer(randomizerType, seed)), m_seed(seed), m_dealtHash(Checksum::Combine(0, seed))
+		{
+		}
+
+		// A copy deals the same pieces from here on as the original.
+		Bag(const Bag& other) : Component(other), m_randomizer(other.m_randomizer->Clone()), m_seed(other.m_seed), m_dealtHash(other.m_dealtHash)
+		{
+		}
+
+		Bag& operator=(const Bag& other)
+		{
+			Component::operator=(other);
+			m_randomizer = other.m_randomizer->Clone();
+			m_seed = other.m_seed;
+			m_dealtHash = other.m_dealtHash;
+			return *this;
+		}
+
+		Bag(Bag&&) = default;
+		Bag& operator=(Bag&&) = default;
+
 		tetrominoType_t PopTetromino()
 		{
-			if (m_tetrominos.empty())
-				FillBag();
+			const tetrominoType_t tetromino = m_randomizer->Next();
+			m_dealtHash = Checksum::Combine(m_dealtHash, static_cast<uint64_t>(tetromino));
+			return tetromino;
+		}
 
-			tetrominoType_t poppedTet = m_tetrominos.front();
-			m_tetrominos.pop_front();
-			return poppedTet;
+		// The next count pieces, written into tetrominos.
+		void PopTetrominos(tetrominoType_t* tetrominos, const size_t& count)
+		{
+			m_randomizer->Generate(tetrominos, count);
+			for (size_t i = 0; i < count; i++)
+				m_dealtHash = Checksum::Combine(m_dealtHash, static_cast<uint64_t>(tetrominos[i]));
 		}
 
-	private:
-		void FillBag()
-		{
-			if (m_tetrominos.empty())
-			{
-				// One of each Tetromino type.
-				m_tetrominos.push_back(tetrominoType_t::I);
-				m_tetrominos.push_back(tetrominoType_t::J);
-				m_tetrominos.push_back(tetrominoType_t::L);
-				m_tetrominos.push_back(tetrominoType_t::O);
-				m_tetrominos.push_back(tetrominoType_t::S);
-				m_tetrominos.push_back(tetrominoType_t::T);
-				m_tetrominos.push_back(tetrominoType_t::Z);
-
-				std::shuffle(m_tetrominos.begin(), m_tetrominos.end(), m_pseudorandom);
-			}
+		// What's left in the bag being dealt from, after the pieces already sent to the preview. False if the randomizer doesn't use a bag.
+		bool GetBagContents(std::array<unsigned int, 7>& remaining, unsigned int& copies) const
+		{
+			return m_randomizer->GetBagContents(remaining, copies);
+		}
+
+		void Seed(const uint32_t& seed)
+		{
+			m_randomizer->Seed(seed);
+			m_seed = seed;
+			m_dealtHash = Checksum::Combine(0, seed);
+		}
+
+		const uint32_t& GetSeed() const
+		{
+			return m_seed;
+		}
+
+		uint64_t GetDealtHash() const
+		{
+			return m_dealtHash;
 		}
 	};
 }
\ No newline at end of file
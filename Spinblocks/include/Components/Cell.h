@@ -13,6 +13,12 @@ namespace Components
 		entt::entity m_south { entt::null };
 		entt::entity m_west { entt::null };
 		entt::entity m_east { entt::null };
+
+		// Portals into a cell of another container, for the edges where there's no neighbour. Resolved by LinkCoordinates().
+		entt::entity m_northLink { entt::null };
+		entt::entity m_southLink { entt::null };
+		entt::entity m_westLink { entt::null };
+		entt::entity m_eastLink { entt::null };
 		
 	public:
 		Cell(entt::entity parent) : m_parent(parent)
@@ -74,5 +80,44 @@ namespace Components
 				assert(false);
 			}
 		}
+	public:
+		void SetLink(const moveDirection_t& direction, entt::entity ent)
+		{
+			switch (direction)
+			{
+			case moveDirection_t::NORTH:
+				m_northLink = ent;
+				break;
+			case moveDirection_t::EAST:
+				m_eastLink = ent;
+				break;
+			case moveDirection_t::SOUTH:
+				m_southLink = ent;
+				break;
+			case moveDirection_t::WEST:
+				m_westLink = ent;
+				break;
+			default:
+				assert(false);
+			}
+		}
+
+		entt::entity GetLink(const moveDirection_t& direction) const
+		{
+			switch (direction)
+			{
+			case moveDirection_t::NORTH:
+				return m_northLink;
+			case moveDirection_t::EAST:
+				return m_eastLink;
+			case moveDirection_t::SOUTH:
+				return m_southLink;
+			case moveDirection_t::WEST:
+				return m_westLink;
+			default:
+				assert(false);
+			}
+			return entt::null;
+		}
 	};
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Components/Component.h"
+#include "Bitboard.h"
+#include "Checksum.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <entt/entity/registry.hpp>
 
 namespace Components
 {
@@ -9,6 +15,46 @@ namespace Components
 	private:
 		glm::uvec2 m_gridDimensions; // In grid coordinates, not screen position.
 		glm::vec2 m_cellDimensions; // In screen coordinates
+
+		// Dense (x, y) lookups, indexed as y * width + x. Cells are filled in by BuildGrid(), occupants track which obstructing block sits in each cell.
+		std::vector<entt::entity> m_cells;
+		std::vector<entt::entity> m_occupants;
+
+		// Per-row occupancy bitmasks, 64 cells to a word. Only settled blocks (not following a tetromino) and active walls are set here,
+		// so a piece never collides with itself. Row y starts at word y * m_wordsPerRow.
+		std::vector<uint64_t> m_blockRows;
+		std::vector<uint64_t> m_wallRows;
+		unsigned int m_wordsPerRow{ 0 };
+
+		// How many settled blocks are in each row and column. Kept in step with m_blockRows, so full lines can be found without visiting any blocks.
+		std::vector<unsigned int> m_rowFill;
+		std::vector<unsigned int> m_columnFill;
+
+		// The settled blocks' part of the game's checksum, the XOR of the cell keys of every set bit of m_blockRows.
+		uint64_t m_blockHash{ 0 };
+
+		size_t GetIndex(const glm::uvec2& coordinates) const
+		{
+			return static_cast<size_t>(coordinates.y) * m_gridDimensions.x + coordinates.x;
+		}
+
+		size_t GetWordIndex(const glm::uvec2& coordinates) const
+		{
+			return static_cast<size_t>(coordinates.y) * m_wordsPerRow + coordinates.x / 64;
+		}
+
+		static uint64_t GetBitMask(const glm::uvec2& coordinates)
+		{
+			return uint64_t(1) << (coordinates.x % 64);
+		}
+
+		static void SetBit(std::vector<uint64_t>& rows, const size_t& wordIndex, const uint64_t& mask, const bool& set)
+		{
+			if (set)
+				rows[wordIndex] |= mask;
+			else
+				rows[wordIndex] &= ~mask;
+		}
 	
 	public:
 		Container(const glm::uvec2& gridDimensions, const glm::vec2& cellDimensions) : m_gridDimensions(gridDimensions), m_cellDimensions(cellDimensions)
@@ -16,6 +62,228 @@ namespace Components
 
 		}
 
+		bool IsWithinBounds(const glm::uvec2& coordinates) const
+		{
+			return coordinates.x < m_gridDimensions.x && coordinates.y < m_gridDimensions.y;
+		}
+
+		// Sizes the lookup tables to the grid dimensions. Everything starts out null.
+		void ResetCellIndex()
+		{
+			const size_t size = static_cast<size_t>(m_gridDimensions.x) * m_gridDimensions.y;
+			m_cells.assign(size, entt::null);
+			m_occupants.assign(size, entt::null);
+
+			m_wordsPerRow = (m_gridDimensions.x + 63) / 64;
+			m_blockRows.assign(static_cast<size_t>(m_wordsPerRow) * m_gridDimensions.y, 0);
+			m_wallRows.assign(static_cast<size_t>(m_wordsPerRow) * m_gridDimensions.y, 0);
+
+			m_rowFill.assign(m_gridDimensions.y, 0);
+			m_columnFill.assign(m_gridDimensions.x, 0);
+			m_blockHash = 0;
+		}
+
+		void ClearCellIndex()
+		{
+			m_cells.clear();
+			m_occupants.clear();
+			m_blockRows.clear();
+			m_wallRows.clear();
+			m_wordsPerRow = 0;
+			m_rowFill.clear();
+			m_columnFill.clear();
+			m_blockHash = 0;
+		}
+
+		entt::entity GetCellAt(const glm::uvec2& coordinates) const
+		{
+			if (!IsWithinBounds(coordinates) || m_cells.empty())
+				return entt::null;
+
+			return m_cells[GetIndex(coordinates)];
+		}
+
+		void SetCellAt(const glm::uvec2& coordinates, const entt::entity& cellEnt)
+		{
+			if (!IsWithinBounds(coordinates))
+				return;
+
+			if (m_cells.empty())
+				ResetCellIndex();
+
+			m_cells[GetIndex(coordinates)] = cellEnt;
+		}
+
+		entt::entity GetOccupantAt(const glm::uvec2& coordinates) const
+		{
+			if (!IsWithinBounds(coordinates) || m_occupants.empty())
+				return entt::null;
+
+			return m_occupants[GetIndex(coordinates)];
+		}
+
+		void SetOccupantAt(const glm::uvec2& coordinates, const entt::entity& occupantEnt)
+		{
+			if (!IsWithinBounds(coordinates))
+				return;
+
+			if (m_occupants.empty())
+				ResetCellIndex();
+
+			m_occupants[GetIndex(coordinates)] = occupantEnt;
+		}
+
+		unsigned int GetWordsPerRow() const
+		{
+			return m_wordsPerRow;
+		}
+
+		void SetBlockBit(const glm::uvec2& coordinates, const bool& set)
+		{
+			if (!IsWithinBounds(coordinates))
+				return;
+
+			if (m_blockRows.empty())
+				ResetCellIndex();
+
+			const size_t wordIndex = GetWordIndex(coordinates);
+			const uint64_t mask = GetBitMask(coordinates);
+			if (((m_blockRows[wordIndex] & mask) != 0) == set)
+				return;
+
+			SetBit(m_blockRows, wordIndex, mask, set);
+			m_blockHash ^= Checksum::GetCellKey(coordinates.x, coordinates.y);
+
+			if (set)
+			{
+				m_rowFill[coordinates.y]++;
+				m_columnFill[coordinates.x]++;
+			}
+			else
+			{
+				m_rowFill[coordinates.y]--;
+				m_columnFill[coordinates.x]--;
+			}
+		}
+
+		void SetWallBit(const glm::uvec2& coordinates, const bool& set)
+		{
+			if (!IsWithinBounds(coordinates))
+				return;
+
+			if (m_wallRows.empty())
+				ResetCellIndex();
+
+			SetBit(m_wallRows, GetWordIndex(coordinates), GetBitMask(coordinates), set);
+		}
+
+		bool IsBlockBitSet(const glm::uvec2& coordinates) const
+		{
+			if (!IsWithinBounds(coordinates) || m_blockRows.empty())
+				return false;
+
+			return (m_blockRows[GetWordIndex(coordinates)] & GetBitMask(coordinates)) != 0;
+		}
+
+		bool IsWallBitSet(const glm::uvec2& coordinates) const
+		{
+			if (!IsWithinBounds(coordinates) || m_wallRows.empty())
+				return false;
+
+			return (m_wallRows[GetWordIndex(coordinates)] & GetBitMask(coordinates)) != 0;
+		}
+
+		// Removes whole cleared lines from the settled block bitmask in one go, closing the gaps towards the low or high end, and recounts the fills and the hash.
+		// Lines are rows when horizontal, columns otherwise. Only boards that fit a word per row and 64 lines can do this; returns false otherwise.
+		bool CompactBlockLines(const uint64_t& clearedLines, const bool& horizontal, const bool& towardsLow)
+		{
+			const unsigned int lineCount = horizontal ? m_gridDimensions.y : m_gridDimensions.x;
+			if (m_blockRows.empty() || m_wordsPerRow != 1 || lineCount > 64)
+				return false;
+
+			if (horizontal)
+				Bitboard::CompactRows(m_blockRows.data(), m_gridDimensions.y, clearedLines, towardsLow);
+			else
+				Bitboard::CompactColumns(m_blockRows.data(), m_gridDimensions.y, clearedLines, Bitboard::SpanMask(0, m_gridDimensions.x), towardsLow);
+
+			std::fill(m_columnFill.begin(), m_columnFill.end(), 0);
+			m_blockHash = 0;
+			for (unsigned int y = 0; y < m_gridDimensions.y; y++)
+			{
+				const uint64_t row = m_blockRows[y];
+				m_rowFill[y] = Bitboard::PopCount(row);
+
+				for (unsigned int x = 0; x < m_gridDimensions.x; x++)
+				{
+					if ((row >> x) & 1)
+					{
+						m_columnFill[x]++;
+						m_blockHash ^= Checksum::GetCellKey(x, y);
+					}
+				}
+			}
+
+			return true;
+		}
+
+		// The settled block bitmask, m_wordsPerRow words to a row. Null until the index has been built.
+		const uint64_t* GetBlockRowData() const
+		{
+			if (m_blockRows.empty())
+				return nullptr;
+
+			return m_blockRows.data();
+		}
+
+		uint64_t GetBlockHash() const
+		{
+			return m_blockHash;
+		}
+
+		unsigned int GetRowFill(const unsigned int& row) const
+		{
+			if (row >= m_rowFill.size())
+				return 0;
+
+			return m_rowFill[row];
+		}
+
+		unsigned int GetColumnFill(const unsigned int& column) const
+		{
+			if (column >= m_columnFill.size())
+				return 0;
+
+			return m_columnFill[column];
+		}
+
+		// The settled blocks along one word of a row.
+		uint64_t GetBlockWord(const unsigned int& row, const unsigned int& word) const
+		{
+			if (row >= m_gridDimensions.y || word >= m_wordsPerRow || m_blockRows.empty())
+				return 0;
+
+			return m_blockRows[static_cast<size_t>(row) * m_wordsPerRow + word];
+		}
+
+		// The active walls along one word of a row.
+		uint64_t GetWallWord(const unsigned int& row, const unsigned int& word) const
+		{
+			if (row >= m_gridDimensions.y || word >= m_wordsPerRow || m_wallRows.empty())
+				return 0;
+
+			return m_wallRows[static_cast<size_t>(row) * m_wordsPerRow + word];
+		}
+
+		// Everything that's in the way along one word of a row. Settled blocks and walls combined.
+		uint64_t GetObstructionWord(const unsigned int& row, const unsigned int& word) const
+		{
+			if (row >= m_gridDimensions.y || word >= m_wordsPerRow || m_blockRows.empty())
+				return 0;
+
+			const size_t wordIndex = static_cast<size_t>(row) * m_wordsPerRow + word;
+			return m_blockRows[wordIndex] | m_wallRows[wordIndex];
+		}
+
 		const glm::uvec2& GetGridDimensions() const
 		{
 			return m_gridDimensions;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Components/Component.h"
+
+namespace Components
+{
+	// One block of the ghost piece, showing where the active tetromino would land. Mirrors the active tetromino's block at this index.
+	class Ghost : public Component
+	{
+	private:
+		int m_blockIndex;
+
+	public:
+		Ghost(int blockIndex) : m_blockIndex(blockIndex)
+		{
+		}
+
+		const int& GetBlockIndex() const
+		{
+			return m_blockIndex;
+		}
+	};
+}
\ No newline at end of file
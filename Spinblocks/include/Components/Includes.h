@@ -16,6 +16,10 @@
 #include "Components/DerivePositionFromCoordinates.h"
 #include "Components/DerivePositionFromParent.h"
 #include "Components/Moveable.h"
+#include "Components/Awake.h"
+#include "Components/Locked.h"
+#include "Components/PooledBlock.h"
+#include "Components/Parked.h"
 #include "Components/Controllable.h"
 #include "Components/Block.h"
 #include "Components/Flag.h"
@@ -26,13 +30,6 @@
 #include "Components/Obstructs.h"
 
 #include "Components/Tetrominos/Tetromino.h"
-#include "Components/Tetrominos/OTetromino.h"
-#include "Components/Tetrominos/ITetromino.h"
-#include "Components/Tetrominos/TTetromino.h"
-#include "Components/Tetrominos/LTetromino.h"
-#include "Components/Tetrominos/JTetromino.h"
-#include "Components/Tetrominos/STetromino.h"
-#include "Components/Tetrominos/ZTetromino.h"
 
 #include "Components/Follower.h"
 #include "Components/Wall.h"
@@ -48,8 +45,10 @@
 #include "Components/Bag.h"
 #include "Components/QueueNode.h"
 #include "Components/NodeOrder.h"
+#include "Components/PreviewQueue.h"
 
 #include "Components/ProjectionOf.h"
+#include "Components/Ghost.h"
 
 #include "Components/UI/UIComponent.h"
 #include "Components/UI/UIPosition.h"
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Components/Component.h"
+
+namespace Components
+{
+	// A block that has settled into the stack. Only line clears and board rotations need to touch it until it's woken again.
+	class Locked : public Component
+	{
+	public:
+		Locked() : Component()
+		{
+		}
+	};
+}
\ No newline at end of file
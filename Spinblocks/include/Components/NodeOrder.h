@@ -34,6 +34,12 @@ namespace Components
 
 			return *m_nodeIterator++;
 		}
+
+		// Nodes in the order they were added. The first is fed from the bag, the last feeds the matrix.
+		const std::vector<entt::entity>& GetNodes() const
+		{
+			return m_nodes;
+		}
 	private:
 		void ResetNodeIterator()
 		{
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Components/Component.h"
+
+namespace Components
+{
+	// A pooled block waiting to be spawned again. It has been stripped down to its model, so no system sees it.
+	class Parked : public Component
+	{
+	public:
+		Parked() : Component()
+		{
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Globals.h"
+#include "Components/Component.h"
+
+namespace Components
+{
+	// A block entity that goes back to the block pool when it's cleared, rather than being destroyed. It keeps the model of its tetromino type for its whole life,
+	// so it's only ever reused for blocks of the same type.
+	class PooledBlock : public Component
+	{
+	private:
+		tetrominoType_t m_type;
+
+	public:
+		PooledBlock(const tetrominoType_t& type) : Component(), m_type(type)
+		{
+		}
+
+		const tetrominoType_t& GetType() const
+		{
+			return m_type;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Components/Component.h"
+#include "Globals.h"
+
+#include <entt/entity/registry.hpp>
+
+#include <array>
+#include <stdexcept>
+
+namespace Components
+{
+	// The upcoming piece types, held in a fixed ring so pushing and popping never moves anything.
+	// Each slot also holds the tetromino previewing its piece, which stays with the slot as the queue moves on, so an advance never has to spawn it again.
+	class PreviewQueue : public Component
+	{
+	public:
+		static constexpr unsigned int MinimumDepth = 1;
+		static constexpr unsigned int MaximumDepth = 20;
+
+	private:
+		std::array<tetrominoType_t, MaximumDepth> m_ring{};
+		std::array<entt::entity, MaximumDepth> m_pieces; // The tetromino previewing each slot's piece, null while the slot isn't on show.
+		unsigned int m_head{ 0 }; // Ring slot of the next piece.
+		unsigned int m_size{ 0 };
+		unsigned int m_depth{ MinimumDepth };
+		bool m_previewDirty{ true }; // Set whenever the front of the queue changes, so the preview nodes are only redrawn when there's something new to show.
+
+	public:
+		PreviewQueue(const unsigned int& depth)
+		{
+			m_pieces.fill(entt::null);
+			SetDepth(depth);
+		}
+
+		// Queued pieces past the new depth are dropped.
+		void SetDepth(const unsigned int& depth)
+		{
+			if (depth < MinimumDepth || depth > MaximumDepth)
+				throw std::runtime_error("Preview depth must be between 1 and 20!");
+
+			m_depth = depth;
+			if (m_size > m_depth)
+				m_size = m_depth;
+			m_previewDirty = true;
+		}
+
+		const unsigned int& GetDepth() const
+		{
+			return m_depth;
+		}
+
+		const unsigned int& GetSize() const
+		{
+			return m_size;
+		}
+
+		bool IsFull() const
+		{
+			return m_size >= m_depth;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_size == 0;
+		}
+
+		void Push(const tetrominoType_t& tetrominoType)
+		{
+			if (IsFull())
+				throw std::runtime_error("Preview queue is full!");
+
+			m_ring[(m_head + m_size) % MaximumDepth] = tetrominoType;
+			m_size++;
+			m_previewDirty = true;
+		}
+
+		tetrominoType_t Pop()
+		{
+			if (IsEmpty())
+				throw std::runtime_error("Preview queue is empty!");
+
+			const tetrominoType_t poppedTet = m_ring[m_head];
+			m_head = (m_head + 1) % MaximumDepth;
+			m_size--;
+			m_previewDirty = true;
+			return poppedTet;
+		}
+
+		// The piece the given number of places back from the front. 0 is the next piece.
+		const tetrominoType_t& Peek(const unsigned int& position) const
+		{
+			if (position >= m_size)
+				throw std::runtime_error("Preview position is past the end of the queue!");
+
+			return m_ring[GetSlot(position)];
+		}
+
+		// The ring slot holding the piece the given number of places back from the front.
+		unsigned int GetSlot(const unsigned int& position) const
+		{
+			return (m_head + position) % MaximumDepth;
+		}
+
+		// How many places back from the front the given ring slot is. Slots past the end of the queue come out at GetSize() or more.
+		unsigned int GetPosition(const unsigned int& slot) const
+		{
+			return (slot + MaximumDepth - m_head) % MaximumDepth;
+		}
+
+		const entt::entity& GetPiece(const unsigned int& slot) const
+		{
+			return m_pieces[slot % MaximumDepth];
+		}
+
+		void SetPiece(const unsigned int& slot, const entt::entity& piece)
+		{
+			m_pieces[slot % MaximumDepth] = piece;
+		}
+
+		const bool& IsPreviewDirty() const
+		{
+			return m_previewDirty;
+		}
+
+		void SetPreviewDirty(const bool& previewDirty)
+		{
+			m_previewDirty = previewDirty;
+		}
+	};
+}
\ No newline at end of file
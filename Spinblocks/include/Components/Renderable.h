@@ -1,7 +1,13 @@
 #pragma once
 
 #include "Components/Component.h"
+
+#ifndef HEADLESS
 #include <learnopengl/model.h>
+#endif
+
+#include <functional>
+#include <string>
 
 namespace Components
 {
@@ -18,30 +24,53 @@ namespace Components
 		RL_MAX
 	};
 
+	// Headless builds have no graphics, so the model is never loaded. Only the layer and the model's path are kept, for anything that orders by them.
 	class Renderable : public Component
 	{
 	public:
+#ifndef HEADLESS
 		Model m_model;
+#endif
 		renderLayer_t m_renderLayer;
+		std::string m_modelPath;
+		size_t m_modelKey; // Hash of m_modelPath, so draws can be grouped by model without comparing strings.
 
 	public:
-		Renderable(renderLayer_t renderLayer, Model model, bool enabled = true) : m_model(model), m_renderLayer(renderLayer), Component(enabled)
+		Renderable(renderLayer_t renderLayer, const std::string& modelPath, bool enabled = true) :
+#ifndef HEADLESS
+			m_model(modelPath),
+#endif
+			m_renderLayer(renderLayer), m_modelPath(modelPath), m_modelKey(std::hash<std::string>{}(modelPath)), Component(enabled)
 		{
 		}
 
+#ifndef HEADLESS
 		const Model& GetModel() const
 		{
 			return m_model;
 		}
+#endif
 
 		const renderLayer_t& GetLayer() const
 		{
 			return m_renderLayer;
 		}
 
+		const std::string& GetModelPath() const
+		{
+			return m_modelPath;
+		}
+
+		const size_t& GetModelKey() const
+		{
+			return m_modelKey;
+		}
+
+#ifndef HEADLESS
 		void Draw(Shader& shader)
 		{
 			m_model.Draw(shader);
 		}
+#endif
 	};
 }
\ No newline at end of file
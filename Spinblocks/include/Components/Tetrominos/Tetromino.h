@@ -6,31 +6,150 @@
 #include "Components/Obstructable.h"
 #include "Components/Moveable.h"
 #include "Components/Block.h"
-#include <string>
+#include <array>
 #include <vector>
-#include <map>
-#include <utility>
-#include <tuple>
+#include <stdexcept>
 #include "glm/vec2.hpp"
 
-enum class rotationDirection_t;
-enum class moveDirection_t;
-enum class tetrominoType_t;
-
 namespace Components
 {
+	// A cell of a Tetromino's defining pattern, or an offset between two of them.
+	struct patternCell_t
+	{
+		int x;
+		int y;
+	};
+
 	/*
-	Map's Key is in a Tuple:
-	Key0: rotationPointIndex (int)
-	Key1: currentOrientation (moveDirection_t)
-	Key2: rotationDirection (rotationDirection_t) Often NONE
-	Map's Value is a Pair:
-	Pair.first: blockPattern (vector<glm::vec2>)
-	Pair.second: Key Tuple. (Identical types and orders to those composing the Key.)
-	When retrieving this, if Pair.first is empty, query it again, using Pair.second as a key.
+	* Shape data for every Tetromino type, shared by all pieces rather than built per instance.
+	* Tables are indexed by the underlying values of tetrominoType_t, moveDirection_t and rotationDirection_t.
+	* Patterns are defined with the origin at the lower-left.
 	*/
-	typedef std::map<std::tuple<int, moveDirection_t, rotationDirection_t>, std::pair<std::vector<glm::vec2>, std::tuple<int, moveDirection_t, rotationDirection_t>>> blockPattern_t;
+	namespace TetrominoTables
+	{
+		inline constexpr int TypeCount = 7;
+		inline constexpr int OrientationCount = 4;
+		inline constexpr int RotationCount = 3;
+		inline constexpr int BlockCount = 4;
+		inline constexpr int RotationPointCount = 5;
+
+		inline constexpr patternCell_t Patterns[TypeCount][OrientationCount][BlockCount] =
+		{
+			{ // T
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 1, 2 } }, // NORTH
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 1, 0 } }, // SOUTH
+				{ { 1, 2 }, { 1, 1 }, { 1, 0 }, { 2, 1 } }, // EAST
+				{ { 1, 0 }, { 1, 1 }, { 1, 2 }, { 0, 1 } } // WEST
+			},
+			{ // J
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 2 } },
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 0 } },
+				{ { 1, 2 }, { 1, 1 }, { 1, 0 }, { 2, 2 } },
+				{ { 0, 0 }, { 1, 2 }, { 1, 1 }, { 1, 0 } }
+			},
+			{ // Z
+				{ { 0, 2 }, { 1, 2 }, { 1, 1 }, { 2, 1 } },
+				{ { 0, 1 }, { 1, 1 }, { 1, 0 }, { 2, 0 } },
+				{ { 1, 1 }, { 1, 0 }, { 2, 2 }, { 2, 1 } },
+				{ { 0, 1 }, { 0, 0 }, { 1, 2 }, { 1, 1 } }
+			},
+			{ // O
+				{ { 1, 1 }, { 2, 1 }, { 1, 2 }, { 2, 2 } },
+				{ { 1, 1 }, { 2, 1 }, { 1, 2 }, { 2, 2 } },
+				{ { 1, 1 }, { 2, 1 }, { 1, 2 }, { 2, 2 } },
+				{ { 1, 1 }, { 2, 1 }, { 1, 2 }, { 2, 2 } }
+			},
+			{ // L
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 2, 2 } },
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 0 } },
+				{ { 1, 2 }, { 1, 1 }, { 1, 0 }, { 2, 0 } },
+				{ { 0, 2 }, { 1, 2 }, { 1, 1 }, { 1, 0 } }
+			},
+			{ // S
+				{ { 0, 1 }, { 1, 1 }, { 1, 2 }, { 2, 2 } },
+				{ { 0, 0 }, { 1, 0 }, { 1, 1 }, { 2, 1 } },
+				{ { 1, 2 }, { 1, 1 }, { 2, 1 }, { 2, 0 } },
+				{ { 0, 2 }, { 0, 1 }, { 1, 1 }, { 1, 0 } }
+			},
+			{ // I
+				{ { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 2 } },
+				{ { 0, 1 }, { 1, 1 }, { 2, 1 }, { 3, 1 } },
+				{ { 2, 0 }, { 2, 1 }, { 2, 2 }, { 2, 3 } },
+				{ { 1, 0 }, { 1, 1 }, { 1, 2 }, { 1, 3 } }
+			}
+		};
+
+		// The first rotation point is the starting center of the Tetromino, and the one block offsets are measured from.
+		inline constexpr patternCell_t RotationPoints[TypeCount][RotationPointCount] =
+		{
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // T
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // J
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // Z
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // O
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // L
+			{ { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 } }, // S
+			{ { 1, 2 }, { 0, 2 }, { 3, 2 }, { 0, 2 }, { 3, 2 } } // I
+		};
+
+		// Width and height of the defining pattern.
+		inline constexpr patternCell_t PatternDimensions[TypeCount] = { { 3, 3 }, { 3, 3 }, { 3, 3 }, { 3, 3 }, { 3, 3 }, { 3, 3 }, { 4, 4 } };
+
+		// Default spawn coordinates in the matrix, for when no spawn marker is consulted.
+		inline constexpr patternCell_t SpawnCoordinates[TypeCount] = { { 4, 17 }, { 4, 17 }, { 4, 17 }, { 4, 17 }, { 4, 17 }, { 4, 17 }, { 4, 18 } };
+
+		inline constexpr const char* BlockModelPaths[TypeCount] =
+		{
+			"./data/block/purple.obj",
+			"./data/block/darkblue.obj",
+			"./data/block/red.obj",
+			"./data/block/yellow.obj",
+			"./data/block/orange.obj",
+			"./data/block/green.obj",
+			"./data/block/lightblue.obj"
+		};
+
+		// The orientation reached by turning from [orientation] in [rotation]. NONE leaves it where it is.
+		inline constexpr moveDirection_t RotatedOrientations[OrientationCount][RotationCount] =
+		{
+			{ moveDirection_t::WEST, moveDirection_t::NORTH, moveDirection_t::EAST }, // NORTH
+			{ moveDirection_t::EAST, moveDirection_t::SOUTH, moveDirection_t::WEST }, // SOUTH
+			{ moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::SOUTH }, // EAST
+			{ moveDirection_t::SOUTH, moveDirection_t::WEST, moveDirection_t::NORTH } // WEST
+		};
+
+		struct blockOffsetTable_t
+		{
+			patternCell_t offsets[TypeCount][OrientationCount][RotationCount][BlockCount];
+		};
 
+		constexpr blockOffsetTable_t BuildBlockOffsets()
+		{
+			blockOffsetTable_t table{};
+			for (int type = 0; type < TypeCount; type++)
+			{
+				const patternCell_t& center = RotationPoints[type][0];
+				for (int orientation = 0; orientation < OrientationCount; orientation++)
+				{
+					for (int rotation = 0; rotation < RotationCount; rotation++)
+					{
+						const int target = static_cast<int>(RotatedOrientations[orientation][rotation]);
+						for (int block = 0; block < BlockCount; block++)
+						{
+							const patternCell_t& cell = Patterns[type][target][block];
+							table.offsets[type][orientation][rotation][block] = { cell.x - center.x, cell.y - center.y };
+						}
+					}
+				}
+			}
+			return table;
+		}
+
+		// Block offsets from the first rotation point, indexed [type][orientation][rotation][block].
+		// A rotation entry holds the pattern of the orientation the piece would turn into, so a rotation can be tested before it's taken.
+		inline constexpr blockOffsetTable_t BlockOffsets = BuildBlockOffsets();
+	}
+
+	// One component for every piece type. All of the shape data is looked up from TetrominoTables, so a Tetromino is just its type, orientation and blocks.
 	class Tetromino : public Component
 	{
 	private:
@@ -38,48 +157,30 @@ namespace Components
 		moveDirection_t m_desiredOrientation{ moveDirection_t::NORTH };
 		tetrominoType_t m_tetrominoType;
 
-		std::vector<entt::entity> m_blocks;
-		std::vector<glm::vec2> m_rotationPoints;
+		std::array<entt::entity, TetrominoTables::BlockCount> m_blocks;
+		int m_blockCount{ 0 };
 
-		blockPattern_t m_blockPatterns;
-	protected:
-		void AddBlockPattern(int rotationPointIndex, moveDirection_t orientation, rotationDirection_t rotationDirection, std::vector<glm::vec2> blockPattern)
+	public:
+		Tetromino(const tetrominoType_t& tetrominoType, const moveDirection_t& orientation) : m_currentOrientation(orientation), m_desiredOrientation(orientation), m_tetrominoType(tetrominoType)
 		{
-			m_blockPatterns.emplace(std::make_tuple(rotationPointIndex, orientation, rotationDirection), std::make_pair(blockPattern, std::tuple<int, moveDirection_t, rotationDirection_t>()));
+			m_blocks.fill(entt::null);
 		}
 
-		void AddBlockPattern(int rotationPointIndex, moveDirection_t orientation, rotationDirection_t rotationDirection, std::tuple<int, moveDirection_t, rotationDirection_t> alternativeIndex)
+		// Width of the defining pattern of the Tetromino
+		const int GetPatternWidth() const
 		{
-			m_blockPatterns.emplace(std::make_tuple(rotationPointIndex, orientation, rotationDirection), std::make_pair(std::vector<glm::vec2>(), alternativeIndex));
+			return TetrominoTables::PatternDimensions[static_cast<int>(m_tetrominoType)].x;
 		}
 
-	public:
-		// Width of the defining pattern of the Tetromino
-		virtual const int GetPatternWidth() = 0;
-
 		// Height of the defining pattern of the Tetromino
-		virtual const int GetPatternHeight() = 0;
-
-	public:
-		virtual const std::string GetBlockModelPath() = 0;
-
-		// virtual method to determine pattern based on table and rotation adn etc
-	protected:
-		/*
-		* Virtual method to define the pattern of blocks that compose this Tetromino
-		* This pattern should always be defined from a North facing.
-		* Origin should be considered to be lower-left.
-		*/
-		virtual void DefineBlockPattern() = 0;
-		/*
-		* Rotation Points use the same origin as block patterns.
-		* The first rotation point is the starting center of the Tetromino
-		*/
-		virtual void DefineRotationPoints() = 0;
+		const int GetPatternHeight() const
+		{
+			return TetrominoTables::PatternDimensions[static_cast<int>(m_tetrominoType)].y;
+		}
 
-	public:
-		Tetromino(const tetrominoType_t& tetrominoType, const moveDirection_t& orientation) : m_currentOrientation(orientation), m_desiredOrientation(orientation), m_tetrominoType(tetrominoType)
+		const char* GetBlockModelPath() const
 		{
+			return TetrominoTables::BlockModelPaths[static_cast<int>(m_tetrominoType)];
 		}
 
 		const moveDirection_t& GetCurrentOrientation() const
@@ -111,10 +212,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (const auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					const auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					if (!obstructable.GetIsObstructed())
+					if (!obstructable->GetIsObstructed())
 					{
 						return false;
 					}
@@ -128,10 +228,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					obstructable.SetIsObstructed(isObstructed);
+					obstructable->SetIsObstructed(isObstructed);
 				}
 			}
 		}
@@ -141,11 +240,10 @@ namespace Components
 			double lockdownDelay = 0.0;
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (const auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					const auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					if (obstructable.GetLockdownDelay() > lockdownDelay)
-						lockdownDelay = obstructable.GetLockdownDelay();
+					if (obstructable->GetLockdownDelay() > lockdownDelay)
+						lockdownDelay = obstructable->GetLockdownDelay();
 				}
 			}
 
@@ -157,11 +255,10 @@ namespace Components
 			double lastObstructedTime = 0.0;
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (const auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					const auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					if (obstructable.GetLastObstructedTime() > lastObstructedTime)
-						lastObstructedTime = obstructable.GetLastObstructedTime();
+					if (obstructable->GetLastObstructedTime() > lastObstructedTime)
+						lastObstructedTime = obstructable->GetLastObstructedTime();
 				}
 			}
 
@@ -172,10 +269,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					obstructable.SetLastObstructedTime(lastObstructedTime);
+					obstructable->SetLastObstructedTime(lastObstructedTime);
 				}
 			}
 		}
@@ -184,10 +280,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Obstructable>(GetBlock(i)))
+				if (auto* obstructable = registry.try_get<Components::Obstructable>(GetBlock(i)))
 				{
-					auto& obstructable = registry.get<Components::Obstructable>(GetBlock(i));
-					obstructable.SetLockdownDelay(lockdownDelay);
+					obstructable->SetLockdownDelay(lockdownDelay);
 				}
 			}
 		}
@@ -196,10 +291,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Moveable>(GetBlock(i)))
+				if (auto* moveable = registry.try_get<Components::Moveable>(GetBlock(i)))
 				{
-					auto& moveable = registry.get<Components::Moveable>(GetBlock(i));
-					moveable.SetMovementState(movementState);
+					moveable->SetMovementState(movementState);
 				}
 			}
 		}
@@ -208,11 +302,10 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Moveable>(GetBlock(i)))
+				if (auto* moveable = registry.try_get<Components::Moveable>(GetBlock(i)))
 				{
-					auto& moveable = registry.get<Components::Moveable>(GetBlock(i));
-					moveable.SetMovementState(movementState);
-					blockLockData.push_back(moveable.GetCurrentCoordinate());
+					moveable->SetMovementState(movementState);
+					blockLockData.push_back(moveable->GetCurrentCoordinate());
 				}
 			}
 		}
@@ -221,10 +314,9 @@ namespace Components
 		{
 			for (int i = 0; i < 4; i++)
 			{
-				if (registry.all_of<Components::Moveable>(GetBlock(i)))
+				if (const auto* moveable = registry.try_get<Components::Moveable>(GetBlock(i)))
 				{
-					const auto& moveable = registry.get<Components::Moveable>(GetBlock(i));
-					if (moveable.GetMovementState() != Components::movementStates_t::LOCKED)
+					if (moveable->GetMovementState() != Components::movementStates_t::LOCKED)
 						return false;
 				}
 			}
@@ -234,7 +326,10 @@ namespace Components
 
 		void AddBlock(entt::entity block)
 		{
-			m_blocks.push_back(block);
+			if (m_blockCount >= TetrominoTables::BlockCount)
+				throw std::runtime_error("Tetromino already has all of its blocks!");
+
+			m_blocks[m_blockCount++] = block;
 		}
 	
 		const entt::entity& GetBlock(int blockIndex) const
@@ -242,65 +337,22 @@ namespace Components
 			return m_blocks[blockIndex];
 		}
 
-		void AddRotationPoint(const glm::vec2& rotationPoint)
-		{
-			m_rotationPoints.push_back(rotationPoint);
-		}
-
-		const glm::vec2& GetRotationPoint(int rotationPointIndex) const
+		glm::vec2 GetRotationPoint(int rotationPointIndex) const
 		{
-			return m_rotationPoints[rotationPointIndex];
+			const auto& rotationPoint = TetrominoTables::RotationPoints[static_cast<int>(m_tetrominoType)][rotationPointIndex];
+			return glm::vec2(rotationPoint.x, rotationPoint.y);
 		}
-	public:
 
-		// void AddBlock2(int rotationPointIndex, moveDirection_t orientation, rotationDirection_t rotationDirection, std::vector<glm::vec2> blockPattern)
-		glm::vec2 GetBlockOffsetCoordinates(moveDirection_t orientation, int blockIndex, int rotationPointIndex = 0, rotationDirection_t rotationDirection = rotationDirection_t::NONE)
+		// Offset of a block from the Tetromino's center. With a rotation direction, it's the offset the block would have after turning that way.
+		glm::vec2 GetBlockOffsetCoordinates(moveDirection_t orientation, int blockIndex, rotationDirection_t rotationDirection = rotationDirection_t::NONE) const
 		{
-			auto& patternPair = m_blockPatterns[std::make_tuple(rotationPointIndex, orientation, rotationDirection)];
-			if (patternPair.first.empty())
-			{
-				patternPair = m_blockPatterns[std::make_tuple(std::get<0>(patternPair.second), std::get<1>(patternPair.second), std::get<2>(patternPair.second))];
-			}
-
-			return patternPair.first[blockIndex] - m_rotationPoints[rotationPointIndex];
+			const auto& offset = TetrominoTables::BlockOffsets.offsets[static_cast<int>(m_tetrominoType)][static_cast<int>(orientation)][static_cast<int>(rotationDirection)][blockIndex];
+			return glm::vec2(offset.x, offset.y);
 		}
 
 		const moveDirection_t GetNewOrientation(const rotationDirection_t& rotationDirection, const moveDirection_t& currentOrientation) const
 		{
-			if (rotationDirection == rotationDirection_t::CLOCKWISE)
-			{
-				switch (currentOrientation)
-				{
-				case moveDirection_t::NORTH:
-					return moveDirection_t::EAST;
-				case moveDirection_t::EAST:
-					return moveDirection_t::SOUTH;
-				case moveDirection_t::SOUTH:
-					return moveDirection_t::WEST;
-				case moveDirection_t::WEST:
-					return moveDirection_t::NORTH;
-				default:
-					assert(false);
-				}
-			}
-			else if (rotationDirection == rotationDirection_t::COUNTERCLOCKWISE)
-			{
-				switch (currentOrientation)
-				{
-				case moveDirection_t::NORTH:
-					return moveDirection_t::WEST;
-				case moveDirection_t::WEST:
-					return moveDirection_t::SOUTH;
-				case moveDirection_t::SOUTH:
-					return moveDirection_t::EAST;
-				case moveDirection_t::EAST:
-					return moveDirection_t::NORTH;
-				default:
-					assert(false);
-				}
-			}
-
-			assert(false);
+			return TetrominoTables::RotatedOrientations[static_cast<int>(currentOrientation)][static_cast<int>(rotationDirection)];
 		}
 	};
 }
\ No newline at end of file
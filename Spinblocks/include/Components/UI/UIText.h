@@ -2,6 +2,7 @@
 
 #include "Components/UI/UIComponent.h"
 #include <string>
+#include <entt/entity/registry.hpp>
 
 namespace Components
 {
@@ -15,7 +16,7 @@ namespace Components
 		{
 		}
 
-		virtual void DisplayElement()
+		virtual void DisplayElement(const entt::registry& registry)
 		{
 			ImGui::Text(m_text.c_str());
 		}
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Components/UI/UIText.h"
-#include "Systems/SystemShared.h"
+#include "GameContext.h"
 
 namespace Components
 {
@@ -12,9 +12,9 @@ namespace Components
 		{
 		}
 
-		void DisplayElement() override
+		void DisplayElement(const entt::registry& registry) override
 		{
-			ImGui::Text("Level: %d", GameLevel);
+			ImGui::Text("Level: %d", GetGameContext(registry).gameLevel);
 		}
 	};
 }
\ No newline at end of file
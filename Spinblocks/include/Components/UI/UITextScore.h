@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Components/UI/UIText.h"
-#include "Systems/SystemShared.h"
+#include "GameContext.h"
 
 namespace Components
 {
@@ -12,9 +12,9 @@ namespace Components
 		{
 		}
 
-		void DisplayElement() override
+		void DisplayElement(const entt::registry& registry) override
 		{
-			ImGui::Text("Score: %d", GameScore);
+			ImGui::Text("Score: %d", GetGameContext(registry).gameScore);
 		}
 	};
 }
\ No newline at end of file
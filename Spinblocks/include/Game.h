@@ -0,0 +1,23 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+#include "Globals.h"
+
+#include <string>
+
+/*
+* Building and running a game, with no window, input or audio of its own.
+* The game client drives this from its frame loop, and anything headless can drive it the same way on its own registries.
+*/
+namespace Game
+{
+	// Builds the play area, matrix, bag and preview nodes of a new game, and starts its scoring over.
+	void Setup(entt::registry& registry);
+
+	// Runs every system once, in order, at the game's simulation time, then moves the clock on one tick. Does nothing unless the game is being played.
+	void Tick(entt::registry& registry);
+
+	// Ensure gameSystem_t and this function are in sync
+	const std::string GetNameOfSystem(const gameSystem_t& t);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Globals.h"
+#include "Systems/SystemShared.h"
+#include "CachedTagLookup.h"
+#include "Components/Tetrominos/Tetromino.h"
+
+class AudioManager;
+
+// What the ghost piece was last cast from. GhostSystem leaves the ghost where it is until one of these changes.
+struct ghostCast_t
+{
+	entt::entity tetromino = entt::null;
+	entt::entity container = entt::null;
+	glm::uvec2 coordinate = glm::uvec2(0, 0);
+	moveDirection_t orientation = moveDirection_t::NORTH;
+	moveDirection_t downDirection = moveDirection_t::SOUTH;
+	uint64_t blockHash = 0; // The container's settled block hash, which changes along with any settled block.
+
+	bool operator==(const ghostCast_t& other) const
+	{
+		return tetromino == other.tetromino && container == other.container && coordinate == other.coordinate
+			&& orientation == other.orientation && downDirection == other.downDirection && blockHash == other.blockHash;
+	}
+};
+
+// Everything that belongs to a single game rather than to the process.
+// It lives in the game's registry context, so every registry is a game of its own and any number of them can run side by side.
+struct gameContext_t
+{
+	gameState_t gameState = gameState_t::INIT;
+	int gameScore = 0;
+	int gameLevel = StartGameLevel;
+	int levelGoal = StartLevelGoal;
+	int linesClearedTotal = 0;
+	unsigned int piecesDealt = 0; // Pieces moved from the preview queue into the matrix.
+	uint64_t tick = 0; // Update steps run since the game was set up. Only ever counts up, and never pauses with the wall clock.
+	double tickLength = fixedTickLength; // Simulation seconds each tick moves the game on by.
+	uint64_t checksum = 0; // Checksum::ComputeChecksum as of the end of the last tick.
+	double fallSpeed = 1.0; // Base fall speed, time it takes to move 1 line.... (0.8 - ((level - 1) * 0.007))^(level-1)
+	double lastFallUpdate = 0.0;
+	double lastLockdownTime = 0.0;
+	double lastBoardRotationTime = 0.0;
+	randomizerType_t pieceRandomizer = randomizerType_t::SEVEN_BAG; // How the bag deals new pieces.
+	unsigned int previewDepth = 4; // Upcoming pieces held in the preview queue, 1 to 20. Only as many as the bag area has nodes for are shown.
+	CachedTagLookup tagLookup;
+	entt::entity matrixEntity = entt::null; // The game's containers, as Game::Setup created them, so the per tick systems can go straight to them.
+	entt::entity playAreaEntity = entt::null;
+	entt::entity bagAreaEntity = entt::null;
+	entt::entity activePiece = entt::null; // The tetromino last dealt into the matrix. Only in play for as long as it stays Controllable.
+	ghostCast_t ghostCast;
+	std::array<std::vector<entt::entity>, Components::TetrominoTables::TypeCount> parkedBlocks; // The block pool's parked blocks, by the tetromino type whose model they carry.
+	bool renderOrderDirty = true; // Set whenever the draw order may have gone stale.
+	size_t renderOrderSize = 0;
+	bool profileSystems = false; // When set, Game::Tick adds the time spent in each system onto systemSeconds.
+	std::array<double, static_cast<size_t>(gameSystem_t::COUNT)> systemSeconds = {};
+	AudioManager* audioManager = nullptr; // Where the game's sounds are played. Left null for games that run without audio.
+};
+
+// The time every system sees. Worked out from the tick count rather than added up, so it never drifts, and nothing in it depends on how fast the ticks are run.
+inline double GetSimulationTime(const gameContext_t& context)
+{
+	return static_cast<double>(context.tick) * context.tickLength;
+}
+
+// The game context of the registry, created with the defaults the first time it's asked for.
+inline gameContext_t& GetGameContext(entt::registry& registry)
+{
+	return registry.ctx_or_set<gameContext_t>();
+}
+
+inline const gameContext_t& GetGameContext(const entt::registry& registry)
+{
+	return registry.ctx<const gameContext_t>();
+}
\ No newline at end of file
@@ -1,14 +1,12 @@
 #pragma once
 
+#include <entt/entity/registry.hpp>
+
 #include "Globals.h"
 
+// The state of the game run by the registry. It's held in the registry's game context.
 namespace GameState
 {
-	void SetState(const gameState_t& state);
-	const gameState_t& GetState();
-
-	namespace
-	{
-		gameState_t gameState;
-	}
-};
+	void SetState(entt::registry& registry, const gameState_t& state);
+	const gameState_t& GetState(const entt::registry& registry);
+};
\ No newline at end of file
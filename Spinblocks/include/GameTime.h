@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Systems/SystemShared.h"
+
 namespace GameTime
 {
 	double startTime;
@@ -12,6 +14,6 @@ namespace GameTime
 		startTime = startTimeValue;  // Just what time we're taking as starting the game, in case we want to use that for anything.
 		lastFrameTime = startTime; // Because we haven't had a frame yet, initialize last frame to start time.
 		accumulator = 0.0;
-		fixedDeltaTime = 0.02;
+		fixedDeltaTime = fixedTickLength;
 	}
 }
\ No newline at end of file
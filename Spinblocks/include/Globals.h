@@ -43,6 +43,18 @@ enum class rotatePiece_t
 	ROTATE_CLOCKWISE
 };
 
+// What a player can do in a tick, for anything that plays without a keyboard.
+enum class playerInput_t
+{
+	NONE,
+	MOVE_LEFT,
+	MOVE_RIGHT,
+	SOFT_DROP,
+	HARD_DROP,
+	ROTATE_COUNTERCLOCKWISE,
+	ROTATE_CLOCKWISE
+};
+
 enum class rotationDirection_t
 {
 	COUNTERCLOCKWISE,
@@ -69,6 +81,31 @@ enum class tetrominoType_t
 	I
 };
 
+enum class randomizerType_t
+{
+	SEVEN_BAG, // Every type once per bag
+	FOURTEEN_BAG, // Every type twice per bag
+	TGM_HISTORY // Rerolls against the last four pieces dealt
+};
+
+// The systems run each tick, in the order Game::Tick runs them.
+enum class gameSystem_t
+{
+	GENERATION,
+	FALLING,
+	MOVEMENT,
+	STATE_CHANGE,
+	PATTERN,
+	ELIMINATE,
+	BOARD_ROTATE,
+	DETACH,
+	SOUND,
+	COMPLETION,
+	GHOST,
+	CHECKSUM,
+	COUNT
+};
+
 enum class spawnType_t
 {
 	WIDTH3, // T, L, J, S, Z
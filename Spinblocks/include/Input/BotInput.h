@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Input/InputSource.h"
+#include "Bot/Board.h"
+#include "Bot/PlacementSearch.h"
+#include "Bot/Expectimax.h"
+
+#include <memory>
+
+class ThreadPool;
+
+// Plays by searching for the best place for each piece as it comes in, then steering it there an input at a time.
+// The board holds still while a piece is in play, so the path there is kept for as long as the piece stays on it.
+// Gravity or a refused move that takes it off just means another route, worked out from wherever the piece actually is.
+class BotInput : public InputSource
+{
+private:
+	Bot::weights_t m_weights;
+	ThreadPool* m_pool;
+	unsigned int m_inputInterval;
+	std::unique_ptr<Bot::Expectimax> m_search; // Only when looking further ahead than the first preview piece.
+
+	bool m_hasField = false;
+	Bot::field_t m_field;
+
+	unsigned int m_pieceNumber = 0; // piecesDealt when the current piece came in. 0 before the first.
+	bool m_hasTarget = false;
+	Bot::piece_t m_target;
+	bool m_dropped = false;
+
+	bool m_hasPath = false;
+	Bot::path_t m_path;
+	size_t m_pathStep = 0; // Where along the path the piece was last seen.
+
+	Bot::piece_t m_lastPiece;
+	unsigned int m_stuckInputs = 0; // Inputs in a row that left the piece where it was.
+
+	unsigned int m_plans = 0;
+	double m_planSeconds = 0.0;
+
+	void Plan(entt::registry& registry, const Bot::Board& board, const Bot::piece_t& piece);
+	playerInput_t FollowPath(entt::registry& registry, const Bot::piece_t& piece);
+
+public:
+	// Candidates are scored on the pool when one's given. Leave it out when the game itself is already running on one.
+	BotInput(const Bot::weights_t& weights = Bot::weights_t(), ThreadPool* pool = nullptr, const unsigned int& inputInterval = 1);
+
+	// Picks placements with an expectimax search instead, looking as far ahead as the settings say.
+	BotInput(const Bot::expectimaxSettings_t& search, const Bot::weights_t& weights = Bot::weights_t(), ThreadPool* pool = nullptr, const unsigned int& inputInterval = 1);
+
+	playerInput_t GetInput(entt::registry& registry, const unsigned int& tick) override;
+
+	unsigned int GetPlanCount() const
+	{
+		return m_plans;
+	}
+
+	// Wall clock time spent choosing placements, over every plan so far.
+	double GetPlanSeconds() const
+	{
+		return m_planSeconds;
+	}
+
+	// The expectimax search, or null if this bot doesn't use one.
+	const Bot::Expectimax* GetSearch() const
+	{
+		return m_search.get();
+	}
+};
\ No newline at end of file
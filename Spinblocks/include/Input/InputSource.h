@@ -0,0 +1,45 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+#include "Globals.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Plays a game without a keyboard, for headless runs. Asked once a tick what the player does.
+class InputSource
+{
+public:
+	virtual ~InputSource() = default;
+
+	virtual playerInput_t GetInput(entt::registry& registry, const unsigned int& tick) = 0;
+};
+
+// Plays the same list of inputs over and over, one every inputInterval ticks.
+class ScriptedInput : public InputSource
+{
+private:
+	std::vector<playerInput_t> m_script;
+	unsigned int m_inputInterval;
+	size_t m_next = 0;
+
+public:
+	ScriptedInput(const std::vector<playerInput_t>& script, const unsigned int& inputInterval = 1);
+
+	playerInput_t GetInput(entt::registry& registry, const unsigned int& tick) override;
+};
+
+// Presses a random input every inputInterval ticks. Seeded, so a run can be repeated.
+class RandomInput : public InputSource
+{
+private:
+	std::mt19937 m_engine;
+	unsigned int m_inputInterval;
+
+public:
+	RandomInput(const uint32_t& seed, const unsigned int& inputInterval = 1);
+
+	playerInput_t GetInput(entt::registry& registry, const unsigned int& tick) override;
+};
\ No newline at end of file
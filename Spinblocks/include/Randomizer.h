@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Globals.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+/*
+* Piece sequence generators. Each takes an explicit seed, and the same seed deals the same sequence on every platform,
+* so none of the standard library's distributions or shuffles are used.
+* Pieces can be drawn one at a time, or dealt in bulk into a caller's buffer.
+*/
+namespace Randomizers
+{
+	class Randomizer
+	{
+	public:
+		virtual ~Randomizer() = default;
+
+		// Restarts the sequence from the given seed.
+		virtual void Seed(const uint32_t& seed) = 0;
+
+		// An independent copy that carries on the sequence from exactly where this one is.
+		virtual std::unique_ptr<Randomizer> Clone() const = 0;
+
+		virtual tetrominoType_t Next() = 0;
+
+		// Writes the next count pieces into pieces, carrying on the sequence exactly as count calls to Next() would.
+		virtual void Generate(tetrominoType_t* pieces, const size_t& count);
+
+		// How many of each piece type are left to deal in the current bag, and how many of each a full bag holds.
+		// False for randomizers that don't deal from a bag. An empty bag is the same as a full one, since the next piece refills it.
+		virtual bool GetBagContents(std::array<unsigned int, 7>& remaining, unsigned int& copies) const;
+	};
+
+	// Deals shuffled bags holding every piece type bagCopies times over. One copy is the usual 7-bag, two is the 14-bag.
+	class BagRandomizer : public Randomizer
+	{
+	public:
+		static constexpr unsigned int MaximumCopies = 2;
+
+	private:
+		std::mt19937 m_engine;
+		std::array<tetrominoType_t, 7 * MaximumCopies> m_bag;
+		unsigned int m_bagSize;
+		unsigned int m_next; // Index of the next piece in m_bag. A bag is dealt out when this reaches m_bagSize.
+
+		void Refill();
+
+	public:
+		BagRandomizer(const unsigned int& bagCopies, const uint32_t& seed);
+
+		void Seed(const uint32_t& seed) override;
+		std::unique_ptr<Randomizer> Clone() const override;
+		tetrominoType_t Next() override;
+		void Generate(tetrominoType_t* pieces, const size_t& count) override;
+		bool GetBagContents(std::array<unsigned int, 7>& remaining, unsigned int& copies) const override;
+	};
+
+	// TGM style. Each piece is rolled up to rollCount times, rolling again while it matches one of the last four dealt.
+	// The history starts out as all Z, and the first piece is never S, Z or O.
+	class HistoryRandomizer : public Randomizer
+	{
+	private:
+		std::mt19937 m_engine;
+		std::array<tetrominoType_t, 4> m_history;
+		unsigned int m_historyHead; // Slot the next piece dealt is recorded in. The history is a ring, so nothing shifts.
+		unsigned int m_rollCount;
+		bool m_first;
+
+		bool IsInHistory(const tetrominoType_t& tetrominoType) const;
+
+	public:
+		HistoryRandomizer(const unsigned int& rollCount, const uint32_t& seed);
+
+		void Seed(const uint32_t& seed) override;
+		std::unique_ptr<Randomizer> Clone() const override;
+		tetrominoType_t Next() override;
+	};
+
+	std::unique_ptr<Randomizer> CreateRandomizer(const randomizerType_t& randomizerType, const uint32_t& seed);
+
+	// A seed from the system's entropy source, for games that don't need reproducing.
+	uint32_t GenerateSeed();
+}
\ No newline at end of file
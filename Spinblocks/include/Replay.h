@@ -0,0 +1,159 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+#include "Globals.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+* Recordings of games, as the inputs applied before each tick along with what's needed to deal the same pieces again.
+* The game runs on its own fixed step clock, so playing the inputs back into a new game reproduces it exactly.
+*
+* A file is a short header followed by one event per input. An event is a byte holding the input in its low 3 bits and the ticks
+* since the last event in its high 5, with anything from 31 ticks up carried on in a varint after it, so most events are the one byte.
+* An end event closes the file with the tick the game stopped at. Events are written out to disk with every checksum, and at least every
+* few seconds of play besides, so a file cut off before the end, by a crash say, still plays up to the last time it was written out.
+* Every so many ticks, a checksum event holds the game's checksum, so playback can tell whether it's still the game that was recorded.
+* Pausing stops the clock, so a pause never shows up in a recording at all.
+*/
+namespace Replay
+{
+	struct header_t
+	{
+		uint32_t seed = 0;
+		randomizerType_t pieceRandomizer = randomizerType_t::SEVEN_BAG;
+		unsigned int previewDepth = 4;
+		double tickLength = 0.0;
+		unsigned int checksumInterval = 0; // Ticks between checksums. 0 records none.
+	};
+
+	struct event_t
+	{
+		uint64_t tick = 0; // The input is applied just before this tick runs.
+		playerInput_t input = playerInput_t::NONE;
+	};
+
+	struct checkpoint_t
+	{
+		uint64_t tick = 0; // The game's checksum once this many ticks have run.
+		uint64_t checksum = 0;
+	};
+
+	struct recording_t
+	{
+		header_t header;
+		std::vector<event_t> events; // In tick order. Any number of them can share a tick.
+		std::vector<checkpoint_t> checkpoints; // In tick order.
+		uint64_t tickCount = 0;
+	};
+
+	// How playback has compared with the checksums recorded.
+	struct verification_t
+	{
+		size_t checked = 0;
+		bool diverged = false;
+		uint64_t lastMatchedTick = 0; // Before diverging, if it has.
+		uint64_t divergedTick = 0; // The first checkpoint that didn't match. The game went wrong after lastMatchedTick, and by this tick.
+	};
+
+	// How the game on the registry was set up. The seed is the one its bag was last seeded with.
+	header_t ReadHeader(entt::registry& registry);
+
+	// Sets up a game on an empty registry and starts it, as the recorded one was.
+	void StartGame(entt::registry& registry, const header_t& header);
+
+	// Writes events out to the file as they come in.
+	class Recorder
+	{
+	private:
+		std::ofstream m_stream;
+		unsigned int m_checksumInterval;
+		uint64_t m_lastTick = 0;
+		uint64_t m_lastFlushTick = 0;
+		bool m_unflushed = false; // Events have gone into the stream since it was last flushed.
+		bool m_recorded = false;
+		bool m_finished = false;
+
+		void WriteEvent(const uint64_t& tick, const uint8_t& code);
+		void Flush(const uint64_t& tick);
+
+	public:
+		Recorder(const std::string& path, const header_t& header);
+		~Recorder();
+
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+		// An input applied before the given tick. Ticks can't go backwards.
+		void Record(const uint64_t& tick, const playerInput_t& input);
+
+		// The game's checksum once the given number of ticks have run. Only kept every checksumInterval ticks.
+		void RecordChecksum(const uint64_t& tick, const uint64_t& checksum);
+
+		// Closes the recording at the tick the game stopped at. Left undone, the destructor closes it after the last tick an input was recorded for.
+		void Finish(const uint64_t& tickCount);
+	};
+
+	recording_t Load(const std::string& path);
+
+	/*
+	* Plays a recording back with no window, as fast as it'll go. A copy of the game is kept every keyframeInterval ticks on the way,
+	* so going to any tick already played through only has to play on from the keyframe before it.
+	*/
+	class Player
+	{
+	private:
+		recording_t m_recording;
+		uint64_t m_keyframeInterval;
+		std::unique_ptr<entt::registry> m_registry;
+		std::vector<std::unique_ptr<entt::registry>> m_keyframes; // The game as it was before tick i * m_keyframeInterval ran.
+		size_t m_nextEvent = 0;
+		size_t m_nextCheckpoint = 0;
+		verification_t m_verification;
+
+		void Restart();
+		void Verify();
+
+	public:
+		explicit Player(recording_t recording, const unsigned int& keyframeInterval = 600);
+
+		// Checks the game against any checksum recorded for this point, then applies the inputs for the next tick and runs it.
+		// False, without running anything, once the recording's over or the game's out of play.
+		bool Step();
+
+		// Plays on, or goes back, to just before the given tick runs. Stops short if the recording ends first.
+		void Seek(const uint64_t& tick);
+
+		// The next tick to run.
+		uint64_t GetTick() const;
+
+		entt::registry& GetRegistry()
+		{
+			return *m_registry;
+		}
+
+		const recording_t& GetRecording() const
+		{
+			return m_recording;
+		}
+
+		size_t GetKeyframeCount() const
+		{
+			return m_keyframes.size();
+		}
+
+		const verification_t& GetVerification() const
+		{
+			return m_verification;
+		}
+	};
+
+	// Replaces destination with a copy of the game on source. Entities, components and the order each pool holds them in all match,
+	// so the copy plays on exactly as the original would.
+	void CopyGame(const entt::registry& source, entt::registry& destination);
+}
\ No newline at end of file
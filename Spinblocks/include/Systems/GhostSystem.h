@@ -0,0 +1,8 @@
+#pragma once
+
+#include <entt/entity/registry.hpp>
+
+namespace Systems
+{
+	void GhostSystem(entt::registry& registry, double currentFrameTime);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+* A work stealing thread pool. Every worker has its own queue, taking new work from the back of it and stealing from the front of the others' when it runs dry.
+* Work submitted from inside a task stays on that worker's queue, so nested work runs where its data's already warm.
+* A worker waiting on the pool helps run tasks rather than blocking, so waiting from inside a task is safe.
+* Any other thread sleeps until the work it's waiting on is done, leaving every core to the workers.
+*/
+class ThreadPool
+{
+private:
+	struct workerQueue_t
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<workerQueue_t>> m_queues;
+	std::vector<std::thread> m_threads;
+
+	std::atomic<size_t> m_queued{ 0 }; // Tasks sitting in a queue.
+	std::atomic<size_t> m_unfinished{ 0 }; // Tasks queued or running.
+	std::atomic<unsigned int> m_nextQueue{ 0 }; // Where work submitted from outside the pool goes next. Spread round the queues in turn.
+
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+
+	std::mutex m_doneMutex;
+	std::condition_variable m_done; // Signalled when m_unfinished reaches 0.
+	std::exception_ptr m_failure; // The first exception a submitted task threw, held for Wait. Guarded by m_doneMutex.
+
+	bool IsWorker() const;
+	unsigned int GetCurrentWorkerIndex() const;
+	bool TakeTask(const unsigned int& queueIndex, std::function<void()>& task);
+	bool RunPendingTask();
+	void WorkerLoop(const unsigned int& workerIndex);
+
+public:
+	// A threadCount of 0 uses one thread per hardware thread.
+	explicit ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int GetThreadCount() const
+	{
+		return static_cast<unsigned int>(m_threads.size());
+	}
+
+	void Submit(std::function<void()> task);
+
+	// Returns once every task submitted so far has finished. If any of them threw, the first exception is rethrown here.
+	void Wait();
+
+	// Calls func(i) for every i below count, spread over the pool, and returns once they've all finished.
+	// If any of them throw, the first exception is rethrown here.
+	void ParallelFor(const size_t& count, const std::function<void(size_t)>& func);
+};
\ No newline at end of file
@@ -3,18 +3,21 @@
 #include "Components/Tetrominos/Tetromino.h" // Not sure why this is required, since it's in Components/Includes.h, but there are issues with Tetromino without it...
 #include "Components/NodeOrder.h" // Not sure why this is required, since it's in Components/Includes.h, but there are issues with NodeOrder without it...
 #include "Components/Block.h"
+#include "Components/Orientation.h"
 
 #include <entt/entity/registry.hpp>
 #include "Components/Includes.h"
 #include "Systems/SystemShared.h"
 
-#include "CachedTagLookup.h"
+#include "GameContext.h"
 
 #include <string>
 #include <vector>
+#include <array>
 
 void RotatePiece(entt::registry& registry, const rotatePiece_t& rotatePiece);
 void MovePiece(entt::registry& registry, const movePiece_t& movePiece);
+void ApplyPlayerInput(entt::registry& registry, const playerInput_t& playerInput);
 
 // Ensure containerType_t and this function are in sync
 const std::string GetTagFromContainerType(const containerType_t& t);
@@ -33,17 +36,37 @@ const Components::Cell& GetCellOfEntity(entt::registry& registry, const entt::en
 Components::Cell& GetCellAtCoordinates(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& coordinate);
 entt::entity GetCellAtCoordinates2(entt::registry& registry, const Components::Coordinate& coordinate);
 const Components::Block& GetBlockAtCoordinates(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& coordinate);
+entt::entity GetOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate);
+void SetOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const entt::entity& blockEnt);
+void ClearOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const entt::entity& blockEnt);
+void WakeEntity(entt::registry& registry, const entt::entity& entity);
+
+// The active piece and anything still settling. Owning Moveable and Coordinate keeps their data packed at the front of those pools, ahead of every settled block.
+using AwakeGroup = entt::basic_group<entt::entity, entt::exclude_t<>, entt::get_t<Components::Awake>, Components::Moveable, Components::Coordinate>;
+AwakeGroup GetAwakeGroup(entt::registry& registry);
+
+// Everything that gets drawn, kept sorted by render layer so drawing is a single pass in order.
+using RenderGroup = entt::basic_group<entt::entity, entt::exclude_t<>, entt::get_t<>, Components::Renderable, Components::Position, Components::Orientation, Components::Scale>;
+RenderGroup GetRenderGroup(entt::registry& registry);
+void TrackRenderOrder(entt::registry& registry);
+void SortRenderGroup(entt::registry& registry);
+bool AreTetrominoCellsFree(const Components::Container& container, const std::array<glm::ivec2, 4>& cells);
+bool DoesTetrominoFit(entt::registry& registry, const entt::entity& tetrominoEnt, const Components::Coordinate& coordinate, const moveDirection_t& orientation);
 entt::entity MoveBlockInDirection(entt::registry& registry, const entt::entity& blockEnt, const moveDirection_t& direction, const unsigned int& distance, const bool& disableObstruction = false);
-entt::entity GetCellLinkAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const moveDirection_t& direction);
 entt::entity GetActiveControllable(entt::registry& registry);
-void BuildGrid(entt::registry& registry, const entt::entity& parentEntity);
+void BuildGrid(entt::registry& registry, const entt::entity& parentEntity, const bool& tagCells = true);
+const std::string GetCellDebugName(entt::registry& registry, const entt::entity& cellEnt);
 entt::entity SpawnBlock(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& spawnCoordinate, const bool& isControllable = true);
-void LinkCoordinates(entt::registry& registry, const Components::Coordinate& origin, const Components::Coordinate& destination, const moveDirection_t& moveDir, const moveDirection_t& moveDirReverse);
+void ReserveBlockStorage(entt::registry& registry, const size_t& blockCount);
+void ReleaseBlock(entt::registry& registry, const entt::entity& blockEnt);
+void ReleaseTetromino(entt::registry& registry, const entt::entity& tetrominoEnt);
+void LinkCoordinates(entt::registry& registry, const Components::Coordinate& origin, const Components::Coordinate& destination, const moveDirection_t& moveDir, const moveDirection_t& moveDirReverse, const bool& placeMarker = true);
+void ConnectGrids(entt::registry& registry, const entt::entity& lhs, const moveDirection_t& lhsConnectDir, const entt::entity& rhs, const moveDirection_t& rhsConnectDir, const bool& placeMarkers = false);
 entt::entity SpawnProjectedTetromino(entt::registry& registry, const entt::entity& tetrominoEnt);
 entt::entity SpawnTetromino(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& spawnCoordinate, const tetrominoType_t& tetrominoType, const bool& isControllable = true);
 bool IsEntityTetromino(entt::registry& registry, entt::entity ent);
 Components::Tetromino* GetTetrominoFromEntity(entt::registry& registry, entt::entity entity);
-bool IsAnyBlockInTetrominoObstructingSelf(entt::registry& registry, entt::entity entity, const entt::entity& cellEntity, const bool& disableObstruction);
+bool IsAnyBlockInTetrominoObstructingSelf(entt::registry& registry, entt::entity entity, const entt::entity& cellEntity);
 bool IsAnyBlockInTetrominoObstructed(entt::registry& registry, entt::entity entity);
 bool AreCoordinatesObstructed(entt::registry& registry, const Components::Coordinate& coordinate, const entt::entity probeEntity);
 glm::uvec2 GetTetrominoSpawnCoordinates(entt::registry& registry, const std::string& containerTag, const tetrominoType_t& tetrominoType);
@@ -58,8 +81,16 @@ void RotatePlayArea(entt::registry& registry, const rotationDirection_t& rotatio
 void UpdateDirectionalWalls(entt::registry& registry);
 void UpdateCensors(entt::registry& registry);
 rotationDirection_t ChooseBoardRotationDirection(entt::registry& registry, const std::vector<BlockLockData>& blockLockData, const moveDirection_t& playAreaDirection, const int& linesMatched);
+rotationDirection_t ChooseBoardRotationDirection(const std::vector<BlockLockData>& blockLockData, const moveDirection_t& playAreaDirection, const int& linesMatched);
+glm::ivec2 GetDirectionOffset(const moveDirection_t& direction);
+unsigned int GetDropDistance(const Components::Container& container, const std::array<glm::ivec2, 4>& cells, const glm::ivec2& step);
+unsigned int GetDropDistance(entt::registry& registry, const entt::entity& tetrominoEnt);
+Components::Coordinate GetLandingCoordinate(entt::registry& registry, const entt::entity& tetrominoEnt);
 glm::uvec2 FindLowestCell(entt::registry& registry, entt::entity tetrominoEnt);
+void SpawnGhostBlocks(entt::registry& registry, const entt::entity& containerEnt);
 double CalculateFallSpeed(int level);
 void PlaceCensor(entt::registry& registry, const Components::Coordinate& coordinate, const bool& directional, const std::vector<moveDirection_t> directions);
 void FillPauseCensors(entt::registry& registry, entt::entity matrix, entt::entity bagArea);
-void PlaceWall(entt::registry& registry, const Components::Coordinate& coordinate, const bool& directional, const std::vector<moveDirection_t> directions);
\ No newline at end of file
+void PlaceWall(entt::registry& registry, const Components::Coordinate& coordinate, const bool& directional, const std::vector<moveDirection_t> directions);
+entt::entity PlaceBagMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const Components::renderLayer_t& layer = Components::renderLayer_t::RL_MARKER_UNDER);
+void PlaceSpawnMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const spawnType_t& spawnType, const moveDirection_t& activeDirection, const Components::renderLayer_t& layer = Components::renderLayer_t::RL_MARKER_UNDER);
\ No newline at end of file
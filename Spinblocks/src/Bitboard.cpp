@@ -0,0 +1,328 @@
+#include "Bitboard.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITBOARD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITBOARD_SSE2
+#endif
+
+#if defined(__SSSE3__) && !defined(BITBOARD_AVX2)
+#include <tmmintrin.h>
+#define BITBOARD_SSSE3
+#endif
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define BITBOARD_BMI2
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace Bitboard
+{
+	unsigned int PopCount(uint64_t bits)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned int>(__builtin_popcountll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+		return static_cast<unsigned int>(__popcnt64(bits));
+#else
+		unsigned int count = 0;
+		for (; bits != 0; bits &= bits - 1)
+			count++;
+		return count;
+#endif
+	}
+
+	unsigned int LowestBit(uint64_t bits)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned int>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return static_cast<unsigned int>(index);
+#else
+		unsigned int index = 0;
+		while (((bits >> index) & 1) == 0)
+			index++;
+		return index;
+#endif
+	}
+
+	unsigned int HighestBit(uint64_t bits)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - static_cast<unsigned int>(__builtin_clzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanReverse64(&index, bits);
+		return static_cast<unsigned int>(index);
+#else
+		unsigned int index = 63;
+		while (((bits >> index) & 1) == 0)
+			index--;
+		return index;
+#endif
+	}
+
+	uint64_t SpanMask(const unsigned int& offset, const unsigned int& length)
+	{
+		if (offset >= 64 || length == 0)
+			return 0;
+
+		const uint64_t bits = length >= 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1;
+		return bits << offset;
+	}
+
+	uint64_t FindFullRows(const uint64_t* rows, const unsigned int& rowCount, const uint64_t& lineMask)
+	{
+		uint64_t fullRows = 0;
+		unsigned int i = 0;
+
+#if defined(BITBOARD_AVX2)
+		const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(lineMask));
+		for (; i + 4 <= rowCount; i += 4)
+		{
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i));
+			const __m256i full = _mm256_cmpeq_epi64(_mm256_and_si256(block, mask), mask);
+			fullRows |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(full))) << i;
+		}
+#elif defined(BITBOARD_SSE2)
+		// No 64 bit compare in SSE2; a row is full when both of its 32 bit halves match.
+		const __m128i mask = _mm_set_epi32(static_cast<int>(lineMask >> 32), static_cast<int>(lineMask), static_cast<int>(lineMask >> 32), static_cast<int>(lineMask));
+		for (; i + 2 <= rowCount; i += 2)
+		{
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + i));
+			const __m128i full = _mm_cmpeq_epi32(_mm_and_si128(block, mask), mask);
+			const int halves = _mm_movemask_ps(_mm_castsi128_ps(full));
+
+			if ((halves & 0x3) == 0x3)
+				fullRows |= uint64_t(1) << i;
+			if ((halves & 0xC) == 0xC)
+				fullRows |= uint64_t(1) << (i + 1);
+		}
+#endif
+
+		for (; i < rowCount; i++)
+		{
+			if ((rows[i] & lineMask) == lineMask)
+				fullRows |= uint64_t(1) << i;
+		}
+
+		return fullRows;
+	}
+
+	uint64_t FindFullColumns(const uint64_t* rows, const unsigned int& rowCount, const uint64_t& columnMask)
+	{
+		if (rowCount == 0)
+			return 0;
+
+		uint64_t common = ~uint64_t(0);
+		unsigned int i = 0;
+
+#if defined(BITBOARD_AVX2)
+		__m256i accumulator = _mm256_set1_epi64x(-1);
+		for (; i + 4 <= rowCount; i += 4)
+		{
+			accumulator = _mm256_and_si256(accumulator, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i)));
+		}
+
+		alignas(32) uint64_t lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+		common = lanes[0] & lanes[1] & lanes[2] & lanes[3];
+#elif defined(BITBOARD_SSE2)
+		__m128i accumulator = _mm_set1_epi32(-1);
+		for (; i + 2 <= rowCount; i += 2)
+		{
+			accumulator = _mm_and_si128(accumulator, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + i)));
+		}
+
+		alignas(16) uint64_t lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+		common = lanes[0] & lanes[1];
+#endif
+
+		for (; i < rowCount; i++)
+		{
+			common &= rows[i];
+		}
+
+		return common & columnMask;
+	}
+
+	uint64_t FindRowsWithCount(const uint64_t* rows, const unsigned int& rowCount, const unsigned int& count)
+	{
+		uint64_t matchingRows = 0;
+		unsigned int i = 0;
+
+#if defined(BITBOARD_AVX2)
+		// Nibble lookup popcount; the byte sums land in each 64 bit lane, ready to compare against count.
+		const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+		const __m256i target = _mm256_set1_epi64x(count);
+		for (; i + 4 <= rowCount; i += 4)
+		{
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i));
+			const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(block, lowNibbles));
+			const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(block, 4), lowNibbles));
+			const __m256i counts = _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+			const __m256i matches = _mm256_cmpeq_epi64(counts, target);
+			matchingRows |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(matches))) << i;
+		}
+#elif defined(BITBOARD_SSSE3)
+		const __m128i lookup = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m128i lowNibbles = _mm_set1_epi8(0x0F);
+		const __m128i target = _mm_set1_epi32(static_cast<int>(count));
+		for (; i + 2 <= rowCount; i += 2)
+		{
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + i));
+			const __m128i low = _mm_shuffle_epi8(lookup, _mm_and_si128(block, lowNibbles));
+			const __m128i high = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(block, 4), lowNibbles));
+			const __m128i counts = _mm_sad_epu8(_mm_add_epi8(low, high), _mm_setzero_si128());
+			// The sums fit in the low 32 bits of each lane, and the high 32 bits are zero, so only the low half needs comparing.
+			const int matches = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(counts, target)));
+
+			if (matches & 0x1)
+				matchingRows |= uint64_t(1) << i;
+			if (matches & 0x4)
+				matchingRows |= uint64_t(1) << (i + 1);
+		}
+#endif
+
+		for (; i < rowCount; i++)
+		{
+			if (PopCount(rows[i]) == count)
+				matchingRows |= uint64_t(1) << i;
+		}
+
+		return matchingRows;
+	}
+
+	uint64_t FindColumnsWithCount(const uint64_t* rows, const unsigned int& rowCount, const unsigned int& count)
+	{
+		// Bit sliced counters: planes[k] holds bit k of every column's running count, so all 64 columns are summed at once.
+		uint64_t planes[32] = {};
+		unsigned int planeCount = 1;
+		while (planeCount < 32 && (rowCount >> planeCount) != 0)
+			planeCount++;
+
+		if ((count >> planeCount) != 0)
+			return 0;
+
+		for (unsigned int i = 0; i < rowCount; i++)
+		{
+			uint64_t carry = rows[i];
+			for (unsigned int k = 0; k < planeCount && carry != 0; k++)
+			{
+				const uint64_t nextCarry = planes[k] & carry;
+				planes[k] ^= carry;
+				carry = nextCarry;
+			}
+		}
+
+		uint64_t matchingColumns = ~uint64_t(0);
+		for (unsigned int k = 0; k < planeCount; k++)
+		{
+			matchingColumns &= ((count >> k) & 1) ? planes[k] : ~planes[k];
+		}
+
+		return matchingColumns;
+	}
+
+	void CompactRows(uint64_t* rows, const unsigned int& rowCount, const uint64_t& clearedRows, const bool& towardsFirst)
+	{
+		if (clearedRows == 0)
+			return;
+
+		if (towardsFirst)
+		{
+			unsigned int write = 0;
+			for (unsigned int read = 0; read < rowCount; read++)
+			{
+				if ((clearedRows >> read) & 1)
+					continue;
+
+				rows[write++] = rows[read];
+			}
+			std::memset(rows + write, 0, (rowCount - write) * sizeof(uint64_t));
+		}
+		else
+		{
+			unsigned int write = rowCount;
+			for (unsigned int read = rowCount; read-- > 0;)
+			{
+				if ((clearedRows >> read) & 1)
+					continue;
+
+				rows[--write] = rows[read];
+			}
+			std::memset(rows, 0, write * sizeof(uint64_t));
+		}
+	}
+
+#if !defined(BITBOARD_BMI2)
+	static uint64_t ExtractBits(uint64_t source, uint64_t mask)
+	{
+		uint64_t result = 0;
+		for (uint64_t bit = 1; mask != 0; bit <<= 1)
+		{
+			const uint64_t lowest = mask & (~mask + 1);
+			if (source & lowest)
+				result |= bit;
+			mask &= mask - 1;
+		}
+		return result;
+	}
+
+	static uint64_t DepositBits(uint64_t source, uint64_t mask)
+	{
+		uint64_t result = 0;
+		for (uint64_t bit = 1; mask != 0; bit <<= 1)
+		{
+			const uint64_t lowest = mask & (~mask + 1);
+			if (source & bit)
+				result |= lowest;
+			mask &= mask - 1;
+		}
+		return result;
+	}
+#endif
+
+	uint64_t CompactColumnsOfRow(const uint64_t& row, const uint64_t& clearedColumns, const uint64_t& spanMask, const bool& towardsLow)
+	{
+		const uint64_t kept = spanMask & ~clearedColumns;
+		const unsigned int removed = PopCount(spanMask) - PopCount(kept);
+
+#if defined(BITBOARD_BMI2)
+		uint64_t packed = _pext_u64(row, kept);
+		if (!towardsLow && removed < 64)
+			packed <<= removed;
+		const uint64_t compacted = _pdep_u64(packed, spanMask);
+#else
+		uint64_t packed = ExtractBits(row, kept);
+		if (!towardsLow && removed < 64)
+			packed <<= removed;
+		const uint64_t compacted = DepositBits(packed, spanMask);
+#endif
+
+		return (row & ~spanMask) | compacted;
+	}
+
+	void CompactColumns(uint64_t* rows, const unsigned int& rowCount, const uint64_t& clearedColumns, const uint64_t& spanMask, const bool& towardsLow)
+	{
+		if ((clearedColumns & spanMask) == 0)
+			return;
+
+		for (unsigned int i = 0; i < rowCount; i++)
+		{
+			rows[i] = CompactColumnsOfRow(rows[i], clearedColumns, spanMask, towardsLow);
+		}
+	}
+}
\ No newline at end of file
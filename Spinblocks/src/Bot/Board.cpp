@@ -0,0 +1,404 @@
+#include "Bot/Board.h"
+#include "Bot/Zobrist.h"
+
+#include "Utility.h"
+#include "Bitboard.h"
+#include "Systems/SystemShared.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace Bot
+{
+	static bool IsBitSet(const rows_t& rows, const glm::ivec2& cell)
+	{
+		return ((rows[cell.y] >> cell.x) & 1) != 0;
+	}
+
+	static moveDirection_t GetDownDirection(const moveDirection_t& orientation)
+	{
+		Components::CardinalDirection cardinalDirection;
+		cardinalDirection.SetCurrentOrientation(orientation);
+		return cardinalDirection.GetCurrentDownDirection();
+	}
+
+	Board::Board(const field_t& field, const rows_t& blocks, const moveDirection_t& orientation) : m_field(&field), m_blocks(blocks), m_orientation(orientation)
+	{
+		m_hash = ComputeHash();
+	}
+
+	uint64_t Board::ComputeHash() const
+	{
+		const zobristKeys_t& keys = GetZobristKeys();
+
+		uint64_t hash = keys.orientations[static_cast<int>(m_orientation)];
+		for (int y = 0; y < m_field->dimensions.y; y++)
+		{
+			for (uint64_t bits = m_blocks[y]; bits != 0; bits &= bits - 1)
+				hash ^= keys.cells[y][Bitboard::LowestBit(bits)];
+		}
+		return hash;
+	}
+
+	bool Board::IsFree(const glm::ivec2& cell) const
+	{
+		if (cell.x < 0 || cell.y < 0 || cell.x >= m_field->dimensions.x || cell.y >= m_field->dimensions.y)
+			return false;
+
+		if (!IsBitSet(m_field->cells, cell))
+			return false;
+
+		return !IsBitSet(m_field->walls[static_cast<int>(m_orientation)], cell) && !IsBitSet(m_blocks, cell);
+	}
+
+	bool Board::IsBlockSet(const glm::ivec2& cell) const
+	{
+		if (cell.x < 0 || cell.y < 0 || cell.x >= m_field->dimensions.x || cell.y >= m_field->dimensions.y)
+			return false;
+
+		return IsBitSet(m_blocks, cell);
+	}
+
+	std::array<glm::ivec2, 4> Board::GetCells(const piece_t& piece)
+	{
+		const auto& offsets = Components::TetrominoTables::BlockOffsets.offsets[static_cast<int>(piece.type)][static_cast<int>(piece.orientation)][static_cast<int>(rotationDirection_t::NONE)];
+
+		std::array<glm::ivec2, 4> cells;
+		for (int i = 0; i < 4; i++)
+		{
+			cells[i] = piece.position + glm::ivec2(offsets[i].x, offsets[i].y);
+		}
+		return cells;
+	}
+
+	bool Board::Fits(const piece_t& piece) const
+	{
+		for (const auto& cell : GetCells(piece))
+		{
+			if (!IsFree(cell))
+				return false;
+		}
+		return true;
+	}
+
+	bool Board::Shift(const piece_t& piece, const moveDirection_t& direction, piece_t& moved) const
+	{
+		piece_t candidate = piece;
+		candidate.position += GetDirectionOffset(direction);
+		if (!Fits(candidate))
+			return false;
+
+		moved = candidate;
+		return true;
+	}
+
+	bool Board::Rotate(const piece_t& piece, const rotationDirection_t& rotation, piece_t& rotated) const
+	{
+		if (rotation == rotationDirection_t::NONE)
+			return false;
+
+		const int type = static_cast<int>(piece.type);
+		const int orientation = static_cast<int>(piece.orientation);
+		const auto& current = Components::TetrominoTables::BlockOffsets.offsets[type][orientation][static_cast<int>(rotationDirection_t::NONE)];
+		const auto& turned = Components::TetrominoTables::BlockOffsets.offsets[type][orientation][static_cast<int>(rotation)];
+
+		// RotatePiece tests each block's own coordinate plus its rotated offset, so a turn is only taken when that test would pass too.
+		for (int i = 0; i < 4; i++)
+		{
+			if (!IsFree(piece.position + glm::ivec2(current[i].x + turned[i].x, current[i].y + turned[i].y)))
+				return false;
+		}
+
+		piece_t candidate = piece;
+		candidate.orientation = Components::TetrominoTables::RotatedOrientations[orientation][static_cast<int>(rotation)];
+		if (!Fits(candidate))
+			return false;
+
+		rotated = candidate;
+		return true;
+	}
+
+	piece_t Board::Drop(const piece_t& piece) const
+	{
+		const moveDirection_t down = GetDownDirection(m_orientation);
+
+		piece_t landed = piece;
+		while (Shift(landed, down, landed))
+		{
+		}
+		return landed;
+	}
+
+	// Finds full lines the way PatternSystem does, and closes them up towards the floor the way EliminateSystem does.
+	int Board::ClearLines()
+	{
+		const unsigned int rowCount = static_cast<unsigned int>(m_field->dimensions.y);
+		const bool horizontal = m_orientation == moveDirection_t::NORTH || m_orientation == moveDirection_t::SOUTH;
+
+		uint64_t fullLines;
+		if (horizontal)
+			fullLines = Bitboard::FindRowsWithCount(m_blocks.data(), rowCount, m_field->playAreaUpper.x - m_field->playAreaLower.x);
+		else
+			fullLines = Bitboard::FindColumnsWithCount(m_blocks.data(), rowCount, m_field->playAreaUpper.y - m_field->playAreaLower.y) & Bitboard::SpanMask(0, m_field->dimensions.x);
+
+		if (fullLines == 0)
+			return 0;
+
+		const glm::ivec2 down = GetDirectionOffset(GetDownDirection(m_orientation));
+		const bool floorIsLow = (down.x + down.y) < 0;
+
+		if (horizontal)
+			Bitboard::CompactRows(m_blocks.data(), rowCount, fullLines, floorIsLow);
+		else
+			Bitboard::CompactColumns(m_blocks.data(), rowCount, fullLines, Bitboard::SpanMask(0, m_field->dimensions.x), floorIsLow);
+
+		return static_cast<int>(Bitboard::PopCount(fullLines));
+	}
+
+	// What DetachSystem does after a board rotation. Every block in the play area falls as far as it can towards the new floor.
+	void Board::Collapse()
+	{
+		const glm::ivec2 down = GetDirectionOffset(GetDownDirection(m_orientation));
+		const glm::ivec2& lower = m_field->playAreaLower;
+		const glm::ivec2& upper = m_field->playAreaUpper;
+		if (lower.x >= upper.x || lower.y >= upper.y)
+			return;
+
+		const rows_t& walls = m_field->walls[static_cast<int>(m_orientation)];
+		const bool vertical = down.x == 0;
+		const int acrossBegin = vertical ? lower.x : lower.y;
+		const int acrossEnd = vertical ? upper.x : upper.y;
+		const int alongBegin = vertical ? lower.y : lower.x;
+		const int alongEnd = vertical ? upper.y : upper.x;
+		const bool floorIsLow = (down.x + down.y) < 0;
+
+		for (int across = acrossBegin; across < acrossEnd; across++)
+		{
+			int emptyCount = 0;
+			for (int step = 0; step < alongEnd - alongBegin; step++)
+			{
+				const int along = floorIsLow ? alongBegin + step : alongEnd - 1 - step;
+				const glm::ivec2 cell = vertical ? glm::ivec2(across, along) : glm::ivec2(along, across);
+
+				if (IsBitSet(walls, cell) || !IsBitSet(m_field->cells, cell))
+				{
+					emptyCount = 0;
+					continue;
+				}
+
+				if (!IsBitSet(m_blocks, cell))
+				{
+					emptyCount++;
+					continue;
+				}
+
+				if (emptyCount == 0)
+					continue;
+
+				const glm::ivec2 destination = cell + down * emptyCount;
+				m_blocks[cell.y] &= ~(uint64_t(1) << cell.x);
+				m_blocks[destination.y] |= uint64_t(1) << destination.x;
+			}
+		}
+	}
+
+	placeResult_t Board::Place(const piece_t& piece)
+	{
+		const zobristKeys_t& keys = GetZobristKeys();
+		const auto cells = GetCells(piece);
+		for (const auto& cell : cells)
+		{
+			m_blocks[cell.y] |= uint64_t(1) << cell.x;
+			m_hash ^= keys.cells[cell.y][cell.x];
+		}
+
+		placeResult_t result;
+		result.linesCleared = ClearLines();
+
+		if (result.linesCleared >= static_cast<int>(minimumLinesMatchedToTriggerBoardRotation))
+		{
+			std::vector<BlockLockData> blockLockData;
+			for (const auto& cell : cells)
+			{
+				blockLockData.push_back(BlockLockData(Components::Coordinate(entt::null, glm::uvec2(cell))));
+			}
+			result.boardRotation = ChooseBoardRotationDirection(blockLockData, m_orientation, result.linesCleared);
+		}
+
+		if (result.boardRotation != rotationDirection_t::NONE)
+		{
+			m_orientation = Components::CardinalDirection().GetNewOrientation(result.boardRotation, m_orientation);
+			Collapse();
+
+			// Whatever the fall completes is cleared on a later tick. It's counted, though it can't turn the board again here.
+			result.linesCleared += ClearLines();
+		}
+
+		// Clears and falls move blocks all over, so those are hashed again from scratch.
+		if (result.linesCleared > 0 || result.boardRotation != rotationDirection_t::NONE)
+			m_hash = ComputeHash();
+
+		return result;
+	}
+
+	bool Board::GetSpawn(const tetrominoType_t& type, piece_t& piece) const
+	{
+		const int orientation = static_cast<int>(m_orientation);
+		if (!m_field->hasSpawn[orientation][static_cast<int>(type)])
+			return false;
+
+		// Pieces keep the orientation they had on show in the bag area.
+		piece.type = type;
+		piece.orientation = moveDirection_t::NORTH;
+		piece.position = m_field->spawns[orientation][static_cast<int>(type)];
+		return true;
+	}
+
+	static bool IsWallActiveInOrientation(entt::registry& registry, const entt::entity& wallEnt, const moveDirection_t& orientation)
+	{
+		if (registry.all_of<Components::DirectionallyActive>(wallEnt))
+		{
+			const auto& dirActive = registry.get<Components::DirectionallyActive>(wallEnt);
+			if (dirActive.IsEnabled())
+				return dirActive.IsActive(orientation);
+		}
+
+		if (registry.all_of<Components::Obstructs>(wallEnt))
+			return registry.get<Components::Obstructs>(wallEnt).IsEnabled();
+
+		return true;
+	}
+
+	field_t ReadField(entt::registry& registry)
+	{
+		const auto matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+		if (matrixEnt == entt::null || !registry.all_of<Components::Container>(matrixEnt))
+			throw std::runtime_error("Matrix entity is null!");
+
+		const auto& container = registry.get<Components::Container>(matrixEnt);
+
+		field_t field;
+		field.dimensions = glm::ivec2(container.GetGridDimensions());
+		if (field.dimensions.x > 64 || field.dimensions.y > static_cast<int>(MaxRows))
+			throw std::runtime_error("Matrix is too large for a bot board!");
+
+		for (int y = 0; y < field.dimensions.y; y++)
+		{
+			for (int x = 0; x < field.dimensions.x; x++)
+			{
+				if (container.GetCellAt(glm::uvec2(x, y)) != entt::null)
+					field.cells[y] |= uint64_t(1) << x;
+			}
+		}
+
+		auto wallView = registry.view<Components::Wall, Components::Coordinate>();
+		for (auto entity : wallView)
+		{
+			const auto& wall = wallView.get<Components::Wall>(entity);
+			const auto& coordinate = wallView.get<Components::Coordinate>(entity);
+			if (!wall.IsEnabled() || coordinate.GetParent() != matrixEnt || !container.IsWithinBounds(coordinate.Get()))
+				continue;
+
+			for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+			{
+				if (IsWallActiveInOrientation(registry, entity, static_cast<moveDirection_t>(orientation)))
+					field.walls[orientation][coordinate.Get().y] |= uint64_t(1) << coordinate.Get().x;
+			}
+		}
+
+		// The play area is inside the border the walls make in every orientation taken together. Without any walls, it's the whole matrix.
+		rows_t border{};
+		for (const auto& walls : field.walls)
+		{
+			for (int y = 0; y < field.dimensions.y; y++)
+				border[y] |= walls[y];
+		}
+
+		field.playAreaLower = field.dimensions;
+		field.playAreaUpper = glm::ivec2(-1, -1);
+		for (int y = 0; y < field.dimensions.y; y++)
+		{
+			if (border[y] == 0)
+				continue;
+
+			field.playAreaLower = glm::min(field.playAreaLower, glm::ivec2(static_cast<int>(Bitboard::LowestBit(border[y])), y));
+			field.playAreaUpper = glm::max(field.playAreaUpper, glm::ivec2(static_cast<int>(Bitboard::HighestBit(border[y])), y));
+		}
+
+		if (field.playAreaUpper.x < 0)
+		{
+			field.playAreaLower = glm::ivec2(0, 0);
+			field.playAreaUpper = field.dimensions;
+		}
+		else
+		{ // Step inside the border on the low sides. The high sides are already one past the last play area cell.
+			field.playAreaLower += glm::ivec2(1, 1);
+		}
+
+		// The first marker that suits, as GetTetrominoSpawnCoordinates takes it.
+		auto spawnMarkerView = registry.view<Components::SpawnMarker, Components::Coordinate>();
+		for (auto entity : spawnMarkerView)
+		{
+			const auto& marker = spawnMarkerView.get<Components::SpawnMarker>(entity);
+			const auto& coordinate = spawnMarkerView.get<Components::Coordinate>(entity);
+			if (coordinate.GetParent() != matrixEnt)
+				continue;
+
+			for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+			{
+				if (registry.all_of<Components::DirectionallyActive>(entity) && !registry.get<Components::DirectionallyActive>(entity).IsActive(static_cast<moveDirection_t>(orientation)))
+					continue;
+
+				for (unsigned int type = 0; type < TypeCount; type++)
+				{
+					if (field.hasSpawn[orientation][type] || !marker.ValidForTetrominoType(static_cast<tetrominoType_t>(type)))
+						continue;
+
+					field.spawns[orientation][type] = glm::ivec2(coordinate.Get());
+					field.hasSpawn[orientation][type] = true;
+				}
+			}
+		}
+
+		return field;
+	}
+
+	Board ReadBoard(entt::registry& registry, const field_t& field)
+	{
+		const auto matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+		if (matrixEnt == entt::null || !registry.all_of<Components::Container>(matrixEnt))
+			throw std::runtime_error("Matrix entity is null!");
+
+		const auto playAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA));
+		if (playAreaEnt == entt::null)
+			throw std::runtime_error("Play Area entity is null!");
+
+		const auto& container = registry.get<Components::Container>(matrixEnt);
+		const uint64_t* blockRows = container.GetBlockRowData();
+		if (blockRows == nullptr || container.GetWordsPerRow() != 1 || glm::ivec2(container.GetGridDimensions()) != field.dimensions)
+			throw std::runtime_error("Matrix doesn't match the bot's field!");
+
+		rows_t blocks{};
+		std::copy(blockRows, blockRows + field.dimensions.y, blocks.begin());
+
+		return Board(field, blocks, registry.get<Components::CardinalDirection>(playAreaEnt).GetCurrentOrientation());
+	}
+
+	bool ReadActivePiece(entt::registry& registry, piece_t& piece)
+	{
+		const entt::entity tetrominoEnt = GetActiveControllable(registry);
+		if (tetrominoEnt == entt::null || !IsEntityTetromino(registry, tetrominoEnt))
+			return false;
+
+		const auto& coordinate = registry.get<Components::Coordinate>(tetrominoEnt);
+		if (coordinate.GetParent() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX)))
+			return false;
+
+		const auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
+		piece.type = tetromino->GetType();
+		piece.orientation = tetromino->GetCurrentOrientation();
+		piece.position = glm::ivec2(coordinate.Get());
+		return true;
+	}
+}
\ No newline at end of file
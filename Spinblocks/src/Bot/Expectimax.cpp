@@ -0,0 +1,281 @@
+#include "Bot/Expectimax.h"
+#include "Bot/Zobrist.h"
+
+#include "ThreadPool.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace Bot
+{
+	static void RunAll(ThreadPool* pool, const size_t& count, const std::function<void(size_t)>& func)
+	{
+		if (pool != nullptr && pool->GetThreadCount() > 1)
+		{
+			pool->ParallelFor(count, func);
+		}
+		else
+		{
+			for (size_t i = 0; i < count; i++)
+				func(i);
+		}
+	}
+
+	static unsigned int CountRemaining(const bagState_t& bag)
+	{
+		unsigned int total = 0;
+		for (const auto& count : bag.remaining)
+			total += count;
+		return total;
+	}
+
+	// An empty bag refills before the next piece is dealt, so it's held as the full bag it's about to be.
+	static bagState_t Normalize(const bagState_t& bag)
+	{
+		bagState_t normalized = bag;
+		if (bag.copies != 0 && CountRemaining(bag) == 0)
+			normalized.remaining.fill(bag.copies);
+		return normalized;
+	}
+
+	static bagState_t Draw(const bagState_t& bag, const tetrominoType_t& type)
+	{
+		if (bag.copies == 0)
+			return bag;
+
+		bagState_t drawn = Normalize(bag);
+		drawn.remaining[static_cast<int>(type)]--;
+		return drawn;
+	}
+
+	static uint64_t GetBagKey(const bagState_t& bag)
+	{
+		if (bag.copies == 0)
+			return 0;
+
+		const zobristKeys_t& keys = GetZobristKeys();
+		const bagState_t normalized = Normalize(bag);
+
+		uint64_t key = 0;
+		for (unsigned int type = 0; type < TypeCount; type++)
+			key ^= keys.bag[type][normalized.remaining[type]];
+		return key;
+	}
+
+	Expectimax::Expectimax(const weights_t& weights, const expectimaxSettings_t& settings) : m_weights(weights), m_settings(settings), m_table(settings.tableSizeLog2)
+	{
+		if (m_settings.depth == 0 || m_settings.depth > ZobristMaxDepth)
+			throw std::runtime_error("Unsupported search depth!");
+
+		if (m_settings.width == 0)
+			throw std::runtime_error("Search width must be at least one!");
+	}
+
+	// A position with depth pieces still to place, the first of them queue[next] if the queue reaches that far.
+	double Expectimax::ScorePosition(const Board& board, const std::vector<tetrominoType_t>& queue, const size_t& next, const bagState_t& bag, const unsigned int& depth, ThreadPool* pool)
+	{
+		const zobristKeys_t& keys = GetZobristKeys();
+
+		// Only what's within reach of the search goes into the key, so positions that differ further out still share a result.
+		const size_t known = std::min<size_t>(queue.size() - next, depth);
+		uint64_t key = board.GetHash() ^ keys.depths[depth];
+		for (size_t i = 0; i < known; i++)
+			key ^= keys.queue[i][static_cast<int>(queue[next + i])];
+		if (known < depth)
+			key ^= GetBagKey(bag);
+
+		double score;
+		if (m_table.Probe(key, score))
+		{
+			m_tableHits.fetch_add(1, std::memory_order_relaxed);
+			return score;
+		}
+
+		if (known > 0)
+		{
+			score = ScorePiece(board, queue[next], queue, next + 1, bag, depth, pool);
+		}
+		else
+		{ // A chance node. Every type the bag could deal, weighted by how many of it are left.
+			const bagState_t normalized = Normalize(bag);
+			std::array<double, TypeCount> odds;
+			double total = 0.0;
+			for (unsigned int type = 0; type < TypeCount; type++)
+			{
+				odds[type] = bag.copies == 0 ? 1.0 : static_cast<double>(normalized.remaining[type]);
+				total += odds[type];
+			}
+
+			std::array<double, TypeCount> scores{};
+			RunAll(depth >= 2 ? pool : nullptr, TypeCount, [&](size_t type)
+				{
+					if (odds[type] > 0.0)
+						scores[type] = ScorePiece(board, static_cast<tetrominoType_t>(type), queue, next, Draw(bag, static_cast<tetrominoType_t>(type)), depth, pool);
+				});
+
+			// Summed in type order, so the result is the same whichever thread finished first.
+			score = 0.0;
+			for (unsigned int type = 0; type < TypeCount; type++)
+			{
+				if (odds[type] > 0.0)
+					score += odds[type] / total * scores[type];
+			}
+		}
+
+		m_table.Store(key, score);
+		return score;
+	}
+
+	// The best that can be done placing a piece of this type, and then the depth - 1 pieces after it.
+	double Expectimax::ScorePiece(const Board& board, const tetrominoType_t& type, const std::vector<tetrominoType_t>& queue, const size_t& next, const bagState_t& bag, const unsigned int& depth, ThreadPool* pool)
+	{
+		piece_t piece;
+		if (!board.GetSpawn(type, piece) || !board.Fits(piece))
+			return m_weights.topOut;
+
+		const auto placements = FindPlacements(board, piece);
+		if (placements.empty())
+			return m_weights.topOut;
+
+		m_nodes.fetch_add(placements.size(), std::memory_order_relaxed);
+
+		std::vector<Board> afters(placements.size(), board);
+		std::vector<placeResult_t> results(placements.size());
+		std::vector<double> scores(placements.size());
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			results[i] = afters[i].Place(placements[i]);
+			scores[i] = Evaluate(afters[i], results[i], m_weights);
+		}
+
+		if (depth == 1)
+			return *std::max_element(scores.begin(), scores.end());
+
+		std::vector<size_t> order(placements.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+		order.resize(std::min(order.size(), m_settings.width));
+
+		std::vector<double> deeper(order.size());
+		RunAll(pool, order.size(), [&](size_t i)
+			{
+				const size_t candidate = order[i];
+				deeper[i] = ScoreResult(results[candidate], m_weights) + ScorePosition(afters[candidate], queue, next, bag, depth - 1, pool);
+			});
+
+		return *std::max_element(deeper.begin(), deeper.end());
+	}
+
+	bool Expectimax::Choose(const Board& board, const piece_t& current, const std::vector<tetrominoType_t>& preview, const bagState_t& bag, ThreadPool* pool, piece_t& target)
+	{
+		const auto placements = FindPlacements(board, current);
+		if (placements.empty())
+			return false;
+
+		m_nodes.fetch_add(placements.size(), std::memory_order_relaxed);
+
+		std::vector<Board> afters(placements.size(), board);
+		std::vector<placeResult_t> results(placements.size());
+		std::vector<double> scores(placements.size());
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			results[i] = afters[i].Place(placements[i]);
+			scores[i] = Evaluate(afters[i], results[i], m_weights);
+		}
+
+		// Ties go to the first found, as ChoosePlacement breaks them.
+		std::vector<size_t> order(placements.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+
+		if (m_settings.depth > 1)
+		{
+			order.resize(std::min(order.size(), m_settings.width));
+			RunAll(pool, order.size(), [&](size_t i)
+				{
+					const size_t candidate = order[i];
+					scores[candidate] = ScoreResult(results[candidate], m_weights) + ScorePosition(afters[candidate], preview, 0, bag, m_settings.depth - 1, pool);
+				});
+			std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+		}
+
+		target = placements[order.front()];
+		return true;
+	}
+
+	searchStats_t Expectimax::GetStats() const
+	{
+		searchStats_t stats;
+		stats.nodes = m_nodes.load(std::memory_order_relaxed);
+		stats.tableHits = m_tableHits.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void Expectimax::ResetStats()
+	{
+		m_nodes.store(0, std::memory_order_relaxed);
+		m_tableHits.store(0, std::memory_order_relaxed);
+	}
+
+	/*
+	* Undoes the deals from last to first. Before a piece was dealt the bag held it as well, unless the bag looks full,
+	* in which case it was really empty, and the piece was the last of the bag before.
+	*/
+	bagState_t RewindBag(const bagState_t& bag, const std::vector<tetrominoType_t>& hidden)
+	{
+		if (bag.copies == 0)
+			return bag;
+
+		bagState_t rewound = bag;
+		for (auto it = hidden.rbegin(); it != hidden.rend(); ++it)
+		{
+			if (CountRemaining(rewound) == static_cast<unsigned int>(rewound.copies) * TypeCount)
+				rewound.remaining.fill(0);
+
+			rewound.remaining[static_cast<int>(*it)]++;
+		}
+		return rewound;
+	}
+
+	void ReadUpcoming(entt::registry& registry, const unsigned int& shown, std::vector<tetrominoType_t>& preview, bagState_t& bag)
+	{
+		preview.clear();
+		bag = bagState_t();
+
+		const auto bagAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA));
+		if (bagAreaEnt == entt::null)
+			return;
+
+		std::vector<tetrominoType_t> hidden;
+		if (registry.all_of<Components::PreviewQueue>(bagAreaEnt))
+		{
+			const auto& previewQueue = registry.get<Components::PreviewQueue>(bagAreaEnt);
+			for (unsigned int i = 0; i < previewQueue.GetSize(); i++)
+			{
+				if (i < shown)
+					preview.push_back(previewQueue.Peek(i));
+				else
+					hidden.push_back(previewQueue.Peek(i));
+			}
+		}
+
+		if (!registry.all_of<Components::Bag>(bagAreaEnt))
+			return;
+
+		std::array<unsigned int, 7> remaining;
+		unsigned int copies;
+		if (!registry.get<Components::Bag>(bagAreaEnt).GetBagContents(remaining, copies))
+			return;
+
+		for (unsigned int type = 0; type < TypeCount; type++)
+			bag.remaining[type] = static_cast<uint8_t>(remaining[type]);
+		bag.copies = static_cast<uint8_t>(copies);
+
+		bag = RewindBag(bag, hidden);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,562 @@
+#include "Bot/PlacementSearch.h"
+
+#include "ThreadPool.h"
+#include "Utility.h"
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+namespace Bot
+{
+	// How far a piece's center can sit outside the matrix with its blocks still inside it.
+	static constexpr int CenterMargin = 3;
+
+	// How many of the best single piece candidates are looked at again with the preview piece. Looking at all of them costs several times as much, for little better play.
+	static constexpr size_t LookaheadWidth = 6;
+	static constexpr unsigned int MapRows = MaxRows + CenterMargin * 2;
+
+	// One bit per center position, offset by CenterMargin on both axes, one row of them per word.
+	using positionMap_t = std::array<uint64_t, MapRows>;
+
+	static constexpr playerInput_t searchMoves[] = {
+		playerInput_t::MOVE_LEFT,
+		playerInput_t::MOVE_RIGHT,
+		playerInput_t::ROTATE_CLOCKWISE,
+		playerInput_t::ROTATE_COUNTERCLOCKWISE,
+		playerInput_t::SOFT_DROP
+	};
+
+	static uint64_t ShiftBits(const uint64_t& bits, const int& by)
+	{
+		if (by >= 64 || by <= -64)
+			return 0;
+		return by >= 0 ? bits << by : bits >> -by;
+	}
+
+	struct searchNode_t
+	{
+		piece_t piece;
+		int parent; // Index of the node this was reached from. -1 for the start.
+		playerInput_t move; // What got here from the parent.
+	};
+
+	/*
+	* Everywhere one piece type fits on a board, as bitmaps of center positions, one per orientation. A turn has its own map of where RotatePiece allows it.
+	* With those, a move is a shift and a mask, so all the positions a piece can reach are flood filled a whole row at a time.
+	*/
+	class Search
+	{
+	private:
+		const Board& m_board;
+		tetrominoType_t m_type;
+		Components::CardinalDirection m_playAreaDirection;
+		int m_rowCount;
+		uint64_t m_positionMask;
+
+		std::array<positionMap_t, OrientationCount> m_fits{};
+		std::array<std::array<positionMap_t, 2>, OrientationCount> m_turns{}; // [orientation][counterclockwise, clockwise]
+
+		static int GetTurnIndex(const rotationDirection_t& rotation)
+		{
+			return rotation == rotationDirection_t::CLOCKWISE ? 1 : 0;
+		}
+
+		uint64_t GetFreeCells(const int& y) const
+		{
+			const field_t& field = m_board.GetField();
+			if (y < 0 || y >= field.dimensions.y)
+				return 0;
+
+			return field.cells[y] & ~field.walls[static_cast<int>(m_board.GetOrientation())][y] & ~m_board.GetBlockRows()[y] & Bitboard::SpanMask(0, field.dimensions.x);
+		}
+
+		// Bit x of row y is set when every cell at (x, y) plus an offset is free.
+		void BuildMap(const std::array<glm::ivec2, 4>& offsets, positionMap_t& map) const
+		{
+			for (int row = 0; row < m_rowCount; row++)
+			{
+				uint64_t bits = m_positionMask;
+				for (const auto& offset : offsets)
+				{
+					bits &= ShiftBits(GetFreeCells(row - CenterMargin + offset.y), CenterMargin - offset.x);
+				}
+				map[row] = bits;
+			}
+		}
+
+		// Moves every position in the map one step along the direction.
+		positionMap_t Translate(const positionMap_t& map, const glm::ivec2& direction) const
+		{
+			positionMap_t moved{};
+			for (int row = 0; row < m_rowCount; row++)
+			{
+				const int target = row + direction.y;
+				if (target >= 0 && target < m_rowCount)
+					moved[target] = ShiftBits(map[row], direction.x) & m_positionMask;
+			}
+			return moved;
+		}
+
+		// Carries every position in the map as far as it'll go along the direction, keeping to the fit map. True if anything was added.
+		bool Spread(positionMap_t& map, const positionMap_t& fits, const glm::ivec2& direction) const
+		{
+			bool grew = false;
+			if (direction.y == 0)
+			{ // Along a row, a shift at a time until it stops growing.
+				for (int row = 0; row < m_rowCount; row++)
+				{
+					uint64_t bits = map[row];
+					for (;;)
+					{
+						const uint64_t spread = bits | (ShiftBits(bits, direction.x) & fits[row]);
+						if (spread == bits)
+							break;
+						bits = spread;
+					}
+					grew |= bits != map[row];
+					map[row] = bits;
+				}
+			}
+			else
+			{ // Across rows, one pass in the direction of travel carries each row into the next.
+				const int first = direction.y > 0 ? 1 : m_rowCount - 2;
+				for (int row = first; row >= 0 && row < m_rowCount; row += direction.y)
+				{
+					const uint64_t added = map[row - direction.y] & fits[row] & ~map[row];
+					map[row] |= added;
+					grew |= added != 0;
+				}
+			}
+			return grew;
+		}
+
+		bool IsSet(const positionMap_t& map, const glm::ivec2& position) const
+		{
+			const int x = position.x + CenterMargin;
+			const int y = position.y + CenterMargin;
+			if (x < 0 || y < 0 || x >= 64 || y >= m_rowCount)
+				return false;
+
+			return ((map[y] >> x) & 1) != 0;
+		}
+
+	public:
+		Search(const Board& board, const tetrominoType_t& type) : m_board(board), m_type(type)
+		{
+			m_playAreaDirection.SetCurrentOrientation(board.GetOrientation());
+			m_rowCount = board.GetField().dimensions.y + CenterMargin * 2;
+			m_positionMask = Bitboard::SpanMask(0, board.GetField().dimensions.x + CenterMargin * 2);
+
+			const auto& offsets = Components::TetrominoTables::BlockOffsets.offsets[static_cast<int>(type)];
+			for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+			{
+				std::array<glm::ivec2, 4> cells;
+				for (int i = 0; i < 4; i++)
+				{
+					const auto& offset = offsets[orientation][static_cast<int>(rotationDirection_t::NONE)][i];
+					cells[i] = glm::ivec2(offset.x, offset.y);
+				}
+				BuildMap(cells, m_fits[orientation]);
+			}
+
+			// RotatePiece tests each block's own coordinate plus its rotated offset, so a turn is only taken where that passes and the turned piece fits.
+			for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+			{
+				for (const auto& rotation : { rotationDirection_t::COUNTERCLOCKWISE, rotationDirection_t::CLOCKWISE })
+				{
+					std::array<glm::ivec2, 4> cells;
+					for (int i = 0; i < 4; i++)
+					{
+						const auto& current = offsets[orientation][static_cast<int>(rotationDirection_t::NONE)][i];
+						const auto& turned = offsets[orientation][static_cast<int>(rotation)][i];
+						cells[i] = glm::ivec2(current.x + turned.x, current.y + turned.y);
+					}
+
+					auto& turns = m_turns[orientation][GetTurnIndex(rotation)];
+					BuildMap(cells, turns);
+
+					const auto& target = m_fits[static_cast<int>(Components::TetrominoTables::RotatedOrientations[orientation][static_cast<int>(rotation)])];
+					for (int row = 0; row < m_rowCount; row++)
+						turns[row] &= target[row];
+				}
+			}
+		}
+
+		bool Fits(const piece_t& piece) const
+		{
+			return IsSet(m_fits[static_cast<int>(piece.orientation)], piece.position);
+		}
+
+		bool Apply(const piece_t& piece, const playerInput_t& move, piece_t& next) const
+		{
+			next = piece;
+			switch (move)
+			{
+			case playerInput_t::MOVE_LEFT:
+				next.position += GetDirectionOffset(m_playAreaDirection.GetCurrentLeftDirection());
+				return Fits(next);
+			case playerInput_t::MOVE_RIGHT:
+				next.position += GetDirectionOffset(m_playAreaDirection.GetCurrentRightDirection());
+				return Fits(next);
+			case playerInput_t::SOFT_DROP:
+				next.position += GetDirectionOffset(m_playAreaDirection.GetCurrentDownDirection());
+				return Fits(next);
+			case playerInput_t::ROTATE_CLOCKWISE:
+			case playerInput_t::ROTATE_COUNTERCLOCKWISE:
+			{
+				const rotationDirection_t rotation = move == playerInput_t::ROTATE_CLOCKWISE ? rotationDirection_t::CLOCKWISE : rotationDirection_t::COUNTERCLOCKWISE;
+				if (!IsSet(m_turns[static_cast<int>(piece.orientation)][GetTurnIndex(rotation)], piece.position))
+					return false;
+				next.orientation = Components::TetrominoTables::RotatedOrientations[static_cast<int>(piece.orientation)][static_cast<int>(rotation)];
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		piece_t Drop(const piece_t& piece) const
+		{
+			const glm::ivec2 down = GetDirectionOffset(m_playAreaDirection.GetCurrentDownDirection());
+
+			piece_t landed = piece;
+			piece_t next = piece;
+			next.position += down;
+			while (Fits(next))
+			{
+				landed = next;
+				next.position += down;
+			}
+			return landed;
+		}
+
+		// Every position reachable from the start, filled outwards a move at a time until nothing new turns up.
+		std::array<positionMap_t, OrientationCount> FloodFill(const piece_t& start) const
+		{
+			std::array<positionMap_t, OrientationCount> reached{};
+			if (!Fits(start))
+				return reached;
+
+			reached[static_cast<int>(start.orientation)][start.position.y + CenterMargin] = uint64_t(1) << (start.position.x + CenterMargin);
+
+			const glm::ivec2 steps[] = {
+				GetDirectionOffset(m_playAreaDirection.GetCurrentLeftDirection()),
+				GetDirectionOffset(m_playAreaDirection.GetCurrentRightDirection()),
+				GetDirectionOffset(m_playAreaDirection.GetCurrentDownDirection())
+			};
+
+			bool grew = true;
+			while (grew)
+			{
+				grew = false;
+				for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+				{
+					auto& map = reached[orientation];
+					for (const auto& step : steps)
+					{
+						grew |= Spread(map, m_fits[orientation], step);
+					}
+
+					for (const auto& rotation : { rotationDirection_t::COUNTERCLOCKWISE, rotationDirection_t::CLOCKWISE })
+					{
+						auto& target = reached[static_cast<int>(Components::TetrominoTables::RotatedOrientations[orientation][static_cast<int>(rotation)])];
+						const auto& turns = m_turns[orientation][GetTurnIndex(rotation)];
+						for (int row = 0; row < m_rowCount; row++)
+						{
+							const uint64_t added = map[row] & turns[row] & ~target[row];
+							target[row] |= added;
+							grew |= added != 0;
+						}
+					}
+				}
+			}
+
+			return reached;
+		}
+
+		// The reachable positions that can't go any further down, where the piece would lock.
+		std::vector<piece_t> FindResting(const piece_t& start) const
+		{
+			const auto reached = FloodFill(start);
+			const glm::ivec2 up = GetDirectionOffset(m_playAreaDirection.GetCurrentUpDirection());
+
+			std::vector<piece_t> resting;
+			for (unsigned int orientation = 0; orientation < OrientationCount; orientation++)
+			{
+				// A position with room below it is one whose step down is in the fit map. Bring that back up a step to mask it out.
+				const positionMap_t roomBelow = Translate(m_fits[orientation], up);
+				for (int row = 0; row < m_rowCount; row++)
+				{
+					for (uint64_t bits = reached[orientation][row] & ~roomBelow[row]; bits != 0; bits &= bits - 1)
+					{
+						const int column = static_cast<int>(Bitboard::LowestBit(bits));
+
+						piece_t piece;
+						piece.type = m_type;
+						piece.orientation = static_cast<moveDirection_t>(orientation);
+						piece.position = glm::ivec2(column - CenterMargin, row - CenterMargin);
+						resting.push_back(piece);
+					}
+				}
+			}
+			return resting;
+		}
+
+		// Breadth first from the start, so each node is as few inputs away as it can be.
+		std::vector<searchNode_t> FindPaths(const piece_t& start) const
+		{
+			std::vector<searchNode_t> nodes;
+			if (!Fits(start))
+				return nodes;
+
+			std::array<positionMap_t, OrientationCount> visited{};
+			visited[static_cast<int>(start.orientation)][start.position.y + CenterMargin] |= uint64_t(1) << (start.position.x + CenterMargin);
+			nodes.push_back({ start, -1, playerInput_t::NONE });
+
+			for (size_t i = 0; i < nodes.size(); i++)
+			{
+				for (const auto& move : searchMoves)
+				{
+					piece_t next;
+					if (!Apply(nodes[i].piece, move, next))
+						continue;
+
+					auto& visitedRow = visited[static_cast<int>(next.orientation)][next.position.y + CenterMargin];
+					const uint64_t bit = uint64_t(1) << (next.position.x + CenterMargin);
+					if (visitedRow & bit)
+						continue;
+
+					visitedRow |= bit;
+					nodes.push_back({ next, static_cast<int>(i), move });
+				}
+			}
+			return nodes;
+		}
+	};
+
+	// The cells a piece covers, sorted and packed, so two pieces landing on the same cells compare equal whatever their center and orientation.
+	static uint64_t GetCellKey(const piece_t& piece)
+	{
+		auto cells = Board::GetCells(piece);
+
+		std::array<uint64_t, 4> packed;
+		for (int i = 0; i < 4; i++)
+		{
+			packed[i] = static_cast<uint64_t>(cells[i].y) * 64 + static_cast<uint64_t>(cells[i].x);
+		}
+		std::sort(packed.begin(), packed.end());
+
+		return (packed[0] << 48) | (packed[1] << 32) | (packed[2] << 16) | packed[3];
+	}
+
+	std::vector<piece_t> FindPlacements(const Board& board, const piece_t& piece)
+	{
+		// Soft drop is one of the moves, so every landing is in the fill already. Where the piece rests is where it'd lock.
+		std::vector<piece_t> placements;
+		std::vector<uint64_t> keys;
+		for (const auto& resting : Search(board, piece.type).FindResting(piece))
+		{
+			const uint64_t key = GetCellKey(resting);
+			if (std::find(keys.begin(), keys.end(), key) != keys.end())
+				continue;
+
+			keys.push_back(key);
+			placements.push_back(resting);
+		}
+
+		return placements;
+	}
+
+	/*
+	* Columns run along gravity, across the width of the play area. Each is measured from the floor out to the edge of the matrix,
+	* so blocks left sticking up into the buffer area count against the board as well.
+	*/
+	boardFeatures_t MeasureBoard(const Board& board)
+	{
+		Components::CardinalDirection playAreaDirection;
+		playAreaDirection.SetCurrentOrientation(board.GetOrientation());
+		const glm::ivec2 down = GetDirectionOffset(playAreaDirection.GetCurrentDownDirection());
+		const glm::ivec2& dimensions = board.GetField().dimensions;
+
+		const bool vertical = down.x == 0;
+		const bool floorIsLow = (down.x + down.y) < 0;
+		const glm::ivec2& lower = board.GetField().playAreaLower;
+		const glm::ivec2& upper = board.GetField().playAreaUpper;
+		const int acrossBegin = vertical ? lower.x : lower.y;
+		const int acrossEnd = vertical ? upper.x : upper.y;
+		const int floorLine = floorIsLow ? (vertical ? lower.y : lower.x) : (vertical ? upper.y : upper.x) - 1;
+		const int columnLength = floorIsLow ? (vertical ? dimensions.y : dimensions.x) - floorLine : floorLine + 1;
+		const int upStep = floorIsLow ? 1 : -1;
+
+		const rows_t& blocks = board.GetBlockRows();
+		std::array<int, 64> heights{};
+		int blockCount = 0;
+
+		if (vertical)
+		{ // Columns are bits. Walk the rows up from the floor, and the last row a bit turns up in is its column's height.
+			const uint64_t acrossMask = Bitboard::SpanMask(acrossBegin, acrossEnd - acrossBegin);
+			for (int step = 0; step < columnLength; step++)
+			{
+				const uint64_t row = blocks[floorLine + step * upStep] & acrossMask;
+				blockCount += Bitboard::PopCount(row);
+				for (uint64_t bits = row; bits != 0; bits &= bits - 1)
+					heights[Bitboard::LowestBit(bits)] = step + 1;
+			}
+		}
+		else
+		{ // Columns are rows, so the height is how far the furthest bit is from the floor.
+			const uint64_t alongMask = floorIsLow ? Bitboard::SpanMask(floorLine, columnLength) : Bitboard::SpanMask(0, columnLength);
+			for (int across = acrossBegin; across < acrossEnd; across++)
+			{
+				const uint64_t row = blocks[across] & alongMask;
+				if (row == 0)
+					continue;
+
+				blockCount += Bitboard::PopCount(row);
+				heights[across] = floorIsLow ? static_cast<int>(Bitboard::HighestBit(row)) - floorLine + 1 : floorLine - static_cast<int>(Bitboard::LowestBit(row)) + 1;
+			}
+		}
+
+		boardFeatures_t features;
+		for (int across = acrossBegin; across < acrossEnd; across++)
+		{
+			features.aggregateHeight += heights[across];
+			features.maxHeight = std::max(features.maxHeight, heights[across]);
+			if (across > acrossBegin)
+				features.bumpiness += std::abs(heights[across] - heights[across - 1]);
+		}
+		features.holes = features.aggregateHeight - blockCount;
+
+		return features;
+	}
+
+	double ScoreResult(const placeResult_t& result, const weights_t& weights)
+	{
+		return weights.lines * result.linesCleared + (result.boardRotation != rotationDirection_t::NONE ? weights.boardRotation : 0.0);
+	}
+
+	double ScoreBoard(const Board& board, const weights_t& weights)
+	{
+		const boardFeatures_t features = MeasureBoard(board);
+		return weights.holes * features.holes + weights.bumpiness * features.bumpiness + weights.aggregateHeight * features.aggregateHeight + weights.maxHeight * features.maxHeight;
+	}
+
+	double Evaluate(const Board& board, const placeResult_t& result, const weights_t& weights)
+	{
+		return ScoreResult(result, weights) + ScoreBoard(board, weights);
+	}
+
+	// The best the board can do with the next piece, or the top out score if the next piece can't come in or can't go anywhere.
+	static double ScoreNextPiece(const Board& board, const tetrominoType_t& type, const weights_t& weights)
+	{
+		piece_t next;
+		if (!board.GetSpawn(type, next) || !board.Fits(next))
+			return weights.topOut;
+
+		const auto placements = FindPlacements(board, next);
+		if (placements.empty())
+			return weights.topOut;
+
+		double best = -std::numeric_limits<double>::infinity();
+		for (const auto& placement : placements)
+		{
+			Board after = board;
+			const placeResult_t result = after.Place(placement);
+			best = std::max(best, Evaluate(after, result, weights));
+		}
+		return best;
+	}
+
+	bool ChoosePlacement(const Board& board, const piece_t& current, const std::vector<tetrominoType_t>& preview, const weights_t& weights, ThreadPool* pool, piece_t& target)
+	{
+		const auto placements = FindPlacements(board, current);
+		if (placements.empty())
+			return false;
+
+		const auto runAll = [pool](const size_t& count, const std::function<void(size_t)>& func)
+		{
+			if (pool != nullptr && pool->GetThreadCount() > 1)
+			{
+				pool->ParallelFor(count, func);
+			}
+			else
+			{
+				for (size_t i = 0; i < count; i++)
+					func(i);
+			}
+		};
+
+		// Every candidate gets scored on its own first.
+		std::vector<double> scores(placements.size());
+		runAll(placements.size(), [&](size_t i)
+			{
+				Board after = board;
+				const placeResult_t result = after.Place(placements[i]);
+				scores[i] = Evaluate(after, result, weights);
+			});
+
+		// Ties go to the first found, so the choice is the same however the scoring was split up.
+		std::vector<size_t> order(placements.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+
+		// Then the best few are scored again by what the preview piece could do after them.
+		if (!preview.empty())
+		{
+			order.resize(std::min<size_t>(order.size(), LookaheadWidth));
+			runAll(order.size(), [&](size_t i)
+				{
+					Board after = board;
+					const placeResult_t result = after.Place(placements[order[i]]);
+					scores[order[i]] = ScoreResult(result, weights) + ScoreNextPiece(after, preview.front(), weights);
+				});
+			std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+		}
+
+		const size_t best = order.front();
+		target = placements[best];
+		return true;
+	}
+
+	bool FindPath(const Board& board, const piece_t& current, const piece_t& target, path_t& path)
+	{
+		path.pieces.clear();
+		path.moves.clear();
+
+		const uint64_t targetKey = GetCellKey(target);
+
+		const Search search(board, current.type);
+		const auto nodes = search.FindPaths(current);
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			if (GetCellKey(search.Drop(nodes[i].piece)) != targetKey)
+				continue;
+
+			// Walk back to the start, then turn it around.
+			for (int step = static_cast<int>(i); step != -1; step = nodes[step].parent)
+			{
+				path.pieces.push_back(nodes[step].piece);
+				if (nodes[step].parent != -1)
+					path.moves.push_back(nodes[step].move);
+			}
+			std::reverse(path.pieces.begin(), path.pieces.end());
+			std::reverse(path.moves.begin(), path.moves.end());
+			return true;
+		}
+
+		return false;
+	}
+
+	playerInput_t NextInput(const Board& board, const piece_t& current, const piece_t& target)
+	{
+		path_t path;
+		if (!FindPath(board, current, target, path))
+			return playerInput_t::NONE;
+
+		return path.moves.empty() ? playerInput_t::HARD_DROP : path.moves.front();
+	}
+}
@@ -0,0 +1,50 @@
+#include "Bot/Zobrist.h"
+#include "Checksum.h"
+
+namespace Bot
+{
+	// SplitMix64, stepping its state on and putting it through the same finaliser the checksums use. Only used to fill the key tables,
+	// where any well mixed sequence that's the same everywhere will do.
+	static uint64_t NextKey(uint64_t& state)
+	{
+		return Checksum::Mix(state += 0x9E3779B97F4A7C15ull);
+	}
+
+	static zobristKeys_t GenerateKeys()
+	{
+		uint64_t state = 0x5350494E424C4B53ull;
+
+		zobristKeys_t keys;
+		for (auto& row : keys.cells)
+		{
+			for (auto& key : row)
+				key = NextKey(state);
+		}
+
+		for (auto& key : keys.orientations)
+			key = NextKey(state);
+
+		for (auto& position : keys.queue)
+		{
+			for (auto& key : position)
+				key = NextKey(state);
+		}
+
+		for (auto& type : keys.bag)
+		{
+			for (auto& key : type)
+				key = NextKey(state);
+		}
+
+		for (auto& key : keys.depths)
+			key = NextKey(state);
+
+		return keys;
+	}
+
+	const zobristKeys_t& GetZobristKeys()
+	{
+		static const zobristKeys_t keys = GenerateKeys();
+		return keys;
+	}
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "CachedTagLookup.h"
+#include "Components/Includes.h"
 
 entt::entity CachedTagLookup::Get(entt::registry& registry, const std::string& tag)
 {
@@ -25,6 +26,4 @@ entt::entity CachedTagLookup::Get(entt::registry& registry, const std::string& t
 	}
 
 	return ent;
-}
-
-CachedTagLookup cachedTagLookup;
\ No newline at end of file
+}
\ No newline at end of file
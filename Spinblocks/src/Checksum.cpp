@@ -0,0 +1,70 @@
+#include "Checksum.h"
+
+#include "GameContext.h"
+#include "Utility.h"
+#include "Components/Includes.h"
+
+#include <cstring>
+
+namespace Checksum
+{
+	// Timers are compared bit for bit, since a desync often shows up in them first.
+	static uint64_t ToBits(const double& value)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	uint64_t ComputeChecksum(entt::registry& registry)
+	{
+		const auto& context = GetGameContext(registry);
+
+		uint64_t hash = Combine(0, static_cast<uint64_t>(context.gameState));
+		hash = Combine(hash, static_cast<uint64_t>(context.gameScore));
+		hash = Combine(hash, static_cast<uint64_t>(context.gameLevel));
+		hash = Combine(hash, static_cast<uint64_t>(context.levelGoal));
+		hash = Combine(hash, static_cast<uint64_t>(context.linesClearedTotal));
+		hash = Combine(hash, context.piecesDealt);
+		hash = Combine(hash, static_cast<uint64_t>(context.pieceRandomizer));
+		hash = Combine(hash, ToBits(context.fallSpeed));
+		hash = Combine(hash, ToBits(context.lastFallUpdate));
+		hash = Combine(hash, ToBits(context.lastLockdownTime));
+		hash = Combine(hash, ToBits(context.lastBoardRotationTime));
+
+		// Straight to the containers Game::Setup made, with no tag lookups.
+		if (context.matrixEntity != entt::null)
+			hash = Combine(hash, registry.get<Components::Container>(context.matrixEntity).GetBlockHash());
+
+		if (context.playAreaEntity != entt::null)
+			hash = Combine(hash, static_cast<uint64_t>(registry.get<Components::CardinalDirection>(context.playAreaEntity).GetCurrentOrientation()));
+
+		if (context.bagAreaEntity != entt::null)
+		{
+			hash = Combine(hash, registry.get<Components::Bag>(context.bagAreaEntity).GetDealtHash());
+
+			const auto& previewQueue = registry.get<Components::PreviewQueue>(context.bagAreaEntity);
+			for (unsigned int i = 0; i < previewQueue.GetSize(); i++)
+				hash = Combine(hash, static_cast<uint64_t>(previewQueue.Peek(i)));
+		}
+
+		// The piece in play, or a marker for there being none. The last piece dealt is still in play until it loses its Controllable.
+		const entt::entity tetrominoEnt = context.activePiece;
+		const auto* controllable = registry.valid(tetrominoEnt) ? registry.try_get<Components::Controllable>(tetrominoEnt) : nullptr;
+		if (controllable != nullptr && controllable->IsEnabled() && IsEntityTetromino(registry, tetrominoEnt))
+		{
+			const auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
+			const auto& coordinate = registry.get<Components::Coordinate>(tetrominoEnt);
+			hash = Combine(hash, static_cast<uint64_t>(tetromino->GetType()));
+			hash = Combine(hash, static_cast<uint64_t>(tetromino->GetCurrentOrientation()));
+			hash = Combine(hash, (static_cast<uint64_t>(coordinate.Get().y) << 32) | coordinate.Get().x);
+			hash = Combine(hash, static_cast<uint64_t>(registry.get<Components::Moveable>(tetrominoEnt).GetMovementState()));
+		}
+		else
+		{
+			hash = Combine(hash, ~uint64_t(0));
+		}
+
+		return Mix(hash);
+	}
+}
\ No newline at end of file
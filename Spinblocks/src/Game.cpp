@@ -0,0 +1,290 @@
+#include "Game.h"
+#include "GameContext.h"
+#include "GameState.h"
+#include "Utility.h"
+#include "Checksum.h"
+
+#include "Systems/GenerationSystem.h"
+#include "Systems/FallingSystem.h"
+#include "Systems/MovementSystem.h"
+#include "Systems/StateChangeSystem.h"
+#include "Systems/PatternSystem.h"
+#include "Systems/EliminateSystem.h"
+#include "Systems/BoardRotateSystem.h"
+#include "Systems/DetachSystem.h"
+#include "Systems/CompletionSystem.h"
+#include "Systems/SoundSystem.h"
+#include "Systems/GhostSystem.h"
+
+#include <chrono>
+#include <vector>
+
+namespace Game
+{
+	// Runs one system, adding the time it took onto its total when the game is being profiled.
+	template<typename Func>
+	static auto RunSystem(gameContext_t& context, const gameSystem_t& system, Func&& func)
+	{
+		if (!context.profileSystems)
+			return func();
+
+		struct timer_t
+		{
+			double& total;
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			~timer_t()
+			{
+				total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+		} timer{ context.systemSeconds[static_cast<size_t>(system)] };
+
+		return func();
+	}
+
+	void Setup(entt::registry& registry)
+	{
+		auto& context = GetGameContext(registry);
+		context.gameScore = 0;
+		context.levelGoal = StartLevelGoal;
+		context.linesClearedTotal = 0;
+		context.piecesDealt = 0;
+
+		// The clock starts over with the game, along with everything timed from it.
+		context.tick = 0;
+		context.lastFallUpdate = 0.0;
+		context.lastLockdownTime = 0.0;
+		context.lastBoardRotationTime = 0.0;
+
+		// Nothing kept about the last game's entities carries over.
+		context.ghostCast = ghostCast_t();
+		context.activePiece = entt::null;
+		for (auto& parked : context.parkedBlocks)
+			parked.clear();
+
+		context.gameLevel = StartGameLevel;
+		context.fallSpeed = CalculateFallSpeed(context.gameLevel);
+
+		const auto playArea = registry.create();
+		registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
+		registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * PlayAreaWidth, cellHeight * PlayAreaHeight));
+		registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+		//registry.emplace<Components::Scale>(playArea);
+		//registry.emplace<Components::Container2>(playArea, glm::uvec2(10, 20), glm::vec2(25, 25));
+		registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+		registry.emplace<Components::Rotateable>(playArea, 0.0f, 0.0f);
+		registry.emplace<Components::Orientation>(playArea, 0.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+		registry.emplace<Components::InheritScalingFromParent>(playArea, false);
+		registry.emplace<Components::CardinalDirection>(playArea);
+
+		const auto matrix = registry.create();
+		//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
+		//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
+		registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (PlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (PlayAreaHeight + (BufferAreaDepth * 2))));
+		registry.emplace<Components::Position>(matrix);
+		registry.emplace<Components::Container>(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth * 2), PlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+		registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+		registry.emplace<Components::Orientation>(matrix);
+		registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+		//registry.emplace<Components::DeriveOrientationFromParent>(matrix, playArea);
+		registry.emplace<Components::InheritScalingFromParent>(matrix, false);
+
+		const auto bagArea = registry.create();
+		registry.emplace<Components::Renderable>(bagArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
+		registry.emplace<Components::Scale>(bagArea, glm::vec2(25 * 4, 25 * 16));
+		registry.emplace<Components::Position>(bagArea, glm::vec2(displayData.x - displayData.x / 11, displayData.y / 2));
+		registry.emplace<Components::Container>(bagArea, glm::uvec2(4, 16), glm::vec2(cellWidth, cellHeight));
+		registry.emplace<Components::Tag>(bagArea, GetTagFromContainerType(containerType_t::BAG_AREA));
+		registry.emplace<Components::Orientation>(bagArea);
+		//registry.emplace<Components::ReferenceEntity>(bagArea, playArea);
+		registry.emplace<Components::InheritScalingFromParent>(bagArea, false);
+		registry.emplace<Components::Bag>(bagArea, context.pieceRandomizer);
+		registry.emplace<Components::NodeOrder>(bagArea);
+		registry.emplace<Components::PreviewQueue>(bagArea, context.previewDepth);
+
+		context.matrixEntity = matrix;
+		context.playAreaEntity = playArea;
+		context.bagAreaEntity = bagArea;
+
+		BuildGrid(registry, matrix, false);
+		BuildGrid(registry, bagArea, false);
+
+		// Room for a block in every cell of the matrix and the bag, so the block pool never has to grow the registry during play.
+		const glm::uvec2 matrixDimensions = registry.get<Components::Container>(matrix).GetGridDimensions();
+		const glm::uvec2 bagDimensions = registry.get<Components::Container>(bagArea).GetGridDimensions();
+		ReserveBlockStorage(registry, matrixDimensions.x * matrixDimensions.y + bagDimensions.x * bagDimensions.y);
+
+		FillPauseCensors(registry, matrix, bagArea);
+
+		/*
+		// North
+		for (int i = BufferAreaDepth; i < PlayAreaWidth + BufferAreaDepth; i++)
+		{
+			PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 1", Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1))));
+		}*/
+
+		for (int i = BufferAreaDepth-1; i < PlayAreaWidth + BufferAreaDepth+1; i++)
+		{
+			//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 1", Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1) + 1)));
+			PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1) + 1)), true, { moveDirection_t::SOUTH, moveDirection_t::EAST, moveDirection_t::WEST });
+		}
+
+		/*
+		// South
+		for (int i = BufferAreaDepth; i < PlayAreaWidth + BufferAreaDepth; i++)
+		{
+			PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 2", Components::Coordinate(matrix, glm::uvec2(i, 0 + BufferAreaDepth)));
+		}*/
+
+		for (int i = BufferAreaDepth - 1; i < PlayAreaWidth + BufferAreaDepth + 1; i++)
+		{
+			//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 2", Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))));
+			PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))), true, { moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::WEST });
+		}
+
+		/*// West
+		for (int i = BufferAreaDepth; i < PlayAreaHeight + BufferAreaDepth; i++)
+		{
+			PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 3", Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1), i)));
+		}*/
+
+		for (int i = BufferAreaDepth - 1; i < PlayAreaHeight + BufferAreaDepth + 1; i++)
+		{
+			//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 3", Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1) + 1, i)));
+			PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1) + 1, i)), true, { moveDirection_t::NORTH, moveDirection_t::SOUTH, moveDirection_t::EAST });
+		}
+
+		/*
+		// East
+		for (int i = BufferAreaDepth; i < PlayAreaHeight + BufferAreaDepth; i++)
+		{
+			PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 4", Components::Coordinate(matrix, glm::uvec2(0 + BufferAreaDepth, i)));
+		}*/
+
+		for (int i = BufferAreaDepth - 1; i < PlayAreaHeight + BufferAreaDepth + 1; i++)
+		{
+			//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 4", Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), i)));
+			PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), i)), true, { moveDirection_t::NORTH, moveDirection_t::SOUTH, moveDirection_t::WEST });
+		}
+
+		UpdateDirectionalWalls(registry);
+
+		SpawnGhostBlocks(registry, matrix);
+
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::ITETROMINO, moveDirection_t::NORTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 0 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::SOUTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 2), 10 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::EAST);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 10 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::WEST);
+
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::OTETROMINO, moveDirection_t::NORTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 0 + (BufferAreaDepth - 2))), spawnType_t::OTETROMINO, moveDirection_t::SOUTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 2), 9 + BufferAreaDepth)), spawnType_t::OTETROMINO, moveDirection_t::EAST);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 9 + BufferAreaDepth)), spawnType_t::OTETROMINO, moveDirection_t::WEST);
+
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::NORTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(5 + BufferAreaDepth, 0 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::SOUTH);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), 10 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::EAST);
+		PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 10 + BufferAreaDepth)), spawnType_t::WIDTH3, moveDirection_t::WEST);
+
+		// Setup the nodes
+		auto& nodeOrder = registry.get<Components::NodeOrder>(bagArea);
+
+		nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 1))));
+		nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 5))));
+		nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 9))));
+		nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 13))));
+
+		LinkNodes(registry, nodeOrder, bagArea, matrix);
+	}
+
+	void Tick(entt::registry& registry)
+	{
+		if (GameState::GetState(registry) != gameState_t::PLAY)
+			return;
+
+		auto& context = GetGameContext(registry);
+		const double simulationTime = GetSimulationTime(context);
+
+		auto blockLockData = std::vector<BlockLockData>();
+		bool aPieceMoved = false;
+		statesChanged_t statesChanged;
+
+		RunSystem(context, gameSystem_t::GENERATION, [&] { Systems::GenerationSystem(registry, simulationTime); });
+		RunSystem(context, gameSystem_t::FALLING, [&] { Systems::FallingSystem(registry, simulationTime); });
+		aPieceMoved = RunSystem(context, gameSystem_t::MOVEMENT, [&] { return Systems::MovementSystem(registry, simulationTime); });
+		statesChanged = RunSystem(context, gameSystem_t::STATE_CHANGE, [&] { return Systems::StateChangeSystem(registry, simulationTime, blockLockData); });
+
+		const auto& playAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA));
+		if (playAreaEnt == entt::null)
+			throw std::runtime_error("Play Area entity is null!");
+		auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaEnt);
+
+		int lineLength = 0;
+		if (playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH)
+		{
+			lineLength = PlayAreaWidth;
+		}
+		else
+		{
+			lineLength = PlayAreaHeight;
+		}
+
+		int linesMatched = 0;
+
+		linesMatched = RunSystem(context, gameSystem_t::PATTERN, [&] { return Systems::PatternSystem(registry, lineLength, simulationTime); });
+		RunSystem(context, gameSystem_t::ELIMINATE, [&] { Systems::EliminateSystem(registry, simulationTime); });
+
+		rotationDirection_t shouldBoardRotate = ChooseBoardRotationDirection(registry, blockLockData, playAreaDirection.GetCurrentOrientation(), linesMatched);
+
+		if (RunSystem(context, gameSystem_t::BOARD_ROTATE, [&] { return Systems::BoardRotateSystem(registry, simulationTime, shouldBoardRotate); }) != rotationDirection_t::NONE)
+		{ // We did a rotation.
+			// Handle any elimination that should have happened.
+			// This ensures any falling realignment after an elimination occurs.
+			RunSystem(context, gameSystem_t::MOVEMENT, [&] { return Systems::MovementSystem(registry, simulationTime); });
+			RunSystem(context, gameSystem_t::STATE_CHANGE, [&] { return Systems::StateChangeSystem(registry, simulationTime, blockLockData); });
+			// Now detach, after the falling realignment.
+			RunSystem(context, gameSystem_t::DETACH, [&] { Systems::DetachSystem(registry, simulationTime); });
+		}
+#if !defined(DO_NOT_TEST) && !defined(HEADLESS)
+		RunSystem(context, gameSystem_t::SOUND, [&] { Systems::SoundSystem(registry, aPieceMoved, statesChanged, linesMatched); });
+#endif
+		RunSystem(context, gameSystem_t::COMPLETION, [&] { Systems::CompletionSystem(registry, simulationTime, linesMatched); });
+		RunSystem(context, gameSystem_t::GHOST, [&] { Systems::GhostSystem(registry, simulationTime); });
+
+		context.checksum = RunSystem(context, gameSystem_t::CHECKSUM, [&] { return Checksum::ComputeChecksum(registry); });
+		context.tick++;
+	}
+
+	const std::string GetNameOfSystem(const gameSystem_t& t)
+	{
+		switch (t)
+		{
+		case gameSystem_t::GENERATION:
+			return "GENERATION";
+		case gameSystem_t::FALLING:
+			return "FALLING";
+		case gameSystem_t::MOVEMENT:
+			return "MOVEMENT";
+		case gameSystem_t::STATE_CHANGE:
+			return "STATE_CHANGE";
+		case gameSystem_t::PATTERN:
+			return "PATTERN";
+		case gameSystem_t::ELIMINATE:
+			return "ELIMINATE";
+		case gameSystem_t::BOARD_ROTATE:
+			return "BOARD_ROTATE";
+		case gameSystem_t::DETACH:
+			return "DETACH";
+		case gameSystem_t::SOUND:
+			return "SOUND";
+		case gameSystem_t::COMPLETION:
+			return "COMPLETION";
+		case gameSystem_t::GHOST:
+			return "GHOST";
+		case gameSystem_t::CHECKSUM:
+			return "CHECKSUM";
+		default:
+			throw std::runtime_error("Unable to convert system to name!");
+		}
+	}
+}
\ No newline at end of file
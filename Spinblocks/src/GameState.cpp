@@ -1,11 +1,12 @@
 #include "GameState.h"
+#include "GameContext.h"
 
-void GameState::SetState(const gameState_t& state)
+void GameState::SetState(entt::registry& registry, const gameState_t& state)
 {
-	GameState::gameState = state;
+	GetGameContext(registry).gameState = state;
 }
 
-const gameState_t& GameState::GetState()
+const gameState_t& GameState::GetState(const entt::registry& registry)
 {
-	return GameState::gameState;
-}
+	return GetGameContext(registry).gameState;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "Input/BotInput.h"
+
+#include "Utility.h"
+#include "GameContext.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+// Moves that don't shift the piece this many inputs in a row give up on the path and drop where it is.
+static constexpr unsigned int StuckInputLimit = 8;
+
+BotInput::BotInput(const Bot::weights_t& weights, ThreadPool* pool, const unsigned int& inputInterval) : m_weights(weights), m_pool(pool), m_inputInterval(inputInterval)
+{
+	if (m_inputInterval == 0)
+		throw std::runtime_error("Input interval must be at least one tick!");
+}
+
+BotInput::BotInput(const Bot::expectimaxSettings_t& search, const Bot::weights_t& weights, ThreadPool* pool, const unsigned int& inputInterval) : BotInput(weights, pool, inputInterval)
+{
+	m_search = std::make_unique<Bot::Expectimax>(weights, search);
+}
+
+void BotInput::Plan(entt::registry& registry, const Bot::Board& board, const Bot::piece_t& piece)
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (m_search)
+	{
+		std::vector<tetrominoType_t> preview;
+		Bot::bagState_t bag;
+		Bot::ReadUpcoming(registry, m_search->GetSettings().previewShown, preview, bag);
+		m_hasTarget = m_search->Choose(board, piece, preview, bag, m_pool, m_target);
+	}
+	else
+	{
+		std::vector<tetrominoType_t> preview;
+		const auto bagAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA));
+		if (bagAreaEnt != entt::null && registry.all_of<Components::PreviewQueue>(bagAreaEnt))
+		{
+			const auto& previewQueue = registry.get<Components::PreviewQueue>(bagAreaEnt);
+			if (previewQueue.GetSize() > 0)
+				preview.push_back(previewQueue.Peek(0));
+		}
+
+		m_hasTarget = Bot::ChoosePlacement(board, piece, preview, m_weights, m_pool, m_target);
+	}
+
+	m_plans++;
+	m_planSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The next input along the path, finding a new one if the piece has left it.
+playerInput_t BotInput::FollowPath(entt::registry& registry, const Bot::piece_t& piece)
+{
+	if (m_hasPath)
+	{
+		for (size_t step = m_pathStep; step < m_path.pieces.size(); step++)
+		{
+			if (m_path.pieces[step] != piece)
+				continue;
+
+			m_pathStep = step;
+			return step < m_path.moves.size() ? m_path.moves[step] : playerInput_t::HARD_DROP;
+		}
+	}
+
+	const Bot::Board board = Bot::ReadBoard(registry, m_field);
+	m_hasPath = Bot::FindPath(board, piece, m_target, m_path);
+
+	// Somewhere along the way the target went out of reach. Pick again from here.
+	if (!m_hasPath)
+	{
+		Plan(registry, board, piece);
+		m_hasPath = m_hasTarget && Bot::FindPath(board, piece, m_target, m_path);
+		if (!m_hasPath)
+			return playerInput_t::HARD_DROP;
+	}
+
+	m_pathStep = 0;
+	return m_path.moves.empty() ? playerInput_t::HARD_DROP : m_path.moves.front();
+}
+
+playerInput_t BotInput::GetInput(entt::registry& registry, const unsigned int& tick)
+{
+	if (tick % m_inputInterval != 0)
+		return playerInput_t::NONE;
+
+	Bot::piece_t piece;
+	if (!Bot::ReadActivePiece(registry, piece))
+		return playerInput_t::NONE;
+
+	if (!m_hasField)
+	{
+		m_field = Bot::ReadField(registry);
+		m_hasField = true;
+	}
+
+	// A new piece to place. Entities get reused, so pieces are told apart by the count dealt.
+	const unsigned int pieceNumber = GetGameContext(registry).piecesDealt;
+	if (pieceNumber != m_pieceNumber)
+	{
+		m_pieceNumber = pieceNumber;
+		m_dropped = false;
+		m_hasPath = false;
+		m_stuckInputs = 0;
+		m_lastPiece = piece;
+		Plan(registry, Bot::ReadBoard(registry, m_field), piece);
+	}
+
+	// Dropped already, and just waiting on it to lock.
+	if (m_dropped)
+		return playerInput_t::NONE;
+
+	if (piece == m_lastPiece)
+		m_stuckInputs++;
+	else
+		m_stuckInputs = 0;
+	m_lastPiece = piece;
+
+	playerInput_t input = playerInput_t::HARD_DROP;
+	if (m_hasTarget && m_stuckInputs < StuckInputLimit)
+		input = FollowPath(registry, piece);
+
+	if (input == playerInput_t::HARD_DROP)
+		m_dropped = true;
+
+	return input;
+}
@@ -0,0 +1,38 @@
+#include "Input/InputSource.h"
+
+#include <stdexcept>
+
+ScriptedInput::ScriptedInput(const std::vector<playerInput_t>& script, const unsigned int& inputInterval) : m_script(script), m_inputInterval(inputInterval)
+{
+	if (m_script.empty())
+		throw std::runtime_error("Input script is empty!");
+
+	if (m_inputInterval == 0)
+		throw std::runtime_error("Input interval must be at least one tick!");
+}
+
+playerInput_t ScriptedInput::GetInput(entt::registry& registry, const unsigned int& tick)
+{
+	if (tick % m_inputInterval != 0)
+		return playerInput_t::NONE;
+
+	const playerInput_t input = m_script[m_next];
+	m_next = (m_next + 1) % m_script.size();
+	return input;
+}
+
+RandomInput::RandomInput(const uint32_t& seed, const unsigned int& inputInterval) : m_engine(seed), m_inputInterval(inputInterval)
+{
+	if (m_inputInterval == 0)
+		throw std::runtime_error("Input interval must be at least one tick!");
+}
+
+playerInput_t RandomInput::GetInput(entt::registry& registry, const unsigned int& tick)
+{
+	if (tick % m_inputInterval != 0)
+		return playerInput_t::NONE;
+
+	// Every input bar NONE. mt19937's output is the same everywhere, so the inputs are too.
+	const unsigned int inputCount = static_cast<unsigned int>(playerInput_t::ROTATE_CLOCKWISE);
+	return static_cast<playerInput_t>(1 + m_engine() % inputCount);
+}
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <filesystem>
 
 #include "Systems/SystemShared.h"
 
@@ -42,12 +43,15 @@
 #include "Systems/DetachSystem.h"
 #include "Systems/CompletionSystem.h"
 #include "Systems/SoundSystem.h"
+#include "Systems/GhostSystem.h"
 
 #include "Input/InputHandler.h"
 #include "Input/GameInput.h"
 #include "AudioManager.h"
 
 #include "GameState.h"
+#include "Game.h"
+#include "Replay.h"
 
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
@@ -91,36 +95,31 @@ Shader* RetrieveShader(const char* key, const char* vs, const char* fs)
 
 InputHandler input;
 
-void PlaceEdgeMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, entt::entity adjacentEntity, const moveDirection_t& dir)
+// Every game played is recorded to a file of its own in here. The first command line argument can name another directory.
+std::filesystem::path replayDirectory = ".";
+std::unique_ptr<Replay::Recorder> replayRecorder;
+
+// The first numbered replay file that isn't already there, so an earlier recording is never written over.
+std::string NextReplayPath()
 {
-	auto containerView = registry.view<Components::Container, Components::Tag>();
-	for (auto entity : containerView)
+	static unsigned int replayNumber = 0;
+	std::filesystem::path path;
+	do
 	{
-		auto& container2 = containerView.get<Components::Container>(entity);
-		auto& containerTag2 = containerView.get<Components::Tag>(entity);
-
-		if (container2.IsEnabled() && containerTag2.IsEnabled())
-		{
-			if (containerTag2.Get() != containerTag)
-				continue;
-
-			entt::entity cellEnt = GetCellAtCoordinates2(registry, markerCoordinate);
-
-			if (cellEnt == entt::null)
-				continue;
+		replayNumber++;
+		path = replayDirectory / ("replay-" + std::to_string(replayNumber) + ".sbr");
+	} while (std::filesystem::exists(path));
+	return path.string();
+}
 
-			const auto marker = registry.create();
-			registry.emplace<Components::CellLink>(marker, entity, adjacentEntity, dir);
-			registry.emplace<Components::Coordinate>(marker, markerCoordinate.GetParent(), markerCoordinate.Get());
-			registry.emplace<Components::Position>(marker);
-			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
-			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(marker, Components::renderLayer_t::RL_MARKER_UNDER, Model("./data/block/green.obj"));
-		}
-	}
+// Records an input the player's about to make, as applied before the next tick.
+void RecordInput(entt::registry& registry, const playerInput_t& playerInput)
+{
+	if (replayRecorder)
+		replayRecorder->Record(GetGameContext(registry).tick, playerInput);
 }
 
-entt::entity PlaceBagMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const Components::renderLayer_t& layer = Components::renderLayer_t::RL_MARKER_UNDER)
+void PlaceEdgeMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, entt::entity adjacentEntity, const moveDirection_t& dir)
 {
 	auto containerView = registry.view<Components::Container, Components::Tag>();
 	for (auto entity : containerView)
@@ -139,20 +138,14 @@ entt::entity PlaceBagMarker(entt::registry& registry, const std::string& contain
 				continue;
 
 			const auto marker = registry.create();
-			registry.emplace<Components::QueueNode>(marker, marker); // Don't attempt to link nodes at first
+			registry.emplace<Components::CellLink>(marker, entity, adjacentEntity, dir);
 			registry.emplace<Components::Coordinate>(marker, markerCoordinate.GetParent(), markerCoordinate.Get());
 			registry.emplace<Components::Position>(marker);
 			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
 			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(marker, layer, Model("./data/block/green.obj"));
-			registry.emplace<Components::Orientation>(marker);
-			registry.emplace<Components::ReferenceEntity>(marker, entity);
-
-			return marker;
+			registry.emplace<Components::Renderable>(marker, Components::renderLayer_t::RL_MARKER_UNDER, "./data/block/green.obj");
 		}
 	}
-
-	return entt::null;
 }
 
 void PlaceMarker(entt::registry& registry, const std::string& containerTag, const std::string& markerTag, const Components::Coordinate& markerCoordinate, const Components::renderLayer_t& layer = Components::renderLayer_t::RL_MARKER_UNDER, const entt::entity followedEnt = entt::null)
@@ -179,7 +172,7 @@ void PlaceMarker(entt::registry& registry, const std::string& containerTag, cons
 			registry.emplace<Components::Position>(marker);
 			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
 			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(marker, layer, Model("./data/block/red.obj"));
+			registry.emplace<Components::Renderable>(marker, layer, "./data/block/red.obj");
 			registry.emplace<Components::Tag>(marker, markerTag);
 			if (followedEnt != entt::null)
 			{
@@ -191,38 +184,6 @@ void PlaceMarker(entt::registry& registry, const std::string& containerTag, cons
 	}
 }
 
-void PlaceSpawnMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const spawnType_t& spawnType, const moveDirection_t& activeDirection, const Components::renderLayer_t& layer = Components::renderLayer_t::RL_MARKER_UNDER)
-{
-	auto containerView = registry.view<Components::Container, Components::Tag>();
-	for (auto entity : containerView)
-	{
-		auto& container2 = containerView.get<Components::Container>(entity);
-		auto& containerTag2 = containerView.get<Components::Tag>(entity);
-
-		if (container2.IsEnabled() && containerTag2.IsEnabled())
-		{
-			if (containerTag2.Get() != containerTag)
-				continue;
-
-			entt::entity cellEnt = GetCellAtCoordinates2(registry, markerCoordinate);
-
-			if (cellEnt == entt::null)
-				continue;
-
-			const auto marker = registry.create();
-			registry.emplace<Components::SpawnMarker>(marker, entity, spawnType);
-			registry.emplace<Components::Coordinate>(marker, markerCoordinate.GetParent(), markerCoordinate.Get());
-			registry.emplace<Components::Position>(marker);
-			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
-			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
-			//registry.emplace<Components::Renderable>(marker, layer, Model("./data/block/lightblue.obj"));
-			registry.emplace<Components::Orientation>(marker);
-			registry.emplace<Components::ReferenceEntity>(marker, entity);
-			registry.emplace<Components::DirectionallyActive>(marker, activeDirection);
-		}
-	}
-}
-
 void MoveTetromino(entt::registry& registry, const movePiece_t& movePiece)
 {
 	/*
@@ -324,10 +285,10 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 
 				if (GameHasBeenInitializedAtLeastOnce == true)
 				{
-					if (GameState::GetState() == gameState_t::PLAY)
-						GameState::SetState(gameState_t::MENU);
-					else if (GameState::GetState() == gameState_t::MENU)
-						GameState::SetState(gameState_t::PLAY);
+					if (GameState::GetState(registry) == gameState_t::PLAY)
+						GameState::SetState(registry, gameState_t::MENU);
+					else if (GameState::GetState(registry) == gameState_t::MENU)
+						GameState::SetState(registry, gameState_t::PLAY);
 				}
 
 				break;
@@ -338,7 +299,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -375,7 +336,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 					{
 						registry.remove_if_exists<Components::Controllable>(controllable);
 					}
-					GameState::SetState(gameState_t::GAME_OVER);
+					GameState::SetState(registry, gameState_t::GAME_OVER);
 				}
 
 				break;
@@ -385,7 +346,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -419,7 +380,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 					{
 						registry.remove_if_exists<Components::Controllable>(controllable);
 					}
-					GameState::SetState(gameState_t::GAME_OVER);
+					GameState::SetState(registry, gameState_t::GAME_OVER);
 				}
 
 				break;
@@ -429,7 +390,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -463,7 +424,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 					{
 						registry.remove_if_exists<Components::Controllable>(controllable);
 					}
-					GameState::SetState(gameState_t::GAME_OVER);
+					GameState::SetState(registry, gameState_t::GAME_OVER);
 				}
 				
 
@@ -493,7 +454,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				}
 				keyState.second.lastKeyDownRepeatTime = currentFrameTime;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -508,7 +469,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -523,7 +484,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -538,7 +499,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
@@ -578,9 +539,10 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				}
 				keyState.second.lastKeyDownRepeatTime = currentFrameTime;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
+				RecordInput(registry, playerInput_t::MOVE_LEFT);
 				MovePiece(registry, movePiece_t::MOVE_LEFT);
 				break;
 			}
@@ -599,9 +561,10 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				}
 				keyState.second.lastKeyDownRepeatTime = currentFrameTime;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
+				RecordInput(registry, playerInput_t::MOVE_RIGHT);
 				MovePiece(registry, movePiece_t::MOVE_RIGHT);
 				break;
 			}
@@ -629,12 +592,13 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				}
 				keyState.second.lastKeyDownRepeatTime = currentFrameTime;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
 					break;
 
+				RecordInput(registry, playerInput_t::SOFT_DROP);
 				MovePiece(registry, movePiece_t::SOFT_DROP);
 				break;
 			}
@@ -655,12 +619,13 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 					}
 				}
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
 					break;
 
+				RecordInput(registry, playerInput_t::HARD_DROP);
 				MovePiece(registry, movePiece_t::HARD_DROP);
 				break;
 			}
@@ -669,12 +634,13 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
 					break;
 
+				RecordInput(registry, playerInput_t::ROTATE_COUNTERCLOCKWISE);
 				RotatePiece(registry, rotatePiece_t::ROTATE_COUNTERCLOCKWISE);
 				break;
 			}
@@ -683,12 +649,13 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				if (isPaused.Get())
 					break;
 
+				RecordInput(registry, playerInput_t::ROTATE_CLOCKWISE);
 				RotatePiece(registry, rotatePiece_t::ROTATE_CLOCKWISE);
 				break;
 			}
@@ -697,7 +664,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 				if (keyState.second.prevKeyDown == true)
 					break;
 
-				if (GameState::GetState() != gameState_t::PLAY)
+				if (GameState::GetState(registry) != gameState_t::PLAY)
 					break;
 
 				auto& paused = registry.get<Components::Flag>(pauseEnt);
@@ -749,7 +716,7 @@ void processinput(GLFWwindow* window, entt::registry& registry, double currentFr
 
 void preupdate(entt::registry& registry, double currentFrameTime)
 {
-	if (GameState::GetState() != gameState_t::PLAY)
+	if (GameState::GetState(registry) != gameState_t::PLAY)
 		return;
 
 	auto cardinalDirectionView = registry.view<Components::CardinalDirection, Components::Orientation>();
@@ -768,60 +735,19 @@ void preupdate(entt::registry& registry, double currentFrameTime)
 	}
 }
 
-void update(entt::registry& registry, double currentFrameTime)
+void update(entt::registry& registry)
 {
-	if (GameState::GetState() != gameState_t::PLAY)
+	if (GameState::GetState(registry) != gameState_t::PLAY)
 		return;
 
-	// Views get created when queried. It exposes internal data structures of the registry to itself.
-	// Views are cheap to make/destroy.
-	// Views are meant to be temporary; don't store them after
-
-	auto blockLockData = std::vector<BlockLockData>();
-	bool aPieceMoved = false;
-	statesChanged_t statesChanged;
-
-	Systems::GenerationSystem(registry, currentFrameTime);
-	Systems::FallingSystem(registry, currentFrameTime);
-	aPieceMoved = Systems::MovementSystem(registry, currentFrameTime);
-	statesChanged = Systems::StateChangeSystem(registry, currentFrameTime, blockLockData);
-
+	Game::Tick(registry);
 
-	const auto& playAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA));
-	if (playAreaEnt == entt::null)
-		throw std::runtime_error("Play Area entity is null!");
-	auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaEnt);
-
-	int lineLength = 0;
-	if(playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH)
-	{
-		lineLength = PlayAreaWidth;
-	}
-	else
+	if (replayRecorder)
 	{
-		lineLength = PlayAreaHeight;
+		const auto& context = GetGameContext(registry);
+		replayRecorder->RecordChecksum(context.tick, context.checksum);
 	}
 
-	int linesMatched = 0;
-
-	linesMatched = Systems::PatternSystem(registry, lineLength, currentFrameTime);
-	Systems::EliminateSystem(registry, currentFrameTime);
-
-	rotationDirection_t shouldBoardRotate = ChooseBoardRotationDirection(registry, blockLockData, playAreaDirection.GetCurrentOrientation(), linesMatched);
-
-	if (Systems::BoardRotateSystem(registry, currentFrameTime, shouldBoardRotate) != rotationDirection_t::NONE)
-	{ // We did a rotation.
-		// Handle any elimination that should have happened.
-		// This ensures any falling realignment after an elimination occurs.
-		Systems::MovementSystem(registry, currentFrameTime);
-		Systems::StateChangeSystem(registry, currentFrameTime, blockLockData);
-		// Now detach, after the falling realignment.
-		Systems::DetachSystem(registry, currentFrameTime);
-	}
-	Systems::SoundSystem(registry, aPieceMoved, statesChanged, linesMatched);
-	Systems::CompletionSystem(registry, currentFrameTime, linesMatched);
-
-
 	/*auto containerView = registry.view<Components::Container, Components::Scale>();
 	for (auto entity : containerView)
 	{
@@ -837,7 +763,7 @@ void update(entt::registry& registry, double currentFrameTime)
 }
 void postupdate(entt::registry& registry, double currentFrameTime)
 {
-	if (GameState::GetState() != gameState_t::PLAY)
+	if (GameState::GetState(registry) != gameState_t::PLAY)
 		return;
 }
 
@@ -962,7 +888,7 @@ void prerender(entt::registry& registry, double normalizedTime)
 			}
 			// The line below likes to trigger crashes. Probably something above shouldn't be a reference.
 			Components::Position parentPosition = registry.get<Components::Position>(deriveCoordinatesFrom); // this is a 0 vector in Matrix:Grid:0-0, 700,300 in BagArea:Grid:0-0 // Also 0 vector with blocks.
-			Components::Container container2 = registry.get<Components::Container>(deriveCoordinatesFrom);
+			const auto& container2 = registry.get<Components::Container>(deriveCoordinatesFrom); // A reference, the container carries its cell index around with it.
 
 			// Review GetCellPosition3() later. What should it be in reference to? Parent entity? Matrix? Parent coordinates? FIXME TODO
 			//position.Set(container2.GetCellPosition3(parentPosition.Get(), coordinates.Get()) + derivePositionFromCoordinates.GetOffset());
@@ -1023,40 +949,33 @@ void render(entt::registry& registry, double normalizedTime)
 		}
 	}
 
-	if (GameState::GetState() != gameState_t::PLAY)
+	if (GameState::GetState(registry) != gameState_t::PLAY)
 		return;
 
-	auto renderView = registry.view<Components::Renderable, Components::Position, Components::Orientation, Components::Scale>();
-	for (int i = Components::renderLayer_t::RL_MIN+1; i < Components::renderLayer_t::RL_MAX; i++)
+	// One pass over the render group, which is already in layer order.
+	SortRenderGroup(registry);
+
+	auto renderGroup = GetRenderGroup(registry);
+	for (auto entity : renderGroup)
 	{
-		for (auto entity : renderView)
-		{
-			auto& render = renderView.get<Components::Renderable>(entity);
-			
-			if (render.GetLayer() != i)
-				continue;
+		auto& render = renderGroup.get<Components::Renderable>(entity);
 
-			// We grab these after checking the renderlayer as a simplistic optimization. May not even be relevant, hasn't been benchmarked..
-			auto& position = renderView.get<Components::Position>(entity);
-			auto& orientation = renderView.get<Components::Orientation>(entity);
-			auto& scale = renderView.get<Components::Scale>(entity);
+		if (render.GetLayer() <= Components::renderLayer_t::RL_MIN || render.GetLayer() >= Components::renderLayer_t::RL_MAX)
+			continue;
 
-			if (render.IsEnabled() && position.IsEnabled() && orientation.IsEnabled() && scale.IsEnabled())
-			{
-				bool inheritScaling = false;
-				if (registry.all_of<Components::InheritScalingFromParent>(entity))
-				{
-					auto& inheritScalingFromParent = registry.get<Components::InheritScalingFromParent>(entity);
-					inheritScaling = inheritScalingFromParent.Get();
-				}
-				
-				shader->setMat4("model", GetModelMatrixOfEntity(registry, entity, inheritScaling));
-				render.Draw(*shader);
-			}
+		auto& position = renderGroup.get<Components::Position>(entity);
+		auto& orientation = renderGroup.get<Components::Orientation>(entity);
+		auto& scale = renderGroup.get<Components::Scale>(entity);
+
+		if (render.IsEnabled() && position.IsEnabled() && orientation.IsEnabled() && scale.IsEnabled())
+		{
+			// The top level entity always gets its own scale. Inherited scaling only matters for its parents, and GetModelMatrixOfEntity looks that up itself.
+			shader->setMat4("model", GetModelMatrixOfEntity(registry, entity, false));
+			render.Draw(*shader);
 		}
 	}
 
-	if (GameState::GetState() != gameState_t::MENU)
+	if (GameState::GetState(registry) != gameState_t::MENU)
 	{
 		ImGUIFrameInit();
 
@@ -1077,17 +996,17 @@ void render(entt::registry& registry, double normalizedTime)
 					if (registry.all_of<Components::UITextScore>(entity))
 					{
 						auto& score = registry.get<Components::UITextScore>(entity);
-						score.DisplayElement();
+						score.DisplayElement(registry);
 					}
 					if (registry.all_of<Components::UITextLevel>(entity))
 					{
 						auto& level = registry.get<Components::UITextLevel>(entity);
-						level.DisplayElement();
+						level.DisplayElement(registry);
 					}
 					if (registry.all_of<Components::UIText>(entity))
 					{
 						auto& pause = registry.get<Components::UIText>(entity);
-						pause.DisplayElement();
+						pause.DisplayElement(registry);
 					}
 				}
 
@@ -1103,121 +1022,6 @@ void postrender(entt::registry& registry, double normalizedTime)
 
 }
 
-glm::ivec2 GetConnectionLine(const glm::uvec2& dimensions, const moveDirection_t& direction)
-{
-	switch (direction)
-	{
-	case moveDirection_t::EAST:
-		return glm::ivec2(dimensions.x, -1);
-	case moveDirection_t::NORTH:
-		return glm::ivec2(-1, dimensions.y);
-	case moveDirection_t::SOUTH:
-		return glm::ivec2(-1, 0);
-	case moveDirection_t::WEST:
-		return glm::ivec2(0, -1);
-	}
-
-	throw std::runtime_error("GetConnectionLine(): This should never be reached. Direction not handled.");
-}
-
-glm::ivec2 CombineLineCoordinates(const glm::ivec2& line, const glm::uvec2& coords)
-{
-	glm::ivec2 combined;
-
-	if (line.x == -1)
-	{
-		combined.x = coords.x;
-		combined.y = line.y;
-	}
-	else if (line.y == -1)
-	{
-		combined.x = line.x;
-		combined.y = coords.y;
-	}
-
-	return combined;
-}
-
-void ConnectGrids2(entt::registry& registry, entt::entity lhs, moveDirection_t lhsConnectDir, entt::entity rhs, moveDirection_t rhsConnectDir)
-{
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(0, 19)), Components::Coordinate(rhs, glm::uvec2(0, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(1, 19)), Components::Coordinate(rhs, glm::uvec2(1, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(2, 19)), Components::Coordinate(rhs, glm::uvec2(2, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(3, 19)), Components::Coordinate(rhs, glm::uvec2(3, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(4, 19)), Components::Coordinate(rhs, glm::uvec2(4, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(5, 19)), Components::Coordinate(rhs, glm::uvec2(5, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(6, 19)), Components::Coordinate(rhs, glm::uvec2(6, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(7, 19)), Components::Coordinate(rhs, glm::uvec2(7, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(8, 19)), Components::Coordinate(rhs, glm::uvec2(8, 0)), lhsConnectDir, rhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(lhs, glm::uvec2(9, 19)), Components::Coordinate(rhs, glm::uvec2(9, 0)), lhsConnectDir, rhsConnectDir);
-
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(0, 0)), Components::Coordinate(lhs, glm::uvec2(0, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(1, 0)), Components::Coordinate(lhs, glm::uvec2(1, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(2, 0)), Components::Coordinate(lhs, glm::uvec2(2, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(3, 0)), Components::Coordinate(lhs, glm::uvec2(3, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(4, 0)), Components::Coordinate(lhs, glm::uvec2(4, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(5, 0)), Components::Coordinate(lhs, glm::uvec2(5, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(6, 0)), Components::Coordinate(lhs, glm::uvec2(6, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(7, 0)), Components::Coordinate(lhs, glm::uvec2(7, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(8, 0)), Components::Coordinate(lhs, glm::uvec2(8, 19)), rhsConnectDir, lhsConnectDir);
-	LinkCoordinates(registry, Components::Coordinate(rhs, glm::uvec2(9, 0)), Components::Coordinate(lhs, glm::uvec2(9, 19)), rhsConnectDir, lhsConnectDir);
-
-	
-}
-
-void ConnectGrids(entt::registry& registry, entt::entity lhs, moveDirection_t lhsConnectDir, entt::entity rhs, moveDirection_t rhsConnectDir)
-{
-	// LinkCoordinates(registry, Components::Coordinate(matrix, glm::uvec2(0, 19)), Components::Coordinate(northBuffer, glm::uvec2(0, 0)), moveDirection_t::NORTH, moveDirection_t::SOUTH);
-	// LinkCoordinates(registry, Components::Coordinate(northBuffer, glm::uvec2(0, 0)), Components::Coordinate(matrix, glm::uvec2(0, 19)), moveDirection_t::SOUTH, moveDirection_t::NORTH);
-	auto& lhsContainer = registry.get<Components::Container>(lhs);
-	auto& rhsContainer = registry.get<Components::Container>(rhs);
-
-	auto lhsDimensions = lhsContainer.GetGridDimensions();
-	auto rhsDimensions = rhsContainer.GetGridDimensions();
-
-	if (lhsDimensions != rhsDimensions)
-		throw std::runtime_error("Grid dimensions must be identical to be connected!");
-
-	glm::ivec2 lhsLine = GetConnectionLine(lhsDimensions, lhsConnectDir);
-	glm::ivec2 rhsLine = GetConnectionLine(rhsDimensions, rhsConnectDir);
-
-	auto lhsCellView = registry.view<Components::Cell, Components::Coordinate>();
-	auto rhsCellView = registry.view<Components::Cell, Components::Coordinate>();
-	for (auto lhsCellEnt : lhsCellView)
-	{
-		auto& lhsCell = lhsCellView.get<Components::Cell>(lhsCellEnt);
-		if (lhs != lhsCell.GetParent())
-			continue;
-
-		for (auto rhsCellEnt : rhsCellView)
-		{
-			if (lhsCellEnt == rhsCellEnt)
-				continue;
-
-			auto& rhsCell = rhsCellView.get<Components::Cell>(rhsCellEnt);
-			if (rhs != rhsCell.GetParent())
-				continue;
-
-			auto& lhsCellCoord = lhsCellView.get<Components::Coordinate>(lhsCellEnt);
-			auto& rhsCellCoord = rhsCellView.get<Components::Coordinate>(rhsCellEnt);
-
-			//if (lhsLine.x > -1 && lhsCellCoord.Get().x == rhsCellCoord.Get().x)
-
-
-			glm::uvec2 lhsCombined = CombineLineCoordinates(lhsLine, lhsCellCoord.Get());
-			glm::uvec2 rhsCombined = CombineLineCoordinates(rhsLine, rhsCellCoord.Get());
-
-			int q = 0;
-			q++;
-			// lhs 0,-1 / 1,-1
-			// rhs 2,-1
-			//if(lhsLine.x == lhsCellCoord.Get().x && lhsLine.y == lhsCellCoord.Get().y)
-
-			//if(lhsLine.x > -1 && lhsLine.x == lhsCellCoord.Get().x && rhsCellCoord.Get().x == 
-		}
-	}
-}
-
 void InitUI(entt::registry& registry)
 {
 	const auto scoreOverlay = registry.create();
@@ -1249,136 +1053,16 @@ void InitGame(entt::registry& registry)
 	GameInput::setVerticalAxis(0);
 	GameInput::setHorizontalAxis(0);
 
-	GameScore = 0;
-	LevelGoal = StartLevelGoal;
-	LinesClearedTotal = 0;
-
-	GameLevel = StartGameLevel;
-	FallSpeed = CalculateFallSpeed(GameLevel);
-
 	const auto camera = registry.create();
 	registry.emplace<Components::OrthographicCamera>(camera, glm::vec3(0.0f, 0.0f, 3.0f));
 	//registry.emplace<Components::PerspectiveCamera>(camera, glm::vec3(0.0f, 0.0f, 3.0f));
 
-	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
-	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * PlayAreaWidth, cellHeight * PlayAreaHeight));
-	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
-	//registry.emplace<Components::Scale>(playArea);
-	//registry.emplace<Components::Container2>(playArea, glm::uvec2(10, 20), glm::vec2(25, 25));
-	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
-	registry.emplace<Components::Rotateable>(playArea, 0.0f, 0.0f);
-	registry.emplace<Components::Orientation>(playArea, 0.0f, glm::vec3(0.0f, 0.0f, 1.0f));
-	registry.emplace<Components::InheritScalingFromParent>(playArea, false);
-	registry.emplace<Components::CardinalDirection>(playArea);
-
-	
-	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
-	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
-	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (PlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (PlayAreaHeight + (BufferAreaDepth * 2))));
-	registry.emplace<Components::Position>(matrix);
-	registry.emplace<Components::Container>(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth * 2), PlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
-	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
-	registry.emplace<Components::Orientation>(matrix);
-	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
-	//registry.emplace<Components::DeriveOrientationFromParent>(matrix, playArea);
-	registry.emplace<Components::InheritScalingFromParent>(matrix, false);
-	
-	const auto bagArea = registry.create();
-	registry.emplace<Components::Renderable>(bagArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
-	registry.emplace<Components::Scale>(bagArea, glm::vec2(25 * 4, 25 * 16));
-	registry.emplace<Components::Position>(bagArea, glm::vec2(displayData.x - displayData.x / 11, displayData.y / 2));
-	registry.emplace<Components::Container>(bagArea, glm::uvec2(4, 16), glm::vec2(cellWidth, cellHeight));
-	registry.emplace<Components::Tag>(bagArea, GetTagFromContainerType(containerType_t::BAG_AREA));
-	registry.emplace<Components::Orientation>(bagArea);
-	//registry.emplace<Components::ReferenceEntity>(bagArea, playArea);
-	registry.emplace<Components::InheritScalingFromParent>(bagArea, false);
-	registry.emplace<Components::Bag>(bagArea);
-	registry.emplace<Components::NodeOrder>(bagArea);
-
-	BuildGrid(registry, matrix);
-	BuildGrid(registry, bagArea);
-
-	FillPauseCensors(registry, matrix, bagArea);
-	
-	/*
-	// North
-	for (int i = BufferAreaDepth; i < PlayAreaWidth + BufferAreaDepth; i++)
-	{
-		PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 1", Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1))));
-	}*/
-
-	for (int i = BufferAreaDepth-1; i < PlayAreaWidth + BufferAreaDepth+1; i++)
-	{
-		//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 1", Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1) + 1)));
-		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, PlayAreaHeight + (BufferAreaDepth - 1) + 1)), true, { moveDirection_t::SOUTH, moveDirection_t::EAST, moveDirection_t::WEST });
-	}
-
-	/*
-	// South
-	for (int i = BufferAreaDepth; i < PlayAreaWidth + BufferAreaDepth; i++)
-	{
-		PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 2", Components::Coordinate(matrix, glm::uvec2(i, 0 + BufferAreaDepth)));
-	}*/
-	
-	for (int i = BufferAreaDepth - 1; i < PlayAreaWidth + BufferAreaDepth + 1; i++)
-	{
-		//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 2", Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))));
-		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))), true, { moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::WEST });
-	}
-	
-	/*// West
-	for (int i = BufferAreaDepth; i < PlayAreaHeight + BufferAreaDepth; i++)
-	{
-		PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 3", Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1), i)));
-	}*/
-
-	for (int i = BufferAreaDepth - 1; i < PlayAreaHeight + BufferAreaDepth + 1; i++)
-	{
-		//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 3", Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1) + 1, i)));
-		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth - 1) + 1, i)), true, { moveDirection_t::NORTH, moveDirection_t::SOUTH, moveDirection_t::EAST });
-	}
-	
-	/*
-	// East
-	for (int i = BufferAreaDepth; i < PlayAreaHeight + BufferAreaDepth; i++)
-	{
-		PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Matrix Edge 4", Components::Coordinate(matrix, glm::uvec2(0 + BufferAreaDepth, i)));
-	}*/
-
-	for (int i = BufferAreaDepth - 1; i < PlayAreaHeight + BufferAreaDepth + 1; i++)
-	{
-		//PlaceMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), "Border 4", Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), i)));
-		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), i)), true, { moveDirection_t::NORTH, moveDirection_t::SOUTH, moveDirection_t::WEST });
-	}
-
-	UpdateDirectionalWalls(registry);
-
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::ITETROMINO, moveDirection_t::NORTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 0 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::SOUTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 2), 10 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::EAST);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 10 + BufferAreaDepth)), spawnType_t::ITETROMINO, moveDirection_t::WEST);
-
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::OTETROMINO, moveDirection_t::NORTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 0 + (BufferAreaDepth - 2))), spawnType_t::OTETROMINO, moveDirection_t::SOUTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 2), 9 + BufferAreaDepth)), spawnType_t::OTETROMINO, moveDirection_t::EAST);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 9 + BufferAreaDepth)), spawnType_t::OTETROMINO, moveDirection_t::WEST);
-
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(4 + BufferAreaDepth, 21 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::NORTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(5 + BufferAreaDepth, 0 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::SOUTH);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + (BufferAreaDepth - 1), 10 + (BufferAreaDepth - 1))), spawnType_t::WIDTH3, moveDirection_t::EAST);
-	PlaceSpawnMarker(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(10 + BufferAreaDepth, 10 + BufferAreaDepth)), spawnType_t::WIDTH3, moveDirection_t::WEST);
-
-	// Setup the nodes
-	auto& nodeOrder = registry.get<Components::NodeOrder>(bagArea);
-
-	nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 1))));
-	nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 5))));
-	nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 9))));
-	nodeOrder.AddNode(PlaceBagMarker(registry, GetTagFromContainerType(containerType_t::BAG_AREA), Components::Coordinate(bagArea, glm::uvec2(1, 13))));
-
-	LinkNodes(registry, nodeOrder, bagArea, matrix);
+	Game::Setup(registry);
+	GetGameContext(registry).tickLength = GameTime::fixedDeltaTime;
+	// A checksum a second goes in with the inputs, so playback can tell when it's stopped matching.
+	Replay::header_t replayHeader = Replay::ReadHeader(registry);
+	replayHeader.checksumInterval = static_cast<unsigned int>(1.0 / GameTime::fixedDeltaTime + 0.5);
+	replayRecorder = std::make_unique<Replay::Recorder>(NextReplayPath(), replayHeader);
 
 	GameHasBeenInitializedAtLeastOnce = true;
 }
@@ -1388,12 +1072,21 @@ void TeardownGame(entt::registry& registry)
 	/*registry.each([&](auto entity) {
 		registry.destroy(entity);
 		});*/
+	if (replayRecorder)
+	{
+		replayRecorder->Finish(GetGameContext(registry).tick);
+		replayRecorder.reset();
+	}
+
 	registry.clear();
-	cachedTagLookup.Clear();
+	GetGameContext(registry).tagLookup.Clear();
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc > 1)
+		replayDirectory = argv[1];
+
 	if (!glfwInit())
 	{
 		// Initialization failed.
@@ -1467,9 +1160,10 @@ int main()
 	audioData_t audioDataMusic1 = audioManager.GetSound(audioAsset_t::MUSIC_GAMEPLAY1, audioChannel_t::MUSIC, true, true);
 	audioData_t audioDataMusic2 = audioManager.GetSound(audioAsset_t::MUSIC_GAMEPLAY2, audioChannel_t::MUSIC, true, true);
 	
-	GameState::SetState(gameState_t::INIT);
-
 	entt::registry registry;
+	GetGameContext(registry).audioManager = &audioManager;
+	GameState::SetState(registry, gameState_t::INIT);
+	TrackRenderOrder(registry);
 
 	glfwSwapInterval(1);
 	//glEnable(GL_DEPTH_TEST);
@@ -1511,7 +1205,7 @@ int main()
 		float musicVol = audioManager.GetChannelVolume(audioChannel_t::MUSIC);
 		float soundVol = audioManager.GetChannelVolume(audioChannel_t::SOUND);
 
-		if (GameState::GetState() == gameState_t::INIT)
+		if (GameState::GetState(registry) == gameState_t::INIT)
 		{
 			InitUI(registry);
 			//InitGame(registry);
@@ -1521,9 +1215,9 @@ int main()
 				std::this_thread::sleep_for(std::chrono::milliseconds(50));
 				// Do nothing, wait.
 			}
-			GameState::SetState(gameState_t::MENU);
+			GameState::SetState(registry, gameState_t::MENU);
 		}
-		else if (GameState::GetState() == gameState_t::MENU)
+		else if (GameState::GetState(registry) == gameState_t::MENU)
 		{
 			ImGUIFrameInit();
 
@@ -1534,7 +1228,7 @@ int main()
 				{
 					if (ImGui::Button("Continue"))
 					{
-						GameState::SetState(gameState_t::PLAY);
+						GameState::SetState(registry, gameState_t::PLAY);
 					}
 				}
 				if (GameHasBeenInitializedAtLeastOnce == true)
@@ -1542,7 +1236,7 @@ int main()
 					if (ImGui::Button("Restart"))
 					{
 						TeardownGame(registry);
-						GameState::SetState(gameState_t::INIT);
+						GameState::SetState(registry, gameState_t::INIT);
 						InitUI(registry); // Re-init UI stuff too, as this has also been cleared by the teardown.
 
 						InitGame(registry);
@@ -1552,7 +1246,7 @@ int main()
 							// Do nothing, wait.
 						}
 
-						GameState::SetState(gameState_t::PLAY);
+						GameState::SetState(registry, gameState_t::PLAY);
 					}
 				}
 				else
@@ -1566,7 +1260,7 @@ int main()
 							// Do nothing, wait.
 						}
 
-						GameState::SetState(gameState_t::PLAY);
+						GameState::SetState(registry, gameState_t::PLAY);
 					}
 				}
 
@@ -1694,23 +1388,23 @@ int main()
 		audioManager.SetChannelVolume(audioChannel_t::MUSIC, musicVol);
 		audioManager.SetChannelVolume(audioChannel_t::SOUND, soundVol);
 		
-		if (GameState::GetState() == gameState_t::PLAY || GameState::GetState() == gameState_t::MENU)
+		if (GameState::GetState(registry) == gameState_t::PLAY || GameState::GetState(registry) == gameState_t::MENU)
 		{
 			processinput(window, registry, currentFrameTime);
 		}
 
 		while (GameTime::accumulator >= GameTime::fixedDeltaTime)
 		{
-			if (GameState::GetState() == gameState_t::PLAY)
+			if (GameState::GetState(registry) == gameState_t::PLAY)
 			{
 				const auto& pauseEnt = FindEntityByTag(registry, "Pause Overlay");
 				auto& isPaused = registry.get<Components::Flag>(pauseEnt);
 
 				if (!isPaused.Get())
 				{
-					// Update game logic for ECS
+					// Update game logic for ECS. The game keeps its own clock, a fixed step per update, so the frame rate never changes how it plays.
 					preupdate(registry, currentFrameTime);
-					update(registry, currentFrameTime);
+					update(registry);
 					postupdate(registry, currentFrameTime);
 				}
 
@@ -1724,13 +1418,13 @@ int main()
 		render(registry, GameTime::accumulator / GameTime::fixedDeltaTime);
 		postrender(registry, GameTime::accumulator / GameTime::fixedDeltaTime);
 
-		if (GameState::GetState() == gameState_t::GAME_OVER)
+		if (GameState::GetState(registry) == gameState_t::GAME_OVER)
 		{
 			audioData_t audioGameOver = audioManager.GetSound(audioAsset_t::SOUND_GAME_OVER, audioChannel_t::SOUND, false, true);
 			audioManager.PlaySound(audioGameOver);
 
 			TeardownGame(registry);
-			GameState::SetState(gameState_t::INIT);
+			GameState::SetState(registry, gameState_t::INIT);
 		}
 
 		glfwSwapBuffers(window);
@@ -0,0 +1,176 @@
+#include "Randomizer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Randomizers
+{
+	static constexpr unsigned int TypeCount = 7;
+
+	// Uniform in [0, bound), straight off the engine's output. Rejecting the low end of the range removes the modulo bias.
+	static uint32_t RandomBelow(std::mt19937& engine, const uint32_t& bound)
+	{
+		const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+		for (;;)
+		{
+			const uint32_t value = static_cast<uint32_t>(engine());
+			if (value >= threshold)
+				return value % bound;
+		}
+	}
+
+	void Randomizer::Generate(tetrominoType_t* pieces, const size_t& count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			pieces[i] = Next();
+		}
+	}
+
+	bool Randomizer::GetBagContents(std::array<unsigned int, 7>&, unsigned int&) const
+	{
+		return false;
+	}
+
+	BagRandomizer::BagRandomizer(const unsigned int& bagCopies, const uint32_t& seed) : m_bagSize(bagCopies * TypeCount), m_next(0)
+	{
+		if (bagCopies == 0 || bagCopies > MaximumCopies)
+			throw std::runtime_error("Unsupported number of bag copies!");
+
+		Seed(seed);
+	}
+
+	void BagRandomizer::Seed(const uint32_t& seed)
+	{
+		m_engine.seed(seed);
+		m_next = m_bagSize;
+	}
+
+	std::unique_ptr<Randomizer> BagRandomizer::Clone() const
+	{
+		return std::make_unique<BagRandomizer>(*this);
+	}
+
+	void BagRandomizer::Refill()
+	{
+		for (unsigned int i = 0; i < m_bagSize; i++)
+		{
+			m_bag[i] = static_cast<tetrominoType_t>(i % TypeCount);
+		}
+
+		// Fisher-Yates
+		for (unsigned int i = m_bagSize - 1; i > 0; i--)
+		{
+			std::swap(m_bag[i], m_bag[RandomBelow(m_engine, i + 1)]);
+		}
+
+		m_next = 0;
+	}
+
+	tetrominoType_t BagRandomizer::Next()
+	{
+		if (m_next >= m_bagSize)
+			Refill();
+
+		return m_bag[m_next++];
+	}
+
+	void BagRandomizer::Generate(tetrominoType_t* pieces, const size_t& count)
+	{
+		// Whole runs of the current bag at a time.
+		size_t written = 0;
+		while (written < count)
+		{
+			if (m_next >= m_bagSize)
+				Refill();
+
+			const size_t run = std::min<size_t>(count - written, m_bagSize - m_next);
+			std::copy(m_bag.begin() + m_next, m_bag.begin() + m_next + run, pieces + written);
+			m_next += static_cast<unsigned int>(run);
+			written += run;
+		}
+	}
+
+	bool BagRandomizer::GetBagContents(std::array<unsigned int, 7>& remaining, unsigned int& copies) const
+	{
+		remaining.fill(0);
+		for (unsigned int i = m_next; i < m_bagSize; i++)
+		{
+			remaining[static_cast<int>(m_bag[i])]++;
+		}
+
+		copies = m_bagSize / TypeCount;
+		return true;
+	}
+
+	HistoryRandomizer::HistoryRandomizer(const unsigned int& rollCount, const uint32_t& seed) : m_rollCount(rollCount)
+	{
+		if (rollCount == 0)
+			throw std::runtime_error("A history randomizer needs at least one roll!");
+
+		Seed(seed);
+	}
+
+	void HistoryRandomizer::Seed(const uint32_t& seed)
+	{
+		m_engine.seed(seed);
+		m_history.fill(tetrominoType_t::Z);
+		m_historyHead = 0;
+		m_first = true;
+	}
+
+	std::unique_ptr<Randomizer> HistoryRandomizer::Clone() const
+	{
+		return std::make_unique<HistoryRandomizer>(*this);
+	}
+
+	bool HistoryRandomizer::IsInHistory(const tetrominoType_t& tetrominoType) const
+	{
+		return std::find(m_history.begin(), m_history.end(), tetrominoType) != m_history.end();
+	}
+
+	tetrominoType_t HistoryRandomizer::Next()
+	{
+		tetrominoType_t piece = tetrominoType_t::Z;
+		if (m_first)
+		{
+			static constexpr tetrominoType_t firstPieces[] = { tetrominoType_t::I, tetrominoType_t::J, tetrominoType_t::L, tetrominoType_t::T };
+			piece = firstPieces[RandomBelow(m_engine, 4)];
+			m_first = false;
+		}
+		else
+		{
+			// Out of rolls, the last one stands even if it's a repeat.
+			for (unsigned int roll = 0; roll < m_rollCount; roll++)
+			{
+				piece = static_cast<tetrominoType_t>(RandomBelow(m_engine, TypeCount));
+				if (!IsInHistory(piece))
+					break;
+			}
+		}
+
+		m_history[m_historyHead] = piece;
+		m_historyHead = (m_historyHead + 1) % m_history.size();
+		return piece;
+	}
+
+	std::unique_ptr<Randomizer> CreateRandomizer(const randomizerType_t& randomizerType, const uint32_t& seed)
+	{
+		switch (randomizerType)
+		{
+		case randomizerType_t::SEVEN_BAG:
+			return std::make_unique<BagRandomizer>(1, seed);
+		case randomizerType_t::FOURTEEN_BAG:
+			return std::make_unique<BagRandomizer>(2, seed);
+		case randomizerType_t::TGM_HISTORY:
+			return std::make_unique<HistoryRandomizer>(4, seed);
+		default:
+			throw std::runtime_error("Invalid randomizerType_t!");
+		}
+	}
+
+	uint32_t GenerateSeed()
+	{
+		return static_cast<uint32_t>((std::random_device())());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,464 @@
+#include "Replay.h"
+
+#include "Game.h"
+#include "GameContext.h"
+#include "GameState.h"
+#include "Utility.h"
+#include "Components/Includes.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Replay
+{
+	static const char Magic[4] = { 'S', 'B', 'R', 'P' };
+	static constexpr uint8_t Version = 2; // Version 1 had no checksums.
+	static constexpr uint8_t ChecksumCode = 0; // Where playerInput_t::NONE would be, which is never recorded.
+	static constexpr uint8_t EndCode = 7; // Past the last playerInput_t, which all fit in the 3 bits.
+	static constexpr uint64_t LongDelta = 31; // A delta field holding this has the rest of the delta in a varint after it.
+	static constexpr uint64_t FlushInterval = 300; // Most ticks between writing events out to disk, when checksums don't do it sooner.
+
+	static void WriteVarint(std::ostream& stream, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			stream.put(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		stream.put(static_cast<char>(value));
+	}
+
+	static void WriteWord(std::ostream& stream, const uint64_t& value)
+	{
+		for (unsigned int i = 0; i < 8; i++)
+			stream.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+
+	// False if the stream ran out partway through.
+	static bool ReadWord(std::istream& stream, uint64_t& value)
+	{
+		value = 0;
+		for (unsigned int i = 0; i < 8; i++)
+		{
+			const int byte = stream.get();
+			if (byte == EOF)
+				return false;
+			value |= static_cast<uint64_t>(byte) << (i * 8);
+		}
+		return true;
+	}
+
+	// False if the stream ran out partway through.
+	static bool ReadVarint(std::istream& stream, uint64_t& value)
+	{
+		value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			const int byte = stream.get();
+			if (byte == EOF)
+				return false;
+
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+
+		throw std::runtime_error("Replay varint is too long!");
+	}
+
+	header_t ReadHeader(entt::registry& registry)
+	{
+		const auto& context = GetGameContext(registry);
+
+		header_t header;
+		header.pieceRandomizer = context.pieceRandomizer;
+		header.previewDepth = context.previewDepth;
+		header.tickLength = context.tickLength;
+
+		const auto bagAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA));
+		if (bagAreaEnt == entt::null)
+			throw std::runtime_error("Bag Area entity is null!");
+		header.seed = registry.get<Components::Bag>(bagAreaEnt).GetSeed();
+
+		return header;
+	}
+
+	void StartGame(entt::registry& registry, const header_t& header)
+	{
+		auto& context = GetGameContext(registry);
+		context.pieceRandomizer = header.pieceRandomizer;
+		context.previewDepth = header.previewDepth;
+
+		Game::Setup(registry);
+		context.tickLength = header.tickLength;
+
+		const auto bagAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA));
+		if (bagAreaEnt == entt::null)
+			throw std::runtime_error("Bag Area entity is null!");
+		registry.get<Components::Bag>(bagAreaEnt).Seed(header.seed);
+
+		GameState::SetState(registry, gameState_t::PLAY);
+	}
+
+	Recorder::Recorder(const std::string& path, const header_t& header) : m_stream(path, std::ios::binary | std::ios::trunc), m_checksumInterval(header.checksumInterval)
+	{
+		if (!m_stream)
+			throw std::runtime_error("Couldn't open " + path + " to record to!");
+
+		m_stream.write(Magic, sizeof(Magic));
+		m_stream.put(static_cast<char>(Version));
+		WriteVarint(m_stream, header.seed);
+		m_stream.put(static_cast<char>(header.pieceRandomizer));
+		WriteVarint(m_stream, header.previewDepth);
+
+		uint64_t tickLengthBits;
+		std::memcpy(&tickLengthBits, &header.tickLength, sizeof(tickLengthBits));
+		WriteWord(m_stream, tickLengthBits);
+		WriteVarint(m_stream, header.checksumInterval);
+	}
+
+	Recorder::~Recorder()
+	{
+		try
+		{
+			Finish(m_recorded ? m_lastTick + 1 : 0);
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void Recorder::WriteEvent(const uint64_t& tick, const uint8_t& code)
+	{
+		if (tick < m_lastTick)
+			throw std::runtime_error("Replay events have to be recorded in tick order!");
+
+		const uint64_t delta = tick - m_lastTick;
+		m_stream.put(static_cast<char>(code | (std::min(delta, LongDelta) << 3)));
+		if (delta >= LongDelta)
+			WriteVarint(m_stream, delta - LongDelta);
+
+		m_lastTick = tick;
+		m_unflushed = true;
+	}
+
+	void Recorder::Flush(const uint64_t& tick)
+	{
+		if (m_unflushed)
+			m_stream.flush();
+
+		m_unflushed = false;
+		m_lastFlushTick = tick;
+	}
+
+	void Recorder::Record(const uint64_t& tick, const playerInput_t& input)
+	{
+		if (m_finished)
+			throw std::runtime_error("Replay has already been finished!");
+
+		if (input != playerInput_t::NONE)
+		{
+			WriteEvent(tick, static_cast<uint8_t>(input));
+			m_recorded = true;
+		}
+
+		if (tick >= m_lastFlushTick + FlushInterval)
+			Flush(tick);
+	}
+
+	void Recorder::RecordChecksum(const uint64_t& tick, const uint64_t& checksum)
+	{
+		if (m_finished)
+			throw std::runtime_error("Replay has already been finished!");
+
+		if (m_checksumInterval == 0 || tick % m_checksumInterval != 0)
+			return;
+
+		WriteEvent(tick, ChecksumCode);
+		WriteWord(m_stream, checksum);
+		Flush(tick);
+	}
+
+	void Recorder::Finish(const uint64_t& tickCount)
+	{
+		if (m_finished)
+			return;
+
+		m_finished = true;
+		WriteEvent(tickCount, EndCode);
+		Flush(tickCount);
+	}
+
+	recording_t Load(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream)
+			throw std::runtime_error("Couldn't open replay " + path + "!");
+
+		char magic[sizeof(Magic)];
+		if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0)
+			throw std::runtime_error(path + " isn't a replay!");
+
+		const int version = stream.get();
+		if (version < 1 || version > Version)
+			throw std::runtime_error("Unsupported replay version!");
+
+		recording_t recording;
+		uint64_t value;
+		if (!ReadVarint(stream, value))
+			throw std::runtime_error("Replay header is cut short!");
+		recording.header.seed = static_cast<uint32_t>(value);
+
+		const int randomizer = stream.get();
+		if (randomizer < 0 || randomizer > static_cast<int>(randomizerType_t::TGM_HISTORY))
+			throw std::runtime_error("Unknown replay piece randomizer!");
+		recording.header.pieceRandomizer = static_cast<randomizerType_t>(randomizer);
+
+		if (!ReadVarint(stream, value))
+			throw std::runtime_error("Replay header is cut short!");
+		recording.header.previewDepth = static_cast<unsigned int>(value);
+
+		uint64_t tickLengthBits;
+		if (!ReadWord(stream, tickLengthBits))
+			throw std::runtime_error("Replay header is cut short!");
+		std::memcpy(&recording.header.tickLength, &tickLengthBits, sizeof(tickLengthBits));
+
+		if (version >= 2)
+		{
+			if (!ReadVarint(stream, value))
+				throw std::runtime_error("Replay header is cut short!");
+			recording.header.checksumInterval = static_cast<unsigned int>(value);
+		}
+
+		uint64_t tick = 0;
+		while (true)
+		{
+			const int byte = stream.get();
+			uint64_t delta = static_cast<uint64_t>(byte) >> 3;
+			uint64_t extra = 0;
+			uint64_t checksum = 0;
+			const bool isChecksum = byte != EOF && (byte & 0x07) == ChecksumCode && version >= 2;
+			if (byte == EOF || (delta == LongDelta && !ReadVarint(stream, extra)) || (isChecksum && !ReadWord(stream, checksum)))
+			{ // Cut off before the end event. Everything up to the last input still plays.
+				recording.tickCount = recording.events.empty() ? 0 : recording.events.back().tick + 1;
+				break;
+			}
+
+			tick += delta + extra;
+			const uint8_t code = static_cast<uint8_t>(byte & 0x07);
+			if (code == EndCode)
+			{
+				recording.tickCount = tick;
+				break;
+			}
+
+			if (isChecksum)
+			{
+				recording.checkpoints.push_back({ tick, checksum });
+				continue;
+			}
+
+			if (code == static_cast<uint8_t>(playerInput_t::NONE))
+				throw std::runtime_error("Replay holds an empty input!");
+
+			recording.events.push_back({ tick, static_cast<playerInput_t>(code) });
+		}
+
+		return recording;
+	}
+
+	Player::Player(recording_t recording, const unsigned int& keyframeInterval) : m_recording(std::move(recording)), m_keyframeInterval(keyframeInterval)
+	{
+		if (m_keyframeInterval == 0)
+			throw std::runtime_error("Keyframe interval must be at least one tick!");
+
+		Restart();
+	}
+
+	void Player::Restart()
+	{
+		m_registry = std::make_unique<entt::registry>();
+		StartGame(*m_registry, m_recording.header);
+		m_nextEvent = 0;
+		m_nextCheckpoint = 0;
+	}
+
+	void Player::Verify()
+	{
+		const uint64_t tick = GetTick();
+		const uint64_t checksum = GetGameContext(static_cast<const entt::registry&>(*m_registry)).checksum;
+
+		const auto& checkpoints = m_recording.checkpoints;
+		for (; m_nextCheckpoint < checkpoints.size() && checkpoints[m_nextCheckpoint].tick <= tick; m_nextCheckpoint++)
+		{
+			if (checkpoints[m_nextCheckpoint].tick != tick)
+				continue;
+
+			m_verification.checked++;
+			if (m_verification.diverged)
+				continue;
+
+			if (checkpoints[m_nextCheckpoint].checksum == checksum)
+			{
+				m_verification.lastMatchedTick = std::max(m_verification.lastMatchedTick, tick);
+			}
+			else
+			{
+				m_verification.diverged = true;
+				m_verification.divergedTick = tick;
+			}
+		}
+	}
+
+	uint64_t Player::GetTick() const
+	{
+		return GetGameContext(static_cast<const entt::registry&>(*m_registry)).tick;
+	}
+
+	bool Player::Step()
+	{
+		Verify();
+
+		entt::registry& registry = *m_registry;
+		const uint64_t tick = GetTick();
+		if (tick >= m_recording.tickCount)
+			return false;
+
+		if (GameState::GetState(registry) != gameState_t::PLAY)
+		{ // The recorded game went on past here, so this one's gone differently.
+			if (!m_verification.diverged)
+			{
+				m_verification.diverged = true;
+				m_verification.divergedTick = tick;
+			}
+			return false;
+		}
+
+		if (tick % m_keyframeInterval == 0 && tick / m_keyframeInterval == m_keyframes.size())
+		{
+			auto keyframe = std::make_unique<entt::registry>();
+			CopyGame(registry, *keyframe);
+			m_keyframes.push_back(std::move(keyframe));
+		}
+
+		const auto& events = m_recording.events;
+		for (; m_nextEvent < events.size() && events[m_nextEvent].tick <= tick; m_nextEvent++)
+			ApplyPlayerInput(registry, events[m_nextEvent].input);
+
+		Game::Tick(registry);
+		return true;
+	}
+
+	void Player::Seek(const uint64_t& tick)
+	{
+		const uint64_t current = GetTick();
+		if (!m_keyframes.empty())
+		{
+			const size_t keyframe = static_cast<size_t>(std::min<uint64_t>(tick / m_keyframeInterval, m_keyframes.size() - 1));
+			const uint64_t keyframeTick = keyframe * m_keyframeInterval;
+
+			// Going back, or forward to a keyframe past where play is now.
+			if (tick < current || keyframeTick > current)
+			{
+				CopyGame(*m_keyframes[keyframe], *m_registry);
+
+				const auto& events = m_recording.events;
+				m_nextEvent = std::lower_bound(events.begin(), events.end(), keyframeTick, [](const event_t& event, const uint64_t& value) { return event.tick < value; }) - events.begin();
+
+				const auto& checkpoints = m_recording.checkpoints;
+				m_nextCheckpoint = std::lower_bound(checkpoints.begin(), checkpoints.end(), keyframeTick, [](const checkpoint_t& checkpoint, const uint64_t& value) { return checkpoint.tick < value; }) - checkpoints.begin();
+			}
+		}
+		else if (tick < current)
+		{
+			Restart();
+		}
+
+		while (GetTick() < tick && Step())
+		{
+		}
+	}
+
+	// The components of this type from the given place in source's pool on, added to destination in the same order.
+	template<typename Component>
+	static void CopyPool(const entt::registry& source, entt::registry& destination, const size_t& first = 0)
+	{
+		const auto view = source.view<const Component>();
+		const entt::entity* entities = view.data();
+		for (size_t i = first; i < view.size(); i++)
+			destination.emplace<Component>(entities[i], source.get<const Component>(entities[i]));
+	}
+
+	/*
+	* An owning group keeps its members at the front of every pool it owns, in the same order in each. The group's made first and its members
+	* are added a whole entity at a time, so each one joins the group at the end of it and nothing's moved. The rest of each pool follows on after.
+	*/
+	template<typename... Owned, typename... Get>
+	static void CopyOwnedPools(const entt::registry& source, entt::registry& destination, entt::get_t<Get...>)
+	{
+		size_t memberCount = 0;
+		if (const auto group = source.group_if_exists<const Owned...>(entt::get<const Get...>))
+		{
+			const auto copiedGroup = destination.group<Owned...>(entt::get<Get...>);
+
+			memberCount = group.size();
+			const entt::entity* entities = group.data();
+			for (size_t i = 0; i < memberCount; i++)
+				(destination.emplace<Owned>(entities[i], source.get<const Owned>(entities[i])), ...);
+
+			if (copiedGroup.size() != memberCount)
+				throw std::runtime_error("Copied group doesn't match the original!");
+		}
+
+		(CopyPool<Owned>(source, destination, memberCount), ...);
+	}
+
+	void CopyGame(const entt::registry& source, entt::registry& destination)
+	{
+		destination = entt::registry();
+		destination.assign(source.data(), source.data() + source.size(), source.destroyed());
+		destination.set<gameContext_t>(GetGameContext(source));
+
+		// Components outside the owning groups, including those the groups only get. The client's cameras and UI aren't part of the game, and stay behind.
+		// A game component left off this list fails ReplayTest.CopyGameCopiesEveryComponent.
+		CopyPool<Components::Awake>(source, destination);
+		CopyPool<Components::Bag>(source, destination);
+		CopyPool<Components::Block>(source, destination);
+		CopyPool<Components::CardinalDirection>(source, destination);
+		CopyPool<Components::Cell>(source, destination);
+		CopyPool<Components::CellLink>(source, destination);
+		CopyPool<Components::Censor>(source, destination);
+		CopyPool<Components::Container>(source, destination);
+		CopyPool<Components::Controllable>(source, destination);
+		CopyPool<Components::DeriveOrientationFromParent>(source, destination);
+		CopyPool<Components::DerivePositionFromCoordinates>(source, destination);
+		CopyPool<Components::DerivePositionFromParent>(source, destination);
+		CopyPool<Components::DirectionallyActive>(source, destination);
+		CopyPool<Components::Flag>(source, destination);
+		CopyPool<Components::Follower>(source, destination);
+		CopyPool<Components::Ghost>(source, destination);
+		CopyPool<Components::Hittable>(source, destination);
+		CopyPool<Components::InheritScalingFromParent>(source, destination);
+		CopyPool<Components::Locked>(source, destination);
+		CopyPool<Components::Marker>(source, destination);
+		CopyPool<Components::NodeOrder>(source, destination);
+		CopyPool<Components::Obstructable>(source, destination);
+		CopyPool<Components::Obstructs>(source, destination);
+		CopyPool<Components::Parked>(source, destination);
+		CopyPool<Components::PooledBlock>(source, destination);
+		CopyPool<Components::PreviewQueue>(source, destination);
+		CopyPool<Components::ProjectionOf>(source, destination);
+		CopyPool<Components::QueueNode>(source, destination);
+		CopyPool<Components::ReferenceEntity>(source, destination);
+		CopyPool<Components::Rotateable>(source, destination);
+		CopyPool<Components::ScaleToCellDimensions>(source, destination);
+		CopyPool<Components::SpawnMarker>(source, destination);
+		CopyPool<Components::Tag>(source, destination);
+		CopyPool<Components::Tetromino>(source, destination);
+		CopyPool<Components::Wall>(source, destination);
+
+		CopyOwnedPools<Components::Moveable, Components::Coordinate>(source, destination, entt::get<Components::Awake>);
+		CopyOwnedPools<Components::Renderable, Components::Position, Components::Orientation, Components::Scale>(source, destination, entt::get<>);
+	}
+}
\ No newline at end of file
@@ -9,7 +9,8 @@ namespace Systems
 		if (linesCleared == 0)
 			return;
 
-		LinesClearedTotal += linesCleared;
+		auto& context = GetGameContext(registry);
+		context.linesClearedTotal += linesCleared;
 
 		// (0.8 - ((level - 1) * 0.007))^(level-1)
 		while (linesCleared > 0)
@@ -17,42 +18,42 @@ namespace Systems
 			switch (linesCleared)
 			{
 			case 1:
-				GameScore += 100 * GameLevel;
+				context.gameScore += 100 * context.gameLevel;
 				linesCleared -= 1;
 				break;
 			case 2:
-				GameScore += 300 * GameLevel;
+				context.gameScore += 300 * context.gameLevel;
 				linesCleared -= 2;
 				break;
 			case 3:
-				GameScore += 500 * GameLevel;
+				context.gameScore += 500 * context.gameLevel;
 				linesCleared -= 3;
 				break;
 			case 4:
-				GameScore += 800 * GameLevel;
+				context.gameScore += 800 * context.gameLevel;
 				linesCleared -= 4;
 				break;
 			default:
 				// This needs better looking at. Just getting the next in the fibonacci sequence here
-				GameScore += 1300 * GameLevel;
+				context.gameScore += 1300 * context.gameLevel;
 				linesCleared -= linesCleared;
 				break;
 			}
 		}
 
-		if (LinesClearedTotal > LevelGoal)
+		if (context.linesClearedTotal > context.levelGoal)
 		{
-			GameLevel += 1;
-			LevelGoal += (GameLevel * LevelGoalIncrement);
+			context.gameLevel += 1;
+			context.levelGoal += (context.gameLevel * LevelGoalIncrement);
 		}
 
-		FallSpeed = CalculateFallSpeed(GameLevel);
+		context.fallSpeed = CalculateFallSpeed(context.gameLevel);
 
 		/*
-		cout << "Score: " << GameScore << endl;
-		cout << "Game Level: " << GameLevel << endl;
-		cout << "Total Lines Cleared: " << LinesClearedTotal << " Level Goal: " << LevelGoal << endl;
-		cout << "Fall Speed: " << FallSpeed << endl;
+		cout << "Score: " << context.gameScore << endl;
+		cout << "Game Level: " << context.gameLevel << endl;
+		cout << "Total Lines Cleared: " << context.linesClearedTotal << " Level Goal: " << context.levelGoal << endl;
+		cout << "Fall Speed: " << context.fallSpeed << endl;
 		*/
 	}
 }
\ No newline at end of file
@@ -2,163 +2,113 @@
 #include "Systems/SystemShared.h"
 #include "Utility.h"
 
+#include <array>
+
 namespace Systems
 {
-	bool IsBlockAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate)
+	// Sends the settled block at from falling to to, if it's free to fall. Returns the cell it'll end up in.
+	static glm::uvec2 DropSettledBlock(entt::registry& registry, const entt::entity& matrixEnt, const Components::Container& container, const glm::uvec2& from, const glm::uvec2& to)
 	{
-		auto blockView = registry.view<Components::Block, Components::Coordinate, Components::Moveable>();
-		for (auto entity : blockView)
-		{
-			auto& block = blockView.get<Components::Block>(entity);
-			auto& blockCoordinate = blockView.get<Components::Coordinate>(entity);
-			auto& blockMoveable = blockView.get<Components::Moveable>(entity);
-
-			if (block.IsEnabled() && blockCoordinate.IsEnabled() && blockMoveable.IsEnabled())
-			{
-				if (blockCoordinate == coordinate)
-				{
-					return true;
-				}
-			}
-		}
+		if (from == to)
+			return from;
 
-		return false;
-	}
+		const entt::entity entity = container.GetOccupantAt(from);
+		if (entity == entt::null || !registry.valid(entity) || !registry.all_of<Components::Block, Components::Moveable, Components::Coordinate, Components::Obstructable>(entity))
+			return from;
 
-	bool IsWallAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const moveDirection_t& moveDirection)
-	{
-		auto wallView = registry.view<Components::Wall, Components::Coordinate>();
-		for (auto entity : wallView)
-		{
-			auto wall = wallView.get<Components::Wall>(entity);
-			auto wallCoordinate = wallView.get<Components::Coordinate>(entity);
+		auto& block = registry.get<Components::Block>(entity);
+		auto& moveable = registry.get<Components::Moveable>(entity);
+		auto& coordinate = registry.get<Components::Coordinate>(entity);
+		auto& obstructable = registry.get<Components::Obstructable>(entity);
 
-			if (wall.IsEnabled() && wallCoordinate.IsEnabled())
-			{
-				if (wallCoordinate == coordinate)
-				{
-					if (registry.all_of<Components::DirectionallyActive>(entity))
-					{
-						auto& dirWall = registry.get<Components::DirectionallyActive>(entity);
-						if (dirWall.IsActive(moveDirection))
-						{
-							return true;
-						}
-						else
-						{
-							continue;
-						}
-					}
-					else
-					{
-						return true;
-					}
-				}
-			}
-		}
+		if (!block.IsEnabled() || !moveable.IsEnabled() || !coordinate.IsEnabled() || !obstructable.GetIsObstructed())
+			return from;
 
-		return false;
-	}
+		obstructable.SetIsObstructed(false);
+		moveable.SetDesiredCoordinate(Components::Coordinate(matrixEnt, to));
+		moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
+		WakeEntity(registry, entity);
 
-	// This is going to have problems with buffer area's that are up(and so wall isn't active there)
-	// This will also have problems with play areas or buffer areas that aren't normal (eg: for testing with a simpler play area) FIXME TODO
-	bool IsCoordinateOutsidePlayArea(entt::registry& registry, const Components::Coordinate& coordinate)
-	{
-		if (coordinate.Get().x < BufferAreaDepth)
-			return true;
-		if (coordinate.Get().x >= BufferAreaDepth + PlayAreaWidth)
-			return true;
-		if (coordinate.Get().y < BufferAreaDepth)
-			return true;
-		if (coordinate.Get().y >= BufferAreaDepth + PlayAreaHeight)
-			return true;
-
-		return false;
+		return to;
 	}
 
-	int CountEmptyCellsBeneathBlock(entt::registry& registry, entt::entity cellEnt, const moveDirection_t& moveDirection, int count)
+	/*
+	* One pass over the matrix's row bitmasks, in the current gravity direction, working up from the floor.
+	* Every settled block falls to the lowest free cell beneath it, down to the nearest active wall or the edge of the matrix.
+	* Only the set bits of the block and wall masks are visited, and only the blocks that actually have somewhere to fall are woken.
+	*/
+	void DetachSystem(entt::registry& registry, double currentFrameTime)
 	{
-
-		//if block
-		//else if cell
-
-		auto& originCellCoordinate = GetCoordinateOfEntity(registry, cellEnt);
-		//auto originCellEnt = GetCellAtCoordinates2(registry, originCellCoordinate);
-		//auto originCell = registry.get<Components::Cell>(originCellEnt);
-
-		auto cellView = registry.view<Components::Cell, Components::Coordinate>();
-		for (auto entity : cellView)
-		{
-			auto& cell = cellView.get<Components::Cell>(entity);
-			auto& cellCoordinate = registry.get<Components::Coordinate>(entity);
-
-			if (cell.IsEnabled() && cellCoordinate.IsEnabled())
+		const auto matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+		if (matrixEnt == entt::null || !registry.all_of<Components::Container, Components::ReferenceEntity>(matrixEnt))
+			return;
+
+		const auto& container = registry.get<Components::Container>(matrixEnt);
+		const auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(matrixEnt);
+		const auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
+
+		const glm::ivec2 down = GetDirectionOffset(playAreaDirection.GetCurrentDownDirection());
+		if (down == glm::ivec2(0, 0))
+			return;
+
+		const glm::uvec2 dimensions = container.GetGridDimensions();
+		const unsigned int wordsPerRow = container.GetWordsPerRow();
+		const bool floorIsLow = (down.x + down.y) < 0;
+
+		if (down.x == 0)
+		{ // Falling along the columns. Each word of columns is walked a row at a time, with where the next block in each column comes to rest.
+			std::array<int, 64> landing;
+			for (unsigned int word = 0; word < wordsPerRow; word++)
 			{
-				if (cellCoordinate != originCellCoordinate)
-					continue;
-
-				/*if (cellCoordinate.GetParent() != originCellCoordinate.GetParent())
-					continue;
-
-				if (cellCoordinate.Get() != originCellCoordinate.Get())
-					continue;
-				*/
+				landing.fill(floorIsLow ? 0 : static_cast<int>(dimensions.y) - 1);
 
-				// This cell is a wall. Stop.
-				if (IsWallAtCoordinates(registry, cellCoordinate, moveDirection))
-					return count;
-
-				if (IsCoordinateOutsidePlayArea(registry, cellCoordinate))
-					return count;
-
-				if (!IsBlockAtCoordinates(registry, cellCoordinate))
+				for (unsigned int step = 0; step < dimensions.y; step++)
 				{
-					count++;
-				}
+					const unsigned int row = floorIsLow ? step : dimensions.y - 1 - step;
+					const uint64_t walls = container.GetWallWord(row, word);
 
-				// Next cell is null. Stop.
-				if (cell.GetDirection(moveDirection) == entt::null)
-					continue;
+					for (uint64_t bits = walls; bits != 0; bits &= bits - 1)
+					{
+						landing[Bitboard::LowestBit(bits)] = static_cast<int>(row) - down.y;
+					}
 
-				return CountEmptyCellsBeneathBlock(registry, cell.GetDirection(moveDirection), moveDirection, count);
+					for (uint64_t bits = container.GetBlockWord(row, word) & ~walls; bits != 0; bits &= bits - 1)
+					{
+						const unsigned int bit = Bitboard::LowestBit(bits);
+						const unsigned int column = word * 64 + bit;
+						const glm::uvec2 settled = DropSettledBlock(registry, matrixEnt, container, glm::uvec2(column, row), glm::uvec2(column, landing[bit]));
+						landing[bit] = static_cast<int>(settled.y) - down.y;
+					}
+				}
 			}
 		}
-
-		return count;
-	}
-
-	void DetachSystem(entt::registry& registry, double currentFrameTime)
-	{
-		auto blockView = registry.view<Components::Block, Components::Moveable, Components::Coordinate, Components::Obstructable>();
-		for (auto entity : blockView)
-		{
-			auto& block = blockView.get<Components::Block>(entity);
-			auto& moveable = blockView.get<Components::Moveable>(entity);
-			auto& coordinate = blockView.get<Components::Coordinate>(entity);
-			auto& obstructable = blockView.get<Components::Obstructable>(entity);
-
-			if (block.IsEnabled() && moveable.IsEnabled() && coordinate.IsEnabled())
+		else
+		{ // Falling along the rows. Each row is walked from its floor end, visiting only the walls and blocks in it.
+			for (unsigned int row = 0; row < dimensions.y; row++)
 			{
-				if (coordinate.GetParent() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX))) // Don't pattern anything not in the play area matrix
-					continue;
-
-				auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(moveable.GetCurrentCoordinate().GetParent());
-				auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
-
-				int count = 0;
-				count = CountEmptyCellsBeneathBlock(registry, entity, playAreaDirection.GetCurrentDownDirection(), count);
-
-
+				int landing = floorIsLow ? 0 : static_cast<int>(dimensions.x) - 1;
 
-				//if (moveable.GetMovementState() == Components::movementStates_t::LOCKED)
-				if(obstructable.GetIsObstructed())
+				for (unsigned int step = 0; step < wordsPerRow; step++)
 				{
-					obstructable.SetIsObstructed(false);
-					moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), count, true))); // PlayAreaHeight is a const of 20. This is fine to be excessive with when the height is lower.
-					moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
+					const unsigned int word = floorIsLow ? step : wordsPerRow - 1 - step;
+					const uint64_t walls = container.GetWallWord(row, word);
+					uint64_t bits = walls | container.GetBlockWord(row, word);
 
+					while (bits != 0)
+					{
+						const unsigned int bit = floorIsLow ? Bitboard::LowestBit(bits) : Bitboard::HighestBit(bits);
+						bits &= ~(uint64_t(1) << bit);
+
+						const unsigned int column = word * 64 + bit;
+						if ((walls >> bit) & 1)
+						{
+							landing = static_cast<int>(column) - down.x;
+							continue;
+						}
 
-					//CountEmptyCellsBeneathBlock();
+						const glm::uvec2 settled = DropSettledBlock(registry, matrixEnt, container, glm::uvec2(column, row), glm::uvec2(landing, row));
+						landing = static_cast<int>(settled.x) - down.x;
+					}
 				}
 			}
 		}
@@ -1,11 +1,17 @@
 #include "Systems/EliminateSystem.h"
 #include "Systems/SystemShared.h"
 #include "Utility.h"
+#include "Bitboard.h"
 
-#include <set>
+#include <vector>
 
 namespace Systems
 {
+	/*
+	* Removes every Hittable block, then closes the gaps in one go.
+	* Each line's drop is the number of cleared lines between it and the floor, worked out in one pass along the gravity direction.
+	* Settled blocks are then written straight to their new coordinates through the occupant index, and the occupancy bitmask is compacted as a whole.
+	*/
 	void EliminateSystem(entt::registry& registry, double currentFrameTime)
 	{
 		const auto& playAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA));
@@ -13,108 +19,93 @@ namespace Systems
 			throw std::runtime_error("Play Area entity is null!");
 		auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaEnt);
 
-		if (playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH)
+		const auto& matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+		if (matrixEnt == entt::null || !registry.all_of<Components::Container>(matrixEnt))
+			return;
+
+		auto& container = registry.get<Components::Container>(matrixEnt);
+		const auto& dimensions = container.GetGridDimensions();
+
+		// North/South clears rows, East/West clears columns.
+		const bool horizontal = playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH;
+		const unsigned int lineCount = horizontal ? dimensions.y : dimensions.x;
+
+		const glm::ivec2 down = GetDirectionOffset(playAreaDirection.GetCurrentDownDirection());
+		const bool floorIsLow = (down.x + down.y) < 0;
+
+		// Drop distance of every line. Cleared lines are marked with lineCount, which no real drop can reach.
+		std::vector<unsigned int> lineDrops(lineCount, 0);
+		uint64_t clearedLines = 0;
+		bool anyCleared = false;
+
+		// Clear all hitlist marked ents
+		auto hittableView = registry.view<Components::Block, Components::Hittable>();
+		for (auto entity : hittableView)
 		{
-			auto rows = std::set<unsigned int>();
+			const auto& coordinate = GetCoordinateOfEntity(registry, entity);
+			const unsigned int line = horizontal ? coordinate.Get().y : coordinate.Get().x;
 
-			// Clear all hitlist marked ents
-			auto hittableView = registry.view<Components::Block, Components::Hittable>();
-			for (auto entity : hittableView)
+			if (coordinate.GetParent() == matrixEnt && line < lineCount)
 			{
-				rows.insert(GetCoordinateOfEntity(registry, entity).Get().y); // Note all unique rows that have been cleared.
-
-				registry.destroy(entity);
+				lineDrops[line] = lineCount; // Note all unique lines that have been cleared.
+				if (line < 64)
+					clearedLines |= uint64_t(1) << line;
+				anyCleared = true;
 			}
 
-			if (playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH)
-			{ // North
-				if (rows.size() > 0)
-				{
-					unsigned int lowestRow = *rows.begin();
-
-					auto blockView = registry.view<Components::Block, Components::Moveable>();
-					for (auto entity : blockView)
-					{
-						auto& moveable = blockView.get<Components::Moveable>(entity);
-
-						if (moveable.GetCurrentCoordinate().Get().y > lowestRow)
-						{
-							moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), static_cast<unsigned int>(rows.size()), true)));
-							moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
-						}
-					}
-				}
-			}
+			ClearOccupantAtCoordinates(registry, coordinate, entity);
+			ReleaseBlock(registry, entity);
+		}
+
+		if (!anyCleared)
+			return;
+
+		unsigned int clearedBelow = 0;
+		for (unsigned int step = 0; step < lineCount; step++)
+		{
+			const unsigned int line = floorIsLow ? step : lineCount - 1 - step;
+			if (lineDrops[line] == lineCount)
+				clearedBelow++;
 			else
-			{ // South
-				if (rows.size() > 0)
-				{
-					unsigned int highestRow = *rows.rbegin();
-
-					auto blockView = registry.view<Components::Block, Components::Moveable>();
-					for (auto entity : blockView)
-					{
-						auto& moveable = blockView.get<Components::Moveable>(entity);
-
-						if (moveable.GetCurrentCoordinate().Get().y < highestRow)
-						{
-							moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), static_cast<unsigned int>(rows.size()), true)));
-							moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
-						}
-					}
-				}
-			}
+				lineDrops[line] = clearedBelow;
 		}
-		else
-		{ // East/West
-			auto rows = std::set<unsigned int>();
 
-			// Clear all hitlist marked ents
-			auto hittableView = registry.view<Components::Block, Components::Hittable>();
-			for (auto entity : hittableView)
+		const bool compacted = container.CompactBlockLines(clearedLines, horizontal, floorIsLow);
+
+		// Settled blocks are found through the occupant index, a line at a time from the floor up, so only the lines that drop are visited.
+		// Working from the floor means every destination has already been vacated, either by the clear or by the line below it moving down.
+		const unsigned int lineLength = horizontal ? dimensions.x : dimensions.y;
+		for (unsigned int step = 0; step < lineCount; step++)
+		{
+			const unsigned int line = floorIsLow ? step : lineCount - 1 - step;
+			if (lineDrops[line] == 0 || lineDrops[line] == lineCount)
+				continue;
+
+			for (unsigned int i = 0; i < lineLength; i++)
 			{
-				rows.insert(GetCoordinateOfEntity(registry, entity).Get().x); // Note all unique rows that have been cleared.
+				const glm::uvec2 from = horizontal ? glm::uvec2(i, line) : glm::uvec2(line, i);
+				const entt::entity entity = container.GetOccupantAt(from);
+				if (entity == entt::null || !registry.valid(entity) || registry.all_of<Components::Follower>(entity))
+					continue;
 
-				registry.destroy(entity);
-			}
+				if (!registry.all_of<Components::Block, Components::Moveable, Components::Coordinate>(entity))
+					continue;
 
-			if (playAreaDirection.GetCurrentOrientation() == moveDirection_t::EAST)
-			{ // North
-				if (rows.size() > 0)
-				{
-					unsigned int lowestCol = *rows.begin();
-
-					auto blockView = registry.view<Components::Block, Components::Moveable>();
-					for (auto entity : blockView)
-					{
-						auto& moveable = blockView.get<Components::Moveable>(entity);
-
-						if (moveable.GetCurrentCoordinate().Get().x < lowestCol)
-						{
-							moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), static_cast<unsigned int>(rows.size()), true)));
-							moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
-						}
-					}
-				}
-			}
-			else
-			{ // South
-				if (rows.size() > 0)
+				auto& moveable = registry.get<Components::Moveable>(entity);
+				auto& coordinate = registry.get<Components::Coordinate>(entity);
+				const glm::uvec2 to = glm::uvec2(glm::ivec2(from) + down * static_cast<int>(lineDrops[line]));
+
+				container.SetOccupantAt(from, entt::null);
+				container.SetOccupantAt(to, entity);
+				if (!compacted)
 				{
-					unsigned int highestCol = *rows.rbegin();
-
-					auto blockView = registry.view<Components::Block, Components::Moveable>();
-					for (auto entity : blockView)
-					{
-						auto& moveable = blockView.get<Components::Moveable>(entity);
-
-						if (moveable.GetCurrentCoordinate().Get().x > highestCol)
-						{
-							moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), static_cast<unsigned int>(rows.size()), true)));
-							moveable.SetMovementState(Components::movementStates_t::HARD_DROP);
-						}
-					}
+					container.SetBlockBit(from, false);
+					container.SetBlockBit(to, true);
 				}
+
+				coordinate.Set(to);
+				moveable.SetCurrentCoordinate(coordinate);
+				moveable.SetDesiredCoordinate(coordinate);
 			}
 		}
 	}
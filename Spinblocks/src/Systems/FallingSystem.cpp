@@ -2,43 +2,69 @@
 #include "Systems/SystemShared.h"
 #include "Utility.h"
 
+#include <array>
+
 namespace Systems
 {
 	void FallingSystem(entt::registry& registry, double currentFrameTime)
 	{
-		if (currentFrameTime >= lastFallUpdate + FallSpeed)
+		auto& context = GetGameContext(registry);
+		if (currentFrameTime >= context.lastFallUpdate + context.fallSpeed)
 		{
-			lastFallUpdate = currentFrameTime;
+			context.lastFallUpdate = currentFrameTime;
+
+			// Everything that falls is in the matrix, so its container and the way down are looked up once for the whole pass.
+			const auto matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+			if (matrixEnt == entt::null || !registry.all_of<Components::Container, Components::ReferenceEntity>(matrixEnt))
+				return;
 
-			auto moveableView = registry.view<Components::Moveable, Components::Coordinate>(entt::exclude<Components::Follower>);
-			for (auto entity : moveableView)
+			const auto& container = registry.get<Components::Container>(matrixEnt);
+			const auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(matrixEnt);
+			const moveDirection_t downDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get()).GetCurrentDownDirection();
+			const glm::ivec2 down = GetDirectionOffset(downDirection);
+
+			// Only awake entities can be falling. Settled blocks have dropped out of the group, so this doesn't grow with the stack.
+			auto awakeGroup = GetAwakeGroup(registry);
+			for (auto entity : awakeGroup)
 			{
-				auto& moveable = moveableView.get<Components::Moveable>(entity);
-				auto& coordinate = moveableView.get<Components::Coordinate>(entity);
+				if (registry.all_of<Components::Follower>(entity))
+					continue;
+
+				auto& moveable = awakeGroup.get<Components::Moveable>(entity);
+				auto& coordinate = awakeGroup.get<Components::Coordinate>(entity);
 
 				if (moveable.IsEnabled() && coordinate.IsEnabled())
 				{
-					if (coordinate.GetParent() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX)))
+					if (coordinate.GetParent() != matrixEnt)
 						continue;
 
 					switch (moveable.GetMovementState())
 					{
 					case Components::movementStates_t::FALL:
 					{
-						Components::Coordinate movableCoord = moveable.GetCurrentCoordinate();
-						entt::entity moveableParentEntity = movableCoord.GetParent();
-						std::string tagOfContainerEntity = FindTagOfContainerEntity(registry, moveableParentEntity);
-
-						auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(movableCoord.GetParent());
-						auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
-
-						auto& cell = GetCellAtCoordinates(registry, tagOfContainerEntity, movableCoord); // If can't find, don't move
-						if (cell.IsEnabled())
+						const glm::uvec2 cellCoordinate = moveable.GetCurrentCoordinate().Get();
+						const entt::entity cellEnt = container.GetCellAt(cellCoordinate); // If can't find, don't move
+						if (cellEnt != entt::null && registry.get<Components::Cell>(cellEnt).IsEnabled())
 						{
-							entt::entity desiredCell = MoveBlockInDirection(registry, entity, playAreaDirection.GetCurrentDownDirection(), 1);
-							if (GetCoordinateOfEntity(registry, desiredCell) != GetCoordinateOfEntity(registry, entity))
+							bool canFall;
+							auto* tetromino = GetTetrominoFromEntity(registry, entity);
+							if (tetromino != NULL)
 							{
-								moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, desiredCell));
+								std::array<glm::ivec2, 4> cells;
+								for (int i = 0; i < 4; i++)
+								{
+									cells[i] = glm::ivec2(cellCoordinate) + down + glm::ivec2(tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i));
+								}
+								canFall = AreTetrominoCellsFree(container, cells);
+							}
+							else
+							{
+								canFall = CanOccupyCell(registry, entity, registry.get<Components::Cell>(cellEnt).GetDirection(downDirection));
+							}
+
+							if (canFall)
+							{
+								moveable.SetDesiredCoordinate(Components::Coordinate(matrixEnt, glm::uvec2(glm::ivec2(cellCoordinate) + down)));
 							}
 							else
 							{
@@ -57,10 +83,8 @@ namespace Systems
 										obstructable.SetLastObstructedTime(currentFrameTime);
 									}
 
-									if (IsEntityTetromino(registry, entity))
+									if (tetromino != NULL)
 									{
-										auto* tetromino = GetTetrominoFromEntity(registry, entity);
-
 										if (!tetromino->GetAreAllBlocksObstructed(registry))
 										{
 											tetromino->SetAllBlocksLastObstructedTime(registry, currentFrameTime + lockdownDelay);
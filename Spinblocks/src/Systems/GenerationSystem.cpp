@@ -1,77 +1,97 @@
-#include "Systems/EliminateSystem.h"
+#include "Systems/GenerationSystem.h"
 #include "Systems/SystemShared.h"
 #include "Utility.h"
 
-#include <set>
+#include <algorithm>
+#include <array>
+#include <iostream>
 
 #include "GameState.h"
 
 namespace Systems
 {
-	void FillNodeQueue(entt::registry& registry, double currentFrameTime, entt::entity nodeEnt)
+	/*
+	* Gives each queued piece on show a tetromino of its own, kept in the piece's ring slot until it's dealt, the next piece on show at the node that feeds the matrix.
+	* On an advance the previews kept on show move a node along, blocks and all, so each one always occupies its own node's cells. Only the slot coming into view
+	* needs a tetromino spawned, and slots past the end of the queue or the nodes have theirs released.
+	*/
+	void UpdatePreviewNodes(entt::registry& registry, Components::PreviewQueue& previewQueue, const std::vector<entt::entity>& nodes)
 	{
-		if (!registry.all_of<Components::QueueNode>(nodeEnt))
-			return;
-
-		auto& node = registry.get<Components::QueueNode>(nodeEnt);
-
-		// Node is not empty.
-		if (node.GetContent() != entt::null)
+		const unsigned int visibleCount = static_cast<unsigned int>(std::min<size_t>(nodes.size(), previewQueue.GetSize()));
+		for (unsigned int slot = 0; slot < Components::PreviewQueue::MaximumDepth; slot++)
 		{
-			if (registry.all_of<Components::QueueNode>(node.GetDestination()))
+			const entt::entity piece = previewQueue.GetPiece(slot);
+			if (piece != entt::null && previewQueue.GetPosition(slot) >= visibleCount)
 			{
-				auto& destination = registry.get<Components::QueueNode>(node.GetDestination());
-				if (destination.GetContent() == entt::null)
-				{ // Destination is empty
-					auto& nodeCoordinates = registry.get<Components::Coordinate>(node.GetDestination());
-					destination.SetContent(node.GetContent());
-					node.SetContent(entt::null);
-					RelocateTetromino(registry, nodeCoordinates, destination.GetContent());
-				}
+				ReleaseTetromino(registry, piece);
+				previewQueue.SetPiece(slot, entt::null);
 			}
 		}
-		else // Node is empty
+
+		// Front first, so each preview moves onto cells the one ahead of it has already left.
+		for (unsigned int position = 0; position < visibleCount; position++)
 		{
-			if (registry.all_of<Components::QueueNode>(node.GetSource()))
-			{ // Source is a node.
-				// Look at that node.
-				FillNodeQueue(registry, currentFrameTime, node.GetSource());
-			}
-			else if (registry.all_of<Components::Bag>(node.GetSource()))
-			{ // Source is not a node. It's a bag component.
-				// Spawn a new Tetromino here, I think.
-				auto& bag = registry.get<Components::Bag>(node.GetSource());
-				auto& nodeCoordinates = registry.get<Components::Coordinate>(nodeEnt);
-				node.SetContent(SpawnTetromino(registry, GetTagFromContainerType(containerType_t::BAG_AREA), nodeCoordinates, bag.PopTetromino(), false));
+			const unsigned int slot = previewQueue.GetSlot(position);
+			const entt::entity piece = previewQueue.GetPiece(slot);
+			const auto& nodeCoordinates = registry.get<Components::Coordinate>(nodes[nodes.size() - 1 - position]);
+
+			const tetrominoType_t wanted = previewQueue.Peek(position);
+			const auto* shown = GetTetrominoFromEntity(registry, piece);
+			if (shown != NULL && shown->GetType() == wanted)
+			{
+				if (registry.get<Components::Coordinate>(piece).Get() != nodeCoordinates.Get())
+					RelocateTetromino(registry, nodeCoordinates, piece);
+				continue;
 			}
+
+			ReleaseTetromino(registry, piece);
+			previewQueue.SetPiece(slot, SpawnTetromino(registry, GetTagFromContainerType(containerType_t::BAG_AREA), nodeCoordinates, wanted, false));
 		}
 	}
 
-	void PopFromQueueIntoMatrix(entt::registry& registry, double currentFrameTime, entt::entity nodeEnt)
+	// Takes the next piece off the queue and into the matrix. The front slot's preview is moved across, keeping its blocks.
+	void PopFromQueueIntoMatrix(entt::registry& registry, Components::PreviewQueue& previewQueue, entt::entity nodeEnt)
 	{
 		if (!registry.all_of<Components::QueueNode>(nodeEnt))
 			return;
 
 		auto& node = registry.get<Components::QueueNode>(nodeEnt);
 
-		entt::entity tet = node.GetContent();
-		node.SetContent(entt::null);
+		const unsigned int frontSlot = previewQueue.GetSlot(0);
+		entt::entity tet = previewQueue.GetPiece(frontSlot);
+		previewQueue.SetPiece(frontSlot, entt::null);
+
+		const tetrominoType_t tetrominoType = previewQueue.Pop();
+		auto newCoordinate = Components::Coordinate(node.GetDestination(), GetTetrominoSpawnCoordinates(registry, GetTagFromContainerType(containerType_t::MATRIX), tetrominoType));
 
 		auto* tetromino = GetTetrominoFromEntity(registry, tet);
-		if (tetromino != NULL)
+		if (tetromino != NULL && tetromino->GetType() == tetrominoType)
 		{
-			auto newCoordinate = Components::Coordinate(node.GetDestination(), GetTetrominoSpawnCoordinates(registry, GetTagFromContainerType(containerType_t::MATRIX), tetromino->GetType()));
-
 			RelocateTetromino(registry, newCoordinate, tet);
+		}
+		else
+		{ // The preview was out of step with the queue. Go by the queue.
+			ReleaseTetromino(registry, tet);
+			tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), newCoordinate, tetrominoType, false);
+			tetromino = GetTetrominoFromEntity(registry, tet);
+		}
 
+		if (tetromino != NULL)
+		{
+			auto& context = GetGameContext(registry);
+			context.piecesDealt++;
+			context.activePiece = tet;
 			registry.emplace<Components::Controllable>(tet, newCoordinate.GetParent());
 			if (registry.all_of<Components::Moveable>(tet))
 			{
 				auto& moveable = registry.get<Components::Moveable>(tet);
 				moveable.SetMovementState(Components::movementStates_t::FALL);
+				WakeEntity(registry, tet);
 
 				for (int i = 0; i < 4; i++)
 				{
+					// Waking reorders the awake group's Moveable storage, so only take the reference afterwards.
+					WakeEntity(registry, tetromino->GetBlock(i));
 					auto& blockMoveable = registry.get<Components::Moveable>(tetromino->GetBlock(i));
 					if (registry.all_of<Components::Follower>(tetromino->GetBlock(i)))
 					{
@@ -86,14 +106,14 @@ namespace Systems
 
 			if (IsAnyBlockInTetrominoObstructed(registry, tet))
 			{
-				cout << "Obstructed on spawn! Game Over!" << endl;
+				std::cout << "Obstructed on spawn! Game Over!" << std::endl;
 
 				auto controllableView = registry.view<Components::Controllable>();
 				for (auto controllable : controllableView)
 				{
 					registry.remove_if_exists<Components::Controllable>(controllable);
 				}
-				GameState::SetState(gameState_t::GAME_OVER);
+				GameState::SetState(registry, gameState_t::GAME_OVER);
 			}
 		}
 	}
@@ -107,57 +127,35 @@ namespace Systems
 		const auto& matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
 		if (matrixEnt == entt::null)
 			throw std::runtime_error("Matrix entity is null!");
-		
-		auto& nodeOrder = registry.get<Components::NodeOrder>(bagAreaEnt);
-		entt::entity nodeEnt = entt::null;
 
-		// Fill the queue if it's not full
-		bool atLeastOneNodeIsEmpty = false;
-		do
-		{
-			atLeastOneNodeIsEmpty = false;
-			auto nodeView = registry.view<Components::QueueNode>();
-			for (auto entity : nodeView)
-			{
-				auto& node = registry.get<Components::QueueNode>(entity);
-				if (node.GetContent() == entt::null)
-				{
-					atLeastOneNodeIsEmpty = true;
-				}
-			}
+		auto& bag = registry.get<Components::Bag>(bagAreaEnt);
+		auto& previewQueue = registry.get<Components::PreviewQueue>(bagAreaEnt);
+		const auto& nodes = registry.get<Components::NodeOrder>(bagAreaEnt).GetNodes();
 
-			if (atLeastOneNodeIsEmpty)
-			{
-				nodeEnt = nodeOrder.GetNode();
-				if (nodeEnt != entt::null)
-				{
-					auto& node = registry.get<Components::QueueNode>(nodeEnt);
-					// First node is the source node. Bag area entity 3
-
-					// This node is empty.
-					if (node.GetContent() == entt::null)
-					{
-						FillNodeQueue(registry, currentFrameTime, nodeEnt);
-					}
-				}
-			}
-		} while (atLeastOneNodeIsEmpty);
+		// Keep the queue topped up. Once it's full, this is one check a tick however deep the queue is.
+		if (!previewQueue.IsFull())
+		{
+			std::array<tetrominoType_t, Components::PreviewQueue::MaximumDepth> dealt;
+			const unsigned int dealtCount = previewQueue.GetDepth() - previewQueue.GetSize();
+			bag.PopTetrominos(dealt.data(), dealtCount);
+			for (unsigned int i = 0; i < dealtCount; i++)
+				previewQueue.Push(dealt[i]);
+		}
 
-		if (currentFrameTime >= lastLockdownTime + generationTimeDelay && registry.view<Components::Controllable>().size() == 0)
+		// The previews are only touched when the queue has moved on.
+		if (previewQueue.IsPreviewDirty())
 		{
-			auto nodeView = registry.view<Components::QueueNode>();
-			for (auto entity : nodeView)
-			{
-				auto& node = registry.get<Components::QueueNode>(entity);
+			UpdatePreviewNodes(registry, previewQueue, nodes);
+			previewQueue.SetPreviewDirty(false);
+		}
 
-				if (node.GetDestination() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX)))
-					continue;
+		if (!nodes.empty() && currentFrameTime >= GetGameContext(registry).lastLockdownTime + generationTimeDelay && registry.view<Components::Controllable>().size() == 0)
+		{
+			PopFromQueueIntoMatrix(registry, previewQueue, nodes.back());
+			previewQueue.Push(bag.PopTetromino());
 
-				if (node.GetContent() == entt::null)
-					continue;
-				
-				PopFromQueueIntoMatrix(registry, currentFrameTime, entity);
-			}
+			UpdatePreviewNodes(registry, previewQueue, nodes);
+			previewQueue.SetPreviewDirty(false);
 		}
 	}
 }
\ No newline at end of file
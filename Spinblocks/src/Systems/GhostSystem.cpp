@@ -0,0 +1,79 @@
+#include "Systems/GhostSystem.h"
+#include "Systems/SystemShared.h"
+#include "GameContext.h"
+#include "Utility.h"
+
+namespace Systems
+{
+	void GhostSystem(entt::registry& registry, double currentFrameTime)
+	{
+		auto& context = GetGameContext(registry);
+
+		// There's only ever zero or one controllable, and it's always a tetromino.
+		entt::entity activeTetEnt = entt::null;
+		auto controllableView = registry.view<Components::Controllable, Components::Moveable>();
+		for (auto entity : controllableView)
+		{
+			if (controllableView.get<Components::Controllable>(entity).IsEnabled() && controllableView.get<Components::Moveable>(entity).IsEnabled())
+			{
+				activeTetEnt = entity;
+				break;
+			}
+		}
+
+		ghostCast_t cast;
+		if (activeTetEnt != entt::null && IsEntityTetromino(registry, activeTetEnt))
+		{
+			const auto& coordinate = registry.get<Components::Coordinate>(activeTetEnt);
+			const auto containerEnt = coordinate.GetParent();
+			if (containerEnt != entt::null && registry.all_of<Components::Container, Components::ReferenceEntity>(containerEnt) && GetCellAtCoordinates2(registry, coordinate) != entt::null)
+			{
+				cast.tetromino = activeTetEnt;
+				cast.container = containerEnt;
+				cast.coordinate = coordinate.Get();
+				cast.orientation = GetTetrominoFromEntity(registry, activeTetEnt)->GetCurrentOrientation();
+				cast.downDirection = registry.get<Components::CardinalDirection>(registry.get<Components::ReferenceEntity>(containerEnt).Get()).GetCurrentDownDirection();
+				cast.blockHash = registry.get<Components::Container>(containerEnt).GetBlockHash();
+			}
+		}
+
+		// Neither the piece nor the board has changed, so the ghost is already where it belongs.
+		if (cast == context.ghostCast)
+			return;
+		context.ghostCast = cast;
+
+		auto ghostView = registry.view<Components::Ghost, Components::Coordinate, Components::Renderable>();
+
+		if (cast.tetromino == entt::null)
+		{ // Nothing to cast a ghost for.
+			for (auto entity : ghostView)
+			{
+				ghostView.get<Components::Renderable>(entity).Enable(false);
+			}
+			return;
+		}
+
+		const auto landingCoordinate = GetLandingCoordinate(registry, activeTetEnt);
+		auto* tetromino = GetTetrominoFromEntity(registry, activeTetEnt);
+
+		for (auto entity : ghostView)
+		{
+			auto& ghost = ghostView.get<Components::Ghost>(entity);
+			auto& coordinate = ghostView.get<Components::Coordinate>(entity);
+			auto& renderable = ghostView.get<Components::Renderable>(entity);
+
+			if (!ghost.IsEnabled())
+				continue;
+
+			coordinate.SetParent(landingCoordinate.GetParent());
+			coordinate.Set(glm::uvec2(glm::ivec2(landingCoordinate.Get()) + glm::ivec2(tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), ghost.GetBlockIndex()))));
+
+			if (registry.all_of<Components::DerivePositionFromCoordinates>(entity))
+			{
+				registry.get<Components::DerivePositionFromCoordinates>(entity).Set(landingCoordinate.GetParent());
+			}
+
+			renderable.Enable(true);
+		}
+	}
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Systems/MovementSystem.h"
 #include "Utility.h"
-#include <set>
+
+#include <array>
 
 namespace Systems
 {
@@ -8,18 +9,6 @@ namespace Systems
 	{
 		bool aPieceMoved = false;
 
-		std::set<entt::entity> leaderEntities;
-		auto followerView = registry.view<Components::Moveable, Components::Coordinate, Components::Follower>();
-		for (auto entity : followerView)
-		{
-			auto& moveable = followerView.get<Components::Moveable>(entity);
-			auto& coordinate = followerView.get<Components::Coordinate>(entity);
-			auto& follower = followerView.get<Components::Follower>(entity);
-			
-
-			leaderEntities.insert(follower.Get());
-		}
-
 		auto followMarkerView = registry.view<Components::Marker, Components::Coordinate, Components::Follower>();
 		for (auto entity : followMarkerView)
 		{
@@ -47,91 +36,63 @@ namespace Systems
 			}
 		}
 
-		/*for (auto leaderEnt : leaderEntities)
+		// Each active tetromino moves its blocks as one unit: one lookup of the leader, its block offsets worked out once, then the four blocks written in a single pass.
+		// This runs before the leaders themselves move, so blocks follow the leader's desired coordinate.
+		auto awakeGroup = GetAwakeGroup(registry);
+		for (auto leaderEnt : awakeGroup)
 		{
-			std::vector<Components::Coordinate> coordinates;
-			auto& oTetromino = registry.get<Components::OTetromino>(leaderEnt);
-			bool bFoundAtLeastOne = false;
+			if (registry.all_of<Components::Follower>(leaderEnt))
+				continue;
 
-			for (int i = 0; i < 4; i++)
-			{
-				entt::entity blockEnt = oTetromino.GetBlock(i);
-				auto& coordinate = registry.get<Components::Coordinate>(blockEnt);
-				
-				// We're doing this manually instead of using a set.insert because of some possible issues with coordinate's less than comparison. TODO FIXME
-				for (Components::Coordinate coord : coordinates)
-				{
-					if (coord == coordinate)
-						bFoundAtLeastOne = true;
+			auto* leader = GetTetrominoFromEntity(registry, leaderEnt);
+			if (leader == NULL)
+				continue;
 
-					coordinates.push_back(coordinate);
-				}
-			}
-
-			if (bFoundAtLeastOne)
-			{
-				int q = 0;
-				q++;
-			}
-		}*/
-
-		/*auto followerView2 = registry.view<Components::Moveable, Components::Coordinate, Components::Follower>();
-		for (auto entity : followerView2)
-		{
-			auto& moveable = followerView2.get<Components::Moveable>(entity);
-			auto& coordinate = followerView2.get<Components::Coordinate>(entity);
-			auto& follower = followerView2.get<Components::Follower>(entity);
+			const auto& leaderDesired = awakeGroup.get<Components::Moveable>(leaderEnt).GetDesiredCoordinate();
 
-			if (moveable.IsEnabled() && coordinate.IsEnabled() && follower.IsEnabled())
+			std::array<glm::vec2, 4> blockOffsets;
+			for (int i = 0; i < 4; i++)
 			{
+				blockOffsets[i] = leader->GetBlockOffsetCoordinates(leader->GetCurrentOrientation(), i);
 			}
-		}*/
-
-		auto followerView3 = registry.view<Components::Moveable, Components::Coordinate, Components::Follower>();
-		for (auto entity : followerView3)
-		{
-			auto& moveable = followerView3.get<Components::Moveable>(entity);
-			auto& coordinate = followerView3.get<Components::Coordinate>(entity);
-			auto& follower = followerView3.get<Components::Follower>(entity);
 
-			if (moveable.IsEnabled() && coordinate.IsEnabled() && follower.IsEnabled())
+			for (int i = 0; i < 4; i++)
 			{
-				if (moveable.GetMovementState() == Components::movementStates_t::UNMOVING)
+				const entt::entity entity = leader->GetBlock(i);
+				if (entity == entt::null || !registry.valid(entity))
 					continue;
 
-				if (!IsEntityTetromino(registry, follower.Get()))
+				auto* moveable = registry.try_get<Components::Moveable>(entity);
+				auto* coordinate = registry.try_get<Components::Coordinate>(entity);
+				auto* follower = registry.try_get<Components::Follower>(entity);
+				if (moveable == NULL || coordinate == NULL || follower == NULL || follower->Get() != leaderEnt)
 					continue;
 
-				auto* leader = GetTetrominoFromEntity(registry, follower.Get());
-				auto& leaderMoveable = registry.get<Components::Moveable>(follower.Get());
-
-				int i;
-				for (i = 0; i < 4; i++)
-				{
-					if (leader->GetBlock(i) == entity)
-					{
-						break;
-					}
-				}
+				if (!moveable->IsEnabled() || !coordinate->IsEnabled() || !follower->IsEnabled())
+					continue;
 
-				auto offsetCoordinate = Components::Coordinate(leaderMoveable.GetDesiredCoordinate().GetParent(),
-					(glm::vec2)leaderMoveable.GetDesiredCoordinate().Get() + leader->GetBlockOffsetCoordinates(leader->GetCurrentOrientation(), i));
+				if (moveable->GetMovementState() == Components::movementStates_t::UNMOVING)
+					continue;
 
-				moveable.SetDesiredCoordinate(offsetCoordinate);
-				if (moveable.GetCurrentCoordinate() != moveable.GetDesiredCoordinate())
+				moveable->SetDesiredCoordinate(Components::Coordinate(leaderDesired.GetParent(), (glm::vec2)leaderDesired.Get() + blockOffsets[i]));
+				if (moveable->GetCurrentCoordinate() != moveable->GetDesiredCoordinate())
 				{
 					// Need to detect if a move is allowed before permitting it.
-					coordinate = moveable.GetDesiredCoordinate();
-					moveable.SetCurrentCoordinate(coordinate);
+					ClearOccupantAtCoordinates(registry, *coordinate, entity);
+					*coordinate = moveable->GetDesiredCoordinate();
+					SetOccupantAtCoordinates(registry, *coordinate, entity);
+					moveable->SetCurrentCoordinate(*coordinate);
 				}
 			}
 		}
 
-		auto moveableView = registry.view<Components::Moveable, Components::Coordinate>(entt::exclude<Components::Follower>);
-		for (auto entity : moveableView)
+		for (auto entity : awakeGroup)
 		{
-			auto& moveable = moveableView.get<Components::Moveable>(entity);
-			auto& coordinate = moveableView.get<Components::Coordinate>(entity);
+			if (registry.all_of<Components::Follower>(entity))
+				continue;
+
+			auto& moveable = awakeGroup.get<Components::Moveable>(entity);
+			auto& coordinate = awakeGroup.get<Components::Coordinate>(entity);
 
 			if (moveable.IsEnabled() && coordinate.IsEnabled())
 			{
@@ -144,7 +105,9 @@ namespace Systems
 					if (moveable.GetCurrentCoordinate() != moveable.GetDesiredCoordinate())
 					{
 						// Need to detect if a move is allowed before permitting it.
+						ClearOccupantAtCoordinates(registry, coordinate, entity);
 						coordinate = moveable.GetDesiredCoordinate();
+						SetOccupantAtCoordinates(registry, coordinate, entity);
 						moveable.SetCurrentCoordinate(coordinate);
 
 						if (moveable.GetMovementState() == Components::movementStates_t::DEBUG_MOVE_UP ||
@@ -158,7 +121,9 @@ namespace Systems
 				case Components::movementStates_t::HARD_DROP:
 				{
 					// Just comparing Current and Desired isn't good enough. But maybe not checking at all is fine?
+					ClearOccupantAtCoordinates(registry, coordinate, entity);
 					coordinate = moveable.GetDesiredCoordinate();
+					SetOccupantAtCoordinates(registry, coordinate, entity);
 					moveable.SetCurrentCoordinate(coordinate);
 					if (registry.all_of<Components::Obstructable>(entity))
 					{
@@ -176,10 +141,9 @@ namespace Systems
 							aPieceMoved = true;
 						}
 
-						if (IsEntityTetromino(registry, entity))
+						auto* tetromino = GetTetrominoFromEntity(registry, entity);
+						if (tetromino != NULL)
 						{
-							auto* tetromino = GetTetrominoFromEntity(registry, entity);
-
 							if (!tetromino->GetAreAllBlocksObstructed(registry))
 							{
 								tetromino->SetAllBlocksLastObstructedTime(registry, currentFrameTime + lockdownDelay);
@@ -1,99 +1,113 @@
 #include "Systems/PatternSystem.h"
 #include "Systems/SystemShared.h"
 #include "Utility.h"
-
-#include <unordered_map>
+#include "Bitboard.h"
 
 namespace Systems
 {
-	int PatternSystem(entt::registry& registry, unsigned int lineWidth, double currentFrameTime)
+	// Every block in the line must be locked for it to count. One that's still settling means the line isn't complete yet.
+	bool IsLineLocked(entt::registry& registry, const Components::Container& container, const bool& horizontal, const unsigned int& line)
 	{
-		// linePattern[parentEntity][y][x] = blockEntity (Note y,x ordering, not x,y.)
-		// East-West. So y,x, not x,y. Horizontal
-		auto linePatternEW = unordered_map<entt::entity, std::unordered_map<glm::uint, std::unordered_map<glm::uint, entt::entity>>>();
-		// North-South. So, x,y, not y,x. Vertical
-		auto linePatternNS = unordered_map<entt::entity, std::unordered_map<glm::uint, std::unordered_map<glm::uint, entt::entity>>>();
-
-		auto blockView = registry.view<Components::Block>();
-		for (auto entity : blockView)
+		const auto& dimensions = container.GetGridDimensions();
+		const unsigned int lineLength = horizontal ? dimensions.x : dimensions.y;
+
+		for (unsigned int i = 0; i < lineLength; i++)
 		{
-			auto& block = blockView.get<Components::Block>(entity);
-			auto& moveable = registry.get<Components::Moveable>(entity);
-			auto& coordinate = registry.get<Components::Coordinate>(entity);
+			const glm::uvec2 coordinates = horizontal ? glm::uvec2(i, line) : glm::uvec2(line, i);
+			if (!container.IsBlockBitSet(coordinates))
+				continue;
 
-			if (block.IsEnabled() && moveable.IsEnabled() && coordinate.IsEnabled())
-			{
-				if (moveable.GetMovementState() == Components::movementStates_t::LOCKED)
-				{
-					if (coordinate.GetParent() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX))) // Don't pattern anything not in the play area matrix
-						continue;
-
-					linePatternEW[coordinate.GetParent()][coordinate.Get().y][coordinate.Get().x] = entity;
-					linePatternNS[coordinate.GetParent()][coordinate.Get().x][coordinate.Get().y] = entity;
-				}
-			}
+			const entt::entity ent = container.GetOccupantAt(coordinates);
+			if (ent == entt::null || !registry.valid(ent))
+				return false;
+
+			if (registry.all_of<Components::Locked>(ent))
+				continue;
+
+			const auto& block = registry.get<Components::Block>(ent);
+			const auto& moveable = registry.get<Components::Moveable>(ent);
+			if (!block.IsEnabled() || !moveable.IsEnabled() || moveable.GetMovementState() != Components::movementStates_t::LOCKED)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Candidate full lines straight off the occupancy bitmask, when the board fits in a word per row. A line is full when it holds exactly lineWidth blocks.
+	// Returns false when the board's too large for the kernels, leaving the fill counters to decide.
+	bool FindFullLines(const Components::Container& container, const bool& horizontal, const unsigned int& lineWidth, uint64_t& fullLines)
+	{
+		const auto& dimensions = container.GetGridDimensions();
+		const unsigned int lineCount = horizontal ? dimensions.y : dimensions.x;
+		const unsigned int lineLength = horizontal ? dimensions.x : dimensions.y;
+		const uint64_t* rows = container.GetBlockRowData();
+
+		if (rows == nullptr || container.GetWordsPerRow() != 1 || lineCount > 64 || lineWidth == 0 || lineWidth > lineLength)
+			return false;
+
+		if (horizontal)
+		{
+			fullLines = Bitboard::FindRowsWithCount(rows, lineCount, lineWidth);
+		}
+		else
+		{
+			fullLines = Bitboard::FindColumnsWithCount(rows, lineLength, lineWidth) & Bitboard::SpanMask(0, lineCount);
 		}
 
+		return true;
+	}
+
+	int PatternSystem(entt::registry& registry, unsigned int lineWidth, double currentFrameTime)
+	{
+		// Don't pattern anything not in the play area matrix
+		const auto& matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+		if (matrixEnt == entt::null || !registry.all_of<Components::Container>(matrixEnt))
+			return 0;
+
 		const auto& playAreaEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA));
 		if (playAreaEnt == entt::null)
 			throw std::runtime_error("Play Area entity is null!");
 		auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaEnt);
 
+		const auto& container = registry.get<Components::Container>(matrixEnt);
+		const auto& dimensions = container.GetGridDimensions();
+
+		// North/South orientation deals with East/West lines (rows). East/West orientation deals with North/South lines (columns).
+		const bool horizontal = playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH;
+		const unsigned int lineCount = horizontal ? dimensions.y : dimensions.x;
+		const unsigned int lineLength = horizontal ? dimensions.x : dimensions.y;
+
+		uint64_t fullLines = 0;
+		const bool useKernel = FindFullLines(container, horizontal, lineWidth, fullLines);
+
 		int linesMatched = 0;
-		if (playAreaDirection.GetCurrentOrientation() == moveDirection_t::NORTH || playAreaDirection.GetCurrentOrientation() == moveDirection_t::SOUTH)
-		{ // North/South orientation. Deal with East/West lines.
-			if (linePatternEW.size() > 0)
+		for (unsigned int line = 0; line < lineCount; line++)
+		{
+			// Check if we've got a full line here...
+			if (useKernel)
 			{
-				// Ensure we're checking within the same parent container
-				for (auto& parent : linePatternEW)
-				{
-					// Check how many blocks are in each row with at least one
-					for (auto& row : linePatternEW.at(parent.first))
-					{
-						// Check if we've got a full line here...
-						size_t sizeOfLine = linePatternEW.at(parent.first).at(row.first).size();
-						if (sizeOfLine == lineWidth)
-						{
-							linesMatched++;
-
-							// We're not actually interested in the column here, we want the entity id.
-							for (auto& col : linePatternEW.at(parent.first).at(row.first))
-							{
-								const entt::entity& ent = col.second;
-
-								registry.emplace<Components::Hittable>(ent);
-							}
-						}
-					}
-				}
+				if (((fullLines >> line) & 1) == 0)
+					continue;
 			}
-		}
-		else // East || West
-		{ // East/West orientation. Deal with North/South lines.
-			if (linePatternNS.size() > 0)
+			else
+			{
+				const unsigned int sizeOfLine = horizontal ? container.GetRowFill(line) : container.GetColumnFill(line);
+				if (sizeOfLine != lineWidth)
+					continue;
+			}
+
+			if (!IsLineLocked(registry, container, horizontal, line))
+				continue;
+
+			linesMatched++;
+
+			for (unsigned int i = 0; i < lineLength; i++)
 			{
-				// Ensure we're checking within the same parent container
-				for (auto& parent : linePatternNS)
-				{
-					// Check how many blocks are in each column with at least one
-					for (auto& col : linePatternNS.at(parent.first))
-					{
-						// Check if we've got a full line here...
-						size_t sizeOfLine = linePatternNS.at(parent.first).at(col.first).size();
-						if (sizeOfLine == lineWidth)
-						{
-							linesMatched++;
-
-							// We're not actually interested in the row here, we want the entity id.
-							for (auto& row : linePatternNS.at(parent.first).at(col.first))
-							{
-								const entt::entity& ent = row.second;
-
-								registry.emplace<Components::Hittable>(ent);
-							}
-						}
-					}
-				}
+				const glm::uvec2 coordinates = horizontal ? glm::uvec2(i, line) : glm::uvec2(line, i);
+				if (!container.IsBlockBitSet(coordinates))
+					continue;
+
+				registry.emplace<Components::Hittable>(container.GetOccupantAt(coordinates));
 			}
 		}
 
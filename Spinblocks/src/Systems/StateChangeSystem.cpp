@@ -9,6 +9,7 @@ namespace Systems
 	statesChanged_t StateChangeSystem(entt::registry& registry, double currentFrameTime, std::vector<BlockLockData>& blockLockData)
 	{
 		statesChanged_t statesChanged;
+		auto& context = GetGameContext(registry);
 
 		/*auto tetrominoView = registry.view<Components::Moveable, Components::Coordinate>(entt::exclude<Components::Obstructable>);
 		for (auto entity : tetrominoView)
@@ -22,19 +23,26 @@ namespace Systems
 
 		}*/
 
-		auto blockView = registry.view<Components::Obstructable, Components::Moveable, Components::Coordinate>();
-		for (auto entity : blockView)
+		const auto matrixEnt = FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX));
+
+		auto awakeGroup = GetAwakeGroup(registry);
+		for (auto entity : awakeGroup)
 		{
+			if (!registry.all_of<Components::Obstructable>(entity))
+				continue;
+
 			//auto& block = registry.get<Components::Block>(entity);
-			auto& moveable = blockView.get<Components::Moveable>(entity);
-			auto& coordinate = blockView.get<Components::Coordinate>(entity);
-			auto& obstructable = blockView.get<Components::Obstructable>(entity);
+			auto& moveable = awakeGroup.get<Components::Moveable>(entity);
+			auto& coordinate = awakeGroup.get<Components::Coordinate>(entity);
+			auto& obstructable = registry.get<Components::Obstructable>(entity);
 
 			if (moveable.IsEnabled() && coordinate.IsEnabled() && obstructable.IsEnabled())
 			{
-				if (coordinate.GetParent() != FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX))) // Don't fiddle with states if not in the play area matrix
+				if (coordinate.GetParent() != matrixEnt) // Don't fiddle with states if not in the play area matrix
 					continue;
 
+				auto* tetromino = GetTetrominoFromEntity(registry, entity); // Looked up once; NULL for anything that isn't a tetromino.
+
 				switch (moveable.GetMovementState())
 				{
 				case Components::movementStates_t::FALL:
@@ -42,34 +50,31 @@ namespace Systems
 					{
 						moveable.SetMovementState(Components::movementStates_t::LOCKED);
 						registry.remove_if_exists<Components::Controllable>(entity);
-						lastLockdownTime = currentFrameTime;
+						context.lastLockdownTime = currentFrameTime;
 						statesChanged.pieceLocked = true;
 					}
 
-					if (IsEntityTetromino(registry, entity))
+					if (tetromino != NULL)
 					{
-						auto* tetromino = GetTetrominoFromEntity(registry, entity);
-
 						if (tetromino->GetAreAllBlocksObstructed(registry) && currentFrameTime >= tetromino->GetAllBlocksLockdownDelay(registry))
 						{
 							tetromino->SetAllBlocksMovementState(registry, Components::movementStates_t::LOCKED, blockLockData);
-							lastLockdownTime = currentFrameTime;
+							context.lastLockdownTime = currentFrameTime;
 							statesChanged.pieceLocked = true; // This gets called once for a soft drop, seems like it should be okay?
 						}
 					}
 					
 					// Do nothing
-					//lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
+					//context.lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
 					//moveable.SetMovementState(Components::movementStates_t::FALL);
 					break;
 				case Components::movementStates_t::DEBUG_MOVE_UP:
-					lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
+					context.lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
 
 					obstructable.SetIsObstructed(false);
 					moveable.SetMovementState(Components::movementStates_t::FALL); // Reset to falling state for the next tick.
-					if (IsEntityTetromino(registry, entity))
+					if (tetromino != NULL)
 					{
-						auto* tetromino = GetTetrominoFromEntity(registry, entity);
 						tetromino->SetAllBlocksObstructed(registry, false);
 						//tetromino->SetAllBlocksMovementState(registry, Components::movementStates_t::FALL);
 					}
@@ -84,42 +89,38 @@ namespace Systems
 						// This never gets called, probably due to the fall state being set places instead, and the obstructed flag being set from the fall state. Not necessarily a problem.
 						moveable.SetMovementState(Components::movementStates_t::LOCKED);
 						registry.remove_if_exists<Components::Controllable>(entity);
-						lastLockdownTime = currentFrameTime;
+						context.lastLockdownTime = currentFrameTime;
 
-						if (IsEntityTetromino(registry, entity))
+						if (tetromino != NULL)
 						{
-							auto* tetromino = GetTetrominoFromEntity(registry, entity);
-
 							if (tetromino->GetAreAllBlocksObstructed(registry))
 							{
 								tetromino->SetAllBlocksMovementState(registry, Components::movementStates_t::LOCKED, blockLockData);
-								lastLockdownTime = currentFrameTime;
+								context.lastLockdownTime = currentFrameTime;
 								statesChanged.pieceLocked = true;
 							}
 						}
 					}
 					else
 					{
-						lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
+						context.lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
 						//block.SetIsFallingObstructed(false);
 						moveable.SetMovementState(Components::movementStates_t::FALL); // Reset to falling state for the next tick.
 						statesChanged.pieceMoved = true;
 					}
 					break;
 				case Components::movementStates_t::HARD_DROP:
-					lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
+					context.lastFallUpdate = currentFrameTime; // Reset the fall time, to avoid a change of state here resulting in an immediate fall, which manifests as a double-move, which feels bad.
 					moveable.SetMovementState(Components::movementStates_t::LOCKED);
 					registry.remove_if_exists<Components::Controllable>(entity);
-					lastLockdownTime = currentFrameTime;
+					context.lastLockdownTime = currentFrameTime;
 
-					if (IsEntityTetromino(registry, entity))
+					if (tetromino != NULL)
 					{
-						auto* tetromino = GetTetrominoFromEntity(registry, entity);
-
 						if (tetromino->GetAreAllBlocksObstructed(registry))
 						{
 							tetromino->SetAllBlocksMovementState(registry, Components::movementStates_t::LOCKED, blockLockData);
-							lastLockdownTime = currentFrameTime;
+							context.lastLockdownTime = currentFrameTime;
 							statesChanged.pieceMoved = true;
 							statesChanged.peiceHardDropped = true; // This gets called once for a hard drop, seems like it should be okay?
 						}
@@ -132,24 +133,38 @@ namespace Systems
 		}
 
 		// Kill tetrominoes, leaving their blocks behind, after they're locked down.
-		auto tetrominoView = registry.view<Components::Moveable, Components::Coordinate>(entt::exclude<Components::Obstructs>);
-		for (auto entity : tetrominoView)
+		for (auto entity : awakeGroup)
 		{
-			if (!IsEntityTetromino(registry, entity)) // There should be a better way to do this. Look into it later. FIXME TODO
+			if (registry.all_of<Components::Obstructs>(entity))
 				continue;
 
 			auto* tetromino = GetTetrominoFromEntity(registry, entity);
-			if (tetromino->GetAreAllBlocksLocked(registry))
+			if (tetromino != NULL && tetromino->GetAreAllBlocksLocked(registry))
 			{
 				for (int i = 0; i < 4; i++)
 				{
 					registry.remove_if_exists<Components::Follower>(tetromino->GetBlock(i));
+					SetOccupantAtCoordinates(registry, GetCoordinateOfEntity(registry, tetromino->GetBlock(i)), tetromino->GetBlock(i)); // Now settled, so it's on the occupancy bitmask.
 				}
 
 				registry.destroy(entity);
 			}
 		}
 
+		// Whatever has come to rest drops out of the awake group, until something sets it moving again.
+		// Blocks that have settled into the stack are tagged Locked on the way out.
+		for (auto entity : awakeGroup)
+		{
+			const auto movementState = awakeGroup.get<Components::Moveable>(entity).GetMovementState();
+			if (movementState != Components::movementStates_t::LOCKED && movementState != Components::movementStates_t::UNMOVING)
+				continue;
+
+			if (movementState == Components::movementStates_t::LOCKED && registry.all_of<Components::Block>(entity) && !registry.all_of<Components::Follower>(entity))
+				registry.emplace<Components::Locked>(entity);
+
+			registry.remove<Components::Awake>(entity);
+		}
+
 		return statesChanged;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "ThreadPool.h"
+
+#include <exception>
+
+namespace
+{
+	// Which pool the current thread works for, if any, and its queue in that pool.
+	thread_local const ThreadPool* currentPool = nullptr;
+	thread_local unsigned int currentWorkerIndex = 0;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0)
+		threadCount = 1;
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_queues.push_back(std::make_unique<workerQueue_t>());
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	try
+	{
+		Wait();
+	}
+	catch (...)
+	{ // Nobody's left to hand it to.
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+bool ThreadPool::IsWorker() const
+{
+	return currentPool == this;
+}
+
+unsigned int ThreadPool::GetCurrentWorkerIndex() const
+{
+	return IsWorker() ? currentWorkerIndex : static_cast<unsigned int>(m_queues.size());
+}
+
+// Newest first from our own queue, oldest first from anyone else's.
+bool ThreadPool::TakeTask(const unsigned int& queueIndex, std::function<void()>& task)
+{
+	const unsigned int queueCount = static_cast<unsigned int>(m_queues.size());
+
+	if (queueIndex < queueCount)
+	{
+		auto& own = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			m_queued--;
+			return true;
+		}
+	}
+
+	const unsigned int start = queueIndex < queueCount ? queueIndex + 1 : 0;
+	for (unsigned int i = 0; i < queueCount; i++)
+	{
+		auto& victim = *m_queues[(start + i) % queueCount];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			m_queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ThreadPool::RunPendingTask()
+{
+	if (m_queued == 0)
+		return false;
+
+	std::function<void()> task;
+	if (!TakeTask(GetCurrentWorkerIndex(), task))
+		return false;
+
+	try
+	{
+		task();
+	}
+	catch (...)
+	{ // Keep the first for Wait. Letting it go any further would take the worker, and the whole process, with it.
+		std::lock_guard<std::mutex> lock(m_doneMutex);
+		if (!m_failure)
+			m_failure = std::current_exception();
+	}
+
+	if (--m_unfinished == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_doneMutex);
+		m_done.notify_all();
+	}
+	return true;
+}
+
+void ThreadPool::WorkerLoop(const unsigned int& workerIndex)
+{
+	currentPool = this;
+	currentWorkerIndex = workerIndex;
+
+	while (true)
+	{
+		if (RunPendingTask())
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wake.wait(lock, [this] { return m_stopping || m_queued > 0; });
+		if (m_stopping && m_queued == 0)
+			return;
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	const unsigned int queueCount = static_cast<unsigned int>(m_queues.size());
+	unsigned int queueIndex = GetCurrentWorkerIndex();
+	if (queueIndex >= queueCount)
+		queueIndex = m_nextQueue++ % queueCount;
+
+	m_unfinished++;
+	{
+		auto& queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+		m_queued++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wake.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	if (IsWorker())
+	{ // Nested waits need the waiting worker to keep running tasks, or the pool could end up with every worker waiting.
+		while (m_unfinished > 0)
+		{
+			if (!RunPendingTask())
+				std::this_thread::yield();
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_doneMutex);
+	m_done.wait(lock, [this] { return m_unfinished == 0; });
+
+	if (m_failure)
+	{
+		std::exception_ptr failure = m_failure;
+		m_failure = nullptr;
+		std::rethrow_exception(failure);
+	}
+}
+
+void ThreadPool::ParallelFor(const size_t& count, const std::function<void(size_t)>& func)
+{
+	std::atomic<size_t> remaining{ count };
+	std::mutex doneMutex;
+	std::condition_variable done;
+	std::mutex failureMutex;
+	std::exception_ptr failure;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Submit([&func, &remaining, &doneMutex, &done, &failureMutex, &failure, i]
+			{
+				try
+				{
+					func(i);
+				}
+				catch (...)
+				{ // Keep the first, and hand it back to the caller once everything's finished.
+					std::lock_guard<std::mutex> lock(failureMutex);
+					if (!failure)
+						failure = std::current_exception();
+				}
+
+				// Under the lock, so the caller can't see the count reach 0 and return while this is still signalling.
+				std::lock_guard<std::mutex> lock(doneMutex);
+				if (--remaining == 0)
+					done.notify_all();
+			});
+	}
+
+	if (IsWorker())
+	{
+		while (remaining > 0)
+		{
+			if (!RunPendingTask())
+				std::this_thread::yield();
+		}
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(doneMutex);
+		done.wait(lock, [&remaining] { return remaining == 0; });
+	}
+
+	if (failure)
+		std::rethrow_exception(failure);
+}
\ No newline at end of file
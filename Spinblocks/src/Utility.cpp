@@ -1,6 +1,10 @@
 #include "Utility.h"
 
+#ifndef HEADLESS
 #include "AudioManager.h"
+#endif
+
+#include <iostream>
 
 void RotatePiece(entt::registry& registry, const rotatePiece_t& rotatePiece)
 {
@@ -30,31 +34,35 @@ void RotatePiece(entt::registry& registry, const rotatePiece_t& rotatePiece)
 	}
 	catch (std::runtime_error ex)
 	{
-		cerr << ex.what() << endl;
+		std::cerr << ex.what() << std::endl;
 	}
 
-	bool atLeastOneBlockObstructed = false;
+	// All the blocks share a container, so the whole rotated piece can be checked against its occupancy bitmask at once.
+	const auto& blockParentEnt = registry.get<Components::Coordinate>(tetromino->GetBlock(0)).GetParent();
+	std::array<glm::ivec2, 4> rotatedCells;
 	for (int i = 0; i < 4; i++)
 	{
-		auto& blockEnt = tetromino->GetBlock(i);
-		auto& blockCoord = registry.get<Components::Coordinate>(blockEnt);
-
-		auto offsetCoordinate = Components::Coordinate(blockCoord.GetParent(),
-			(glm::vec2)blockCoord.Get() +
-			tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i, 0, rotatePiece == rotatePiece_t::ROTATE_CLOCKWISE ? rotationDirection_t::CLOCKWISE : rotationDirection_t::COUNTERCLOCKWISE));
+		auto& blockCoord = registry.get<Components::Coordinate>(tetromino->GetBlock(i));
 
-		auto cellEnt = GetCellAtCoordinates2(registry, offsetCoordinate);
-		if (!CanOccupyCell(registry, blockEnt, cellEnt))
-			atLeastOneBlockObstructed = true;
+		rotatedCells[i] = glm::ivec2(blockCoord.Get()) + glm::ivec2(
+			tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i, rotatePiece == rotatePiece_t::ROTATE_CLOCKWISE ? rotationDirection_t::CLOCKWISE : rotationDirection_t::COUNTERCLOCKWISE));
 	}
 
+	bool atLeastOneBlockObstructed = true;
+	if (registry.valid(blockParentEnt) && registry.all_of<Components::Container>(blockParentEnt))
+		atLeastOneBlockObstructed = !AreTetrominoCellsFree(registry.get<Components::Container>(blockParentEnt), rotatedCells);
+
 	if (!atLeastOneBlockObstructed)
 	{ // Quick and dirty, rather than handling through a system. Refactor later. FIXME TODO
 		tetromino->SetDesiredOrientation(desiredOrientation);
 		tetromino->SetCurrentOrientation(tetromino->GetDesiredOrientation());
-#ifndef DO_NOT_TEST
-		audioData_t audioRotate = audioManager.GetSound(audioAsset_t::SOUND_ROTATE, audioChannel_t::SOUND, false, true);
-		audioManager.PlaySound(audioRotate);
+#if !defined(DO_NOT_TEST) && !defined(HEADLESS)
+		AudioManager* audioManager = GetGameContext(registry).audioManager;
+		if (audioManager != nullptr)
+		{
+			audioData_t audioRotate = audioManager->GetSound(audioAsset_t::SOUND_ROTATE, audioChannel_t::SOUND, false, true);
+			audioManager->PlaySound(audioRotate);
+		}
 #endif
 	}
 }
@@ -64,7 +72,6 @@ void RotatePiece(entt::registry& registry, const rotatePiece_t& rotatePiece)
 void MovePiece(entt::registry& registry, const movePiece_t& movePiece)
 {
 	auto controllableView = registry.view<Components::Controllable, Components::Moveable>();
-	auto cellView = registry.view<Components::Cell, Components::Coordinate>();
 	for (auto entity1 : controllableView)
 	{
 		auto& controllable = controllableView.get<Components::Controllable>(entity1);
@@ -72,59 +79,93 @@ void MovePiece(entt::registry& registry, const movePiece_t& movePiece)
 
 		if (controllable.IsEnabled() && moveable.IsEnabled())
 		{
-			for (auto entity2 : cellView)
-			{
-				auto& cell = cellView.get<Components::Cell>(entity2);
-				auto& coordinate = cellView.get<Components::Coordinate>(entity2);
-				//std::string tagOfContainerEntity = FindTagOfContainerEntity(registry, cell.GetParent());
+			// Only move if we're sitting on a cell of the container we're controlled in. Looked up directly, rather than searching every cell.
+			if (controllable.Get() != moveable.GetCurrentCoordinate().GetParent())
+				continue;
+
+			if (GetCellAtCoordinates2(registry, moveable.GetCurrentCoordinate()) == entt::null)
+				continue;
 
-				if (cell.IsEnabled() && coordinate.IsEnabled())
+			auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(moveable.GetCurrentCoordinate().GetParent());
+			auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
+
+			try
+			{
+				switch (movePiece)
 				{
-					if (controllable.Get() == cell.GetParent())
-					{
-						if (moveable.GetCurrentCoordinate() == coordinate)
-						{
-
-							auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(moveable.GetCurrentCoordinate().GetParent());
-							auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
-
-							try
-							{
-								switch (movePiece)
-								{
-								case movePiece_t::MOVE_LEFT:
-									moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentLeftDirection(), 1)));
-									break;
-								case movePiece_t::MOVE_RIGHT:
-									moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentRightDirection(), 1)));
-									break;
-								case movePiece_t::MOVE_UP:
-									moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentUpDirection(), 1)));
-									moveable.SetMovementState(Components::movementStates_t::DEBUG_MOVE_UP);
-									break;
-								case movePiece_t::SOFT_DROP:
-									moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentDownDirection(), 1)));
-									moveable.SetMovementState(Components::movementStates_t::SOFT_DROP);
-									break;
-								case movePiece_t::HARD_DROP:
-								{
-									moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentDownDirection(), PlayAreaHeight + (BufferAreaDepth * 2)))); // PlayAreaHeight is a const of 20. This is fine to be excessive with when the height is lower.
-									moveable.SetMovementState(Components::movementStates_t::HARD_DROP); // Hard drop state even if we're not able to move. We did trigger this.
-									break;
-								}
-								default:
-									break;
-								}
-							}
-							catch (std::runtime_error ex)
-							{
-								cerr << ex.what() << endl;
-							}
-						}
-					}
+				case movePiece_t::MOVE_LEFT:
+					moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentLeftDirection(), 1)));
+					break;
+				case movePiece_t::MOVE_RIGHT:
+					moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentRightDirection(), 1)));
+					break;
+				case movePiece_t::MOVE_UP:
+					moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentUpDirection(), 1)));
+					moveable.SetMovementState(Components::movementStates_t::DEBUG_MOVE_UP);
+					break;
+				case movePiece_t::SOFT_DROP:
+					moveable.SetDesiredCoordinate(GetCoordinateOfEntity(registry, MoveBlockInDirection(registry, entity1, playAreaDirection.GetCurrentDownDirection(), 1)));
+					moveable.SetMovementState(Components::movementStates_t::SOFT_DROP);
+					break;
+				case movePiece_t::HARD_DROP:
+				{
+					moveable.SetDesiredCoordinate(GetLandingCoordinate(registry, entity1)); // Straight from the occupancy bitmasks, the same landing the ghost shows.
+					moveable.SetMovementState(Components::movementStates_t::HARD_DROP); // Hard drop state even if we're not able to move. We did trigger this.
+					break;
+				}
+				default:
+					break;
 				}
 			}
+			catch (std::runtime_error ex)
+			{
+				std::cerr << ex.what() << std::endl;
+			}
+
+			// Last, as waking reorders the awake group's Moveable storage out from under the reference above.
+			WakeEntity(registry, entity1);
+		}
+	}
+}
+
+// Does what the matching key does in the game client, without the key repeat handling.
+void ApplyPlayerInput(entt::registry& registry, const playerInput_t& playerInput)
+{
+	switch (playerInput)
+	{
+	case playerInput_t::MOVE_LEFT:
+		MovePiece(registry, movePiece_t::MOVE_LEFT);
+		break;
+	case playerInput_t::MOVE_RIGHT:
+		MovePiece(registry, movePiece_t::MOVE_RIGHT);
+		break;
+	case playerInput_t::SOFT_DROP:
+	case playerInput_t::HARD_DROP:
+	{
+		auto controllableView = registry.view<Components::Controllable, Components::Moveable>();
+		for (auto entity : controllableView)
+		{
+			auto& controllable = controllableView.get<Components::Controllable>(entity);
+			auto& moveable = controllableView.get<Components::Moveable>(entity);
+
+			if (controllable.IsEnabled() && moveable.IsEnabled())
+			{
+				moveable.SetMovementState(Components::movementStates_t::FALL);
+			}
 		}
+
+		MovePiece(registry, playerInput == playerInput_t::SOFT_DROP ? movePiece_t::SOFT_DROP : movePiece_t::HARD_DROP);
+		break;
+	}
+	case playerInput_t::ROTATE_COUNTERCLOCKWISE:
+		RotatePiece(registry, rotatePiece_t::ROTATE_COUNTERCLOCKWISE);
+		break;
+	case playerInput_t::ROTATE_CLOCKWISE:
+		RotatePiece(registry, rotatePiece_t::ROTATE_CLOCKWISE);
+		break;
+	case playerInput_t::NONE:
+	default:
+		break;
 	}
 }
 
@@ -210,7 +251,7 @@ entt::entity FindContainerEntityByTag(entt::registry& registry, const std::strin
 
 entt::entity FindEntityByTag(entt::registry& registry, const std::string& tagName)
 {
-	return cachedTagLookup.Get(registry, tagName);
+	return GetGameContext(registry).tagLookup.Get(registry, tagName);
 }
 
 const std::string FindTagOfContainerEntity(entt::registry& registry, const entt::entity& containerEntity)
@@ -254,50 +295,19 @@ bool IsEntityTetromino(entt::registry& registry, entt::entity ent)
 	if (!registry.valid(ent)) // This should never happen, yet it is. FIXME TODO
 		return false;
 
-	return registry.any_of</*Components::Tetromino, */
-		Components::OTetromino, 
-		Components::ITetromino,
-		Components::TTetromino,
-		Components::LTetromino,
-		Components::JTetromino,
-		Components::STetromino,
-		Components::ZTetromino>(ent);
+	return registry.all_of<Components::Tetromino>(ent);
 }
 
 Components::Tetromino* GetTetrominoFromEntity(entt::registry& registry, entt::entity entity)
 {
-	if (entity == entt::null)
+	if (entity == entt::null || !registry.valid(entity))
 		return NULL;
 
-	if (!IsEntityTetromino(registry, entity))
-		return NULL;
-
-	if (registry.all_of<Components::OTetromino>(entity))
-		return &registry.get<Components::OTetromino>(entity);
-
-	if (registry.all_of<Components::ITetromino>(entity))
-		return &registry.get<Components::ITetromino>(entity);
-
-	if (registry.all_of<Components::TTetromino>(entity))
-		return &registry.get<Components::TTetromino>(entity);
-
-	if (registry.all_of<Components::LTetromino>(entity))
-		return &registry.get<Components::LTetromino>(entity);
-
-	if (registry.all_of<Components::JTetromino>(entity))
-		return &registry.get<Components::JTetromino>(entity);
-
-	if (registry.all_of<Components::STetromino>(entity))
-		return &registry.get<Components::STetromino>(entity);
-
-	if (registry.all_of<Components::ZTetromino>(entity))
-		return &registry.get<Components::ZTetromino>(entity);
-
-	return NULL;
+	return registry.try_get<Components::Tetromino>(entity);
 }
 
 // Take a closer look at this and CanOccupyCell tomorrow....
-bool IsAnyBlockInTetrominoObstructingSelf(entt::registry& registry, entt::entity entity, const entt::entity& cellEntity, const bool& disableObstruction)
+bool IsAnyBlockInTetrominoObstructingSelf(entt::registry& registry, entt::entity entity, const entt::entity& cellEntity)
 {
 	if (entity == entt::null)
 		return false;
@@ -306,103 +316,9 @@ bool IsAnyBlockInTetrominoObstructingSelf(entt::registry& registry, entt::entity
 		return false;
 
 	Components::Tetromino* tetromino = GetTetrominoFromEntity(registry, entity);
-	auto& tmoveable = registry.get<Components::Moveable>(entity);
-
 	auto& cellCoord = registry.get<Components::Coordinate>(cellEntity);
-	
-	//tetromino->
-
-	//bool bFoundAtLeastOneObstruction = false;
-	for (int i = 0; i < 4; i++)
-	{
-		auto offsetCoordinate = Components::Coordinate(cellCoord.GetParent(),
-			(glm::vec2)cellCoord.Get() + tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i));
-
-
-
-		//auto& block = registry.get<Components::Block>(tetromino->GetBlock(i));
-		auto& moveable = registry.get<Components::Moveable>(tetromino->GetBlock(i));
-		auto& coordinate = registry.get<Components::Coordinate>(tetromino->GetBlock(i));
-		//auto& follower = registry.get<Components::Follower>(tetromino->GetBlock(i));
-
-		entt::entity cellEnt = GetCellAtCoordinates2(registry, offsetCoordinate);// coordinate);
-
-		if (!CanOccupyCell(registry, tetromino->GetBlock(i), cellEnt))
-			return false;
-	}
-
-	return true;
-
-	/*
-	
-	entt::entity MoveBlockInDirection(entt::registry& registry, const entt::entity& blockEnt, const moveDirection_t& direction, const unsigned int& distance, const bool& disableObstruction)
-{
-	auto coordinate = registry.get<Components::Coordinate>(blockEnt); // We do NOT want a reference here, we want a copy.
-	//auto& moveable = registry.get<Components::Moveable>(blockEnt);
 
-	entt::entity cellEnt = GetCellAtCoordinates2(registry, coordinate);
-	if (cellEnt == entt::null)
-		return entt::null;
-
-	entt::entity newCellEnt = cellEnt;
-
-	for (unsigned int i = 0; i < distance; i++)
-	{
-		// We're moving a bunch in this function. Update our current coordiantes while doing so.
-		if (i > 0 && registry.all_of<Components::Coordinate>(newCellEnt))
-		{
-			const auto& newCoordinate = registry.get<Components::Coordinate>(newCellEnt);
-			coordinate.Set(newCoordinate.Get());
-			coordinate.SetParent(newCoordinate.GetParent());
-		}
-
-		entt::entity tempCellEnt = newCellEnt;
-		if (!registry.all_of<Components::Cell>(tempCellEnt))
-			continue;
-		const auto& tempCell = registry.get<Components::Cell>(tempCellEnt);
-
-		newCellEnt = MoveBlockInDirection2(registry, blockEnt, direction, coordinate, newCellEnt, tempCell, disableObstruction);
-	}
-
-	return newCellEnt;
-	
-	*/
-
-
-	/*
-	auto followerView = registry.view<Components::Moveable, Components::Coordinate, Components::Follower>();
-	for (auto entity : followerView)
-	{
-		auto& moveable = followerView.get<Components::Moveable>(entity);
-		auto& coordinate = followerView.get<Components::Coordinate>(entity);
-		auto& follower = followerView.get<Components::Follower>(entity);
-
-		if (moveable.IsEnabled() && coordinate.IsEnabled() && follower.IsEnabled())
-		{
-			auto& leader = registry.get<Components::OTetromino>(follower.Get()); // FIXME TODO tetromino type issue.
-			auto& leaderMoveable = registry.get<Components::Moveable>(follower.Get());
-
-			int i;
-			for (i = 0; i < 4; i++)
-			{
-				if (leader.GetBlock(i) == entity)
-				{
-					break;
-				}
-			}
-
-			auto offsetCoordinate = Components::Coordinate(leaderMoveable.GetDesiredCoordinate().GetParent(),
-				(glm::vec2)leaderMoveable.GetDesiredCoordinate().Get() + leader.GetBlockOffsetCoordinates(i));
-
-			moveable.SetDesiredCoordinate(offsetCoordinate);
-			if (moveable.GetCurrentCoordinate() != moveable.GetDesiredCoordinate())
-			{
-				// Need to detect if a move is allowed before permitting it.
-				coordinate = moveable.GetDesiredCoordinate();
-				moveable.SetCurrentCoordinate(coordinate);
-			}
-		}
-	}*/
+	return DoesTetrominoFit(registry, entity, cellCoord, tetromino->GetCurrentOrientation());
 }
 
 bool IsAnyBlockInTetrominoObstructed(entt::registry& registry, entt::entity entity)
@@ -447,7 +363,7 @@ bool CanOccupyCell(entt::registry& registry, const entt::entity& blockEnt, const
 	if (IsEntityTetromino(registry, blockEnt))
 	{
 		// Might want this conditional on disableObsruction
-		return IsAnyBlockInTetrominoObstructingSelf(registry, blockEnt, cellEntity, disableObstruction);
+		return IsAnyBlockInTetrominoObstructingSelf(registry, blockEnt, cellEntity);
 	}
 
 	// Don't check for obstructions. Sooooo, we're able to move into here regardless without further checks.
@@ -484,116 +400,248 @@ const Components::Cell& GetCellOfEntity(entt::registry& registry, const entt::en
 
 Components::Cell& GetCellAtCoordinates(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& coordinate)
 {
-	auto cellView = registry.view<Components::Cell, Components::Coordinate>();
-	for (auto entity : cellView)
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt != entt::null && registry.valid(parentEnt) && registry.all_of<Components::Container, Components::Tag>(parentEnt))
 	{
-		auto& cell = cellView.get<Components::Cell>(entity);
-
-		auto& cellCoordinate = registry.get<Components::Coordinate>(entity);
-
-		if (cell.IsEnabled() && cellCoordinate.IsEnabled())
+		auto& tag = registry.get<Components::Tag>(parentEnt); // We'll be wanting to check which container we're working with later. (eg: Play Area, Hold, Preview, (which play area?))
+		if (tag.IsEnabled() && containerTag == tag.Get())
 		{
-			auto& container2 = registry.get<Components::Container>(cell.GetParent());
-			auto& tag = registry.get<Components::Tag>(cell.GetParent()); // We'll be wanting to check which container we're working with later. (eg: Play Area, Hold, Preview, (which play area?))
-			if (!tag.IsEnabled() || containerTag != tag.Get())
-				continue;
-
-			if (cellCoordinate == coordinate)
-			{
-				// We're short circuiting here on the first match. We probably want to check for container first. (eg: When we've got multiple reference containers in use.)
-				return cell;
-			}
+			entt::entity cellEnt = GetCellAtCoordinates2(registry, coordinate);
+			if (cellEnt != entt::null)
+				return registry.get<Components::Cell>(cellEnt);
 		}
 	}
 
 	throw std::runtime_error("Unable to find Cell at coordinates!");
 }
 
+// Constant time lookup through the container's cell index, which BuildGrid() fills in.
 entt::entity GetCellAtCoordinates2(entt::registry& registry, const Components::Coordinate& coordinate)
 {
-	auto cellView = registry.view<Components::Cell, Components::Coordinate>();
-	for (auto entity : cellView)
-	{
-		auto& cell = cellView.get<Components::Cell>(entity);
-		auto& cellCoordinate = cellView.get<Components::Coordinate>(entity);
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt))
+		return entt::null;
 
-		if (cell.IsEnabled() && cellCoordinate.IsEnabled())
-		{
-			if (!registry.all_of<Components::Container>(cell.GetParent()))
-				continue;
-			if (!registry.all_of<Components::Tag>(cell.GetParent()))
-				continue;
+	if (!registry.all_of<Components::Container, Components::Tag>(parentEnt))
+		return entt::null;
 
-			auto& container2 = registry.get<Components::Container>(cell.GetParent());
+	const auto& container = registry.get<Components::Container>(parentEnt);
+	entt::entity cellEnt = container.GetCellAt(coordinate.Get());
+	if (cellEnt == entt::null)
+		return entt::null;
 
-			// The cell we've found shares the same coordinates as what we've specified.
-			if (cellCoordinate == coordinate)
-			{
-				return entity;
-			}
+	const auto& cell = registry.get<Components::Cell>(cellEnt);
+	const auto& cellCoordinate = registry.get<Components::Coordinate>(cellEnt);
+	if (!cell.IsEnabled() || !cellCoordinate.IsEnabled())
+		return entt::null;
+
+	return cellEnt;
+}
+
+const Components::Block& GetBlockAtCoordinates(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& coordinate)
+{
+	entt::entity blockEnt = GetOccupantAtCoordinates(registry, coordinate);
+	if (blockEnt != entt::null)
+	{
+		auto& block = registry.get<Components::Block>(blockEnt);
+		if (block.IsEnabled() && registry.all_of<Components::Tag>(block.Get()))
+		{
+			auto& tag = registry.get<Components::Tag>(block.Get()); // We'll be wanting to check which container we're working with later. (eg: Play Area, Hold, Preview, (which play area?))
+			if (tag.IsEnabled() && containerTag == tag.Get())
+				return block;
 		}
 	}
 
-	return entt::null;
+	throw std::runtime_error("Unable to find Block at coordinates!");
+}
+
+// Returns the obstructing block currently sitting at these coordinates, if any.
+entt::entity GetOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate)
+{
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt))
+		return entt::null;
+
+	if (!registry.all_of<Components::Container>(parentEnt))
+		return entt::null;
+
+	entt::entity occupantEnt = registry.get<Components::Container>(parentEnt).GetOccupantAt(coordinate.Get());
+	if (occupantEnt == entt::null || !registry.valid(occupantEnt))
+		return entt::null;
+
+	// Guard against a stale entry. The index is only trusted if the occupant still agrees about where it is.
+	if (!registry.all_of<Components::Block, Components::Coordinate>(occupantEnt))
+		return entt::null;
+
+	if (registry.get<Components::Coordinate>(occupantEnt) != coordinate)
+		return entt::null;
+
+	return occupantEnt;
+}
+
+// Only obstructing blocks are tracked as occupants. Projections, markers, and the like can overlap them freely.
+// Blocks that aren't following a tetromino are settled, and are also set on the container's occupancy bitmask.
+void SetOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const entt::entity& blockEnt)
+{
+	if (blockEnt == entt::null || !registry.all_of<Components::Block, Components::Obstructs>(blockEnt))
+		return;
+
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt) || !registry.all_of<Components::Container>(parentEnt))
+		return;
+
+	auto& container = registry.get<Components::Container>(parentEnt);
+	const bool settled = !registry.all_of<Components::Follower>(blockEnt);
+
+	// A piece overlapping a settled block, as one does when it spawns into the stack, mustn't take its place in the index or clear its bit.
+	if (!settled && container.IsBlockBitSet(coordinate.Get()))
+		return;
+
+	container.SetOccupantAt(coordinate.Get(), blockEnt);
+	container.SetBlockBit(coordinate.Get(), settled);
+}
+
+// Puts an entity back among those the per-tick systems visit. Anything that sets a settled or parked entity moving again needs to do this.
+void WakeEntity(entt::registry& registry, const entt::entity& entity)
+{
+	if (entity == entt::null || !registry.valid(entity))
+		return;
+
+	registry.remove_if_exists<Components::Locked>(entity);
+	if (!registry.all_of<Components::Awake>(entity))
+		registry.emplace<Components::Awake>(entity);
+}
+
+AwakeGroup GetAwakeGroup(entt::registry& registry)
+{
+	return registry.group<Components::Moveable, Components::Coordinate>(entt::get<Components::Awake>);
+}
+
+// A renderable being added, removed, or patched onto another layer all leave the draw order stale.
+static void MarkRenderOrderDirty(entt::registry& registry, entt::entity entity)
+{
+	GetGameContext(registry).renderOrderDirty = true;
+}
+
+RenderGroup GetRenderGroup(entt::registry& registry)
+{
+	return registry.group<Components::Renderable, Components::Position, Components::Orientation, Components::Scale>();
+}
+
+void TrackRenderOrder(entt::registry& registry)
+{
+	registry.on_construct<Components::Renderable>().connect<&MarkRenderOrderDirty>();
+	registry.on_update<Components::Renderable>().connect<&MarkRenderOrderDirty>();
+	registry.on_destroy<Components::Renderable>().connect<&MarkRenderOrderDirty>();
+}
+
+// Only resorts when something has changed. Renderables coming and going are tracked by signal, and the block pool marks the order stale itself
+// as its blocks leave and rejoin the group. The size check is only a fallback for registries that aren't tracked, and misses as many entities joining as leaving.
+// Insertion sort, since the group's almost always nearly in order already. Within a layer, draws of the same model end up next to each other.
+void SortRenderGroup(entt::registry& registry)
+{
+	auto& context = GetGameContext(registry);
+	auto renderGroup = GetRenderGroup(registry);
+	if (!context.renderOrderDirty && renderGroup.size() == context.renderOrderSize)
+		return;
+
+	renderGroup.sort<Components::Renderable>([](const Components::Renderable& lhs, const Components::Renderable& rhs)
+		{
+			if (lhs.GetLayer() != rhs.GetLayer())
+				return lhs.GetLayer() < rhs.GetLayer();
+
+			return lhs.GetModelKey() < rhs.GetModelKey();
+		}, entt::insertion_sort{});
+
+	context.renderOrderDirty = false;
+	context.renderOrderSize = renderGroup.size();
 }
 
-entt::entity GetCellLinkAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const moveDirection_t& direction)
+// Only clears the entry if it still belongs to this block. Pieces move one block at a time, so another block may have already moved in.
+void ClearOccupantAtCoordinates(entt::registry& registry, const Components::Coordinate& coordinate, const entt::entity& blockEnt)
 {
-	auto cellView = registry.view<Components::CellLink, Components::Coordinate>();
-	for (auto entity : cellView)
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt) || !registry.all_of<Components::Container>(parentEnt))
+		return;
+
+	auto& container = registry.get<Components::Container>(parentEnt);
+	if (container.GetOccupantAt(coordinate.Get()) == blockEnt)
 	{
-		auto& cellCoordinate = cellView.get<Components::Coordinate>(entity);
-		auto& cellLink = cellView.get<Components::CellLink>(entity);
+		container.SetOccupantAt(coordinate.Get(), entt::null);
+		container.SetBlockBit(coordinate.Get(), false);
+	}
+}
 
-		if (cellLink.GetDirection() != direction)
-			continue;
+// Cells sharing a row get folded into a single mask, so checking a whole piece is a handful of ANDs against the occupancy bitmasks.
+bool AreTetrominoCellsFree(const Components::Container& container, const std::array<glm::ivec2, 4>& cells)
+{
+	std::array<unsigned int, 4> rows;
+	std::array<unsigned int, 4> words;
+	std::array<uint64_t, 4> masks;
+	size_t used = 0;
 
-		if (cellCoordinate.IsEnabled() && cellLink.IsEnabled())
+	for (const auto& cell : cells)
+	{
+		if (cell.x < 0 || cell.y < 0)
+			return false;
+
+		const glm::uvec2 cellCoordinate(cell);
+		if (container.GetCellAt(cellCoordinate) == entt::null)
+			return false;
+
+		const unsigned int word = cellCoordinate.x / 64;
+		const uint64_t bit = uint64_t(1) << (cellCoordinate.x % 64);
+
+		size_t i = 0;
+		for (; i < used; i++)
 		{
-			if (registry.all_of<Components::Cell>(cellLink.GetSource()))
+			if (rows[i] == cellCoordinate.y && words[i] == word)
 			{
-				auto& cell = registry.get<Components::Cell>(cellLink.GetSource());
-				if (cell.IsEnabled())
-				{
-					if (cellCoordinate == coordinate)
-					{
-						return entity;
-					}
-				}
+				masks[i] |= bit;
+				break;
 			}
 		}
+
+		if (i == used)
+		{
+			rows[used] = cellCoordinate.y;
+			words[used] = word;
+			masks[used] = bit;
+			used++;
+		}
 	}
 
-	return entt::null;
+	for (size_t i = 0; i < used; i++)
+	{
+		if ((container.GetObstructionWord(rows[i], words[i]) & masks[i]) != 0)
+			return false;
+	}
+
+	return true;
 }
 
-const Components::Block& GetBlockAtCoordinates(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& coordinate)
+// Would this tetromino fit with its origin at these coordinates, in this orientation? Its own blocks are never on the bitmask, so they can't get in the way.
+bool DoesTetrominoFit(entt::registry& registry, const entt::entity& tetrominoEnt, const Components::Coordinate& coordinate, const moveDirection_t& orientation)
 {
-	auto blockView = registry.view<Components::Block>();
-	for (auto entity : blockView)
-	{
-		auto& block = blockView.get<Components::Block>(entity);
+	if (!IsEntityTetromino(registry, tetrominoEnt))
+		return false;
 
-		if (block.IsEnabled())
-		{
-			auto& container2 = registry.get<Components::Container>(block.Get());
-			auto& tag = registry.get<Components::Tag>(block.Get()); // We'll be wanting to check which container we're working with later. (eg: Play Area, Hold, Preview, (which play area?))
-			if (!tag.IsEnabled() || containerTag != tag.Get())
-				continue;
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt) || !registry.all_of<Components::Container>(parentEnt))
+		return false;
 
-			auto& blockCoordinate = registry.get<Components::Coordinate>(entity);
-			if (blockCoordinate == coordinate)
-			{
-				// We're short circuiting here on the first match. We probably want to check for container first. (eg: When we've got multiple reference containers in use.)
-				return block;
-			}
-		}
+	auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
+
+	std::array<glm::ivec2, 4> cells;
+	for (int i = 0; i < 4; i++)
+	{
+		cells[i] = glm::ivec2(coordinate.Get()) + glm::ivec2(tetromino->GetBlockOffsetCoordinates(orientation, i));
 	}
 
-	throw std::runtime_error("Unable to find Block at coordinates!");
+	return AreTetrominoCellsFree(registry.get<Components::Container>(parentEnt), cells);
 }
 
-entt::entity MoveBlockInDirection2(entt::registry& registry, const entt::entity& blockEnt, const moveDirection_t& direction, const Components::Coordinate& coordinate, entt::entity newCellEnt, const Components::Cell& tempCell, const bool& disableObstruction)
+entt::entity MoveBlockInDirection2(entt::registry& registry, const entt::entity& blockEnt, const moveDirection_t& direction, entt::entity newCellEnt, const Components::Cell& tempCell, const bool& disableObstruction)
 {
 	if (CanOccupyCell(registry, blockEnt, tempCell.GetDirection(direction), disableObstruction))
 	{
@@ -604,22 +652,20 @@ entt::entity MoveBlockInDirection2(entt::registry& registry, const entt::entity&
 		// If we can't occupy the cell, because the cell doesn't connect to another cell in this direction...
 		if (tempCell.GetDirection(direction) == entt::null)
 		{
-			// Get a cell link and see if it lets us continue moving in this direction.
-			entt::entity cellLinkEnt = GetCellLinkAtCoordinates(registry, coordinate, direction);
-			if (cellLinkEnt != entt::null)
+			// See if the cell links elsewhere, and lets us continue moving in this direction.
+			entt::entity linkDestinationEnt = tempCell.GetLink(direction);
+			if (linkDestinationEnt != entt::null)
 			{
-				const auto& cellLink = registry.get<Components::CellLink>(cellLinkEnt);
-
 				// Only move into the linked cell destination, if we can occupy it.
-				if (CanOccupyCell(registry, blockEnt, cellLink.GetDestination(), disableObstruction))
+				if (CanOccupyCell(registry, blockEnt, linkDestinationEnt, disableObstruction))
 				{
-					newCellEnt = cellLink.GetDestination();
+					newCellEnt = linkDestinationEnt;
 
 					if (registry.all_of<Components::Controllable>(blockEnt))
 					{
 						// Update where we're controlling. We probably want to do this a different way, not in this function. TODO FIXME
 						auto& controllable = registry.get<Components::Controllable>(blockEnt);
-						const auto& cellLinkDestination = registry.get<Components::Cell>(cellLink.GetDestination());
+						const auto& cellLinkDestination = registry.get<Components::Cell>(linkDestinationEnt);
 						controllable.Set(cellLinkDestination.GetParent());
 					}
 				}
@@ -640,10 +686,7 @@ entt::entity MoveBlockInDirection2(entt::registry& registry, const entt::entity&
 */
 entt::entity MoveBlockInDirection(entt::registry& registry, const entt::entity& blockEnt, const moveDirection_t& direction, const unsigned int& distance, const bool& disableObstruction)
 {
-	auto coordinate = registry.get<Components::Coordinate>(blockEnt); // We do NOT want a reference here, we want a copy.
-	//auto& moveable = registry.get<Components::Moveable>(blockEnt);
-
-	entt::entity cellEnt = GetCellAtCoordinates2(registry, coordinate);
+	entt::entity cellEnt = GetCellAtCoordinates2(registry, registry.get<Components::Coordinate>(blockEnt));
 	if (cellEnt == entt::null)
 		return entt::null;
 
@@ -651,20 +694,12 @@ entt::entity MoveBlockInDirection(entt::registry& registry, const entt::entity&
 
 	for (unsigned int i = 0; i < distance; i++)
 	{
-		// We're moving a bunch in this function. Update our current coordiantes while doing so.
-		if (i > 0 && registry.all_of<Components::Coordinate>(newCellEnt))
-		{
-			const auto& newCoordinate = registry.get<Components::Coordinate>(newCellEnt);
-			coordinate.Set(newCoordinate.Get());
-			coordinate.SetParent(newCoordinate.GetParent());
-		}
-
 		entt::entity tempCellEnt = newCellEnt;
 		if (!registry.all_of<Components::Cell>(tempCellEnt))
 			continue;
 		const auto& tempCell = registry.get<Components::Cell>(tempCellEnt);
 
-		newCellEnt = MoveBlockInDirection2(registry, blockEnt, direction, coordinate, newCellEnt, tempCell, disableObstruction);
+		newCellEnt = MoveBlockInDirection2(registry, blockEnt, direction, newCellEnt, tempCell, disableObstruction);
 	}
 
 	return newCellEnt;
@@ -710,7 +745,7 @@ void PlaceCensor(entt::registry& registry, const Components::Coordinate& coordin
 			registry.emplace<Components::Position>(censor);
 			registry.emplace<Components::DerivePositionFromCoordinates>(censor);
 			registry.emplace<Components::Scale>(censor, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(censor, Components::renderLayer_t::RL_MARKER_OVER, Model("./data/block/grey.obj"), startVisible);
+			registry.emplace<Components::Renderable>(censor, Components::renderLayer_t::RL_MARKER_OVER, "./data/block/grey.obj", startVisible);
 			registry.emplace<Components::Orientation>(censor);
 			registry.emplace<Components::ReferenceEntity>(censor, coordinate.GetParent());
 			if (directional)
@@ -723,7 +758,7 @@ void PlaceCensor(entt::registry& registry, const Components::Coordinate& coordin
 
 void FillPauseCensors(entt::registry&  registry, entt::entity matrix, entt::entity bagArea)
 {
-	Components::Container container1 = registry.get<Components::Container>(matrix);
+	const auto& container1 = registry.get<Components::Container>(matrix);
 	for (unsigned int i = BufferAreaDepth; i < container1.GetGridDimensions().x - BufferAreaDepth; i++)
 	{
 		for (unsigned int k = BufferAreaDepth; k < container1.GetGridDimensions().y - BufferAreaDepth; k++)
@@ -735,7 +770,7 @@ void FillPauseCensors(entt::registry&  registry, entt::entity matrix, entt::enti
 	// Directional censors for the top buffer area of the matrix here. FIXME TODO
 	// This is basically just directional walls' positioning loops(different, but same idea) using censors instead.
 
-	Components::Container container2 = registry.get<Components::Container>(bagArea);
+	const auto& container2 = registry.get<Components::Container>(bagArea);
 	for (unsigned int i = 0; i < container2.GetGridDimensions().x; i++)
 	{
 		for (unsigned int k = 0; k < container2.GetGridDimensions().y; k++)
@@ -745,81 +780,72 @@ void FillPauseCensors(entt::registry&  registry, entt::entity matrix, entt::enti
 	}
 }
 
-void BuildGrid(entt::registry& registry, const entt::entity& parentEntity)
+// Cell tags ("<Container>:Grid:x-y") are only for debugging. Leave them off for large grids, GetCellDebugName() will produce the same name on demand.
+void BuildGrid(entt::registry& registry, const entt::entity& parentEntity, const bool& tagCells)
 {
-	Components::Container container2 = registry.get<Components::Container>(parentEntity);
-	// We want a copy of this to be stored in this scope, because the component reference may change without warning.
-	// We could also just store the vector coordinate. Either way.
-	Components::Position parentPosition = registry.get<Components::Position>(parentEntity);
+	registry.get<Components::Container>(parentEntity).ResetCellIndex();
 
-	for (unsigned int i = 0; i < container2.GetGridDimensions().x; i++)
+	// We want a copy of these to be stored in this scope, because the component reference may change without warning.
+	// Only the dimensions though, not the whole container. It carries its cell index around with it.
+	const glm::uvec2 gridDimensions = registry.get<Components::Container>(parentEntity).GetGridDimensions();
+	const glm::vec3 cellDimensions = registry.get<Components::Container>(parentEntity).GetCellDimensions3();
+	const std::string parentTag = tagCells ? GetTagOfEntity(registry, parentEntity) : "";
+
+	for (unsigned int i = 0; i < gridDimensions.x; i++)
 	{
-		for (unsigned int k = 0; k < container2.GetGridDimensions().y; k++)
+		for (unsigned int k = 0; k < gridDimensions.y; k++)
 		{
-			std::string tagName = GetTagOfEntity(registry, parentEntity);
-			tagName += ":Grid:";
-			tagName += std::to_string(i);
-			tagName += "-";
-			tagName += std::to_string(k);
-
 			const auto cell = registry.create();
 			registry.emplace<Components::Coordinate>(cell, parentEntity, glm::uvec2(i, k));
 			registry.emplace<Components::Cell>(cell, parentEntity);
-			registry.emplace<Components::Tag>(cell, tagName);
-			registry.emplace<Components::Scale>(cell, container2.GetCellDimensions3());
+			if (tagCells)
+			{
+				registry.emplace<Components::Tag>(cell, parentTag + ":Grid:" + std::to_string(i) + "-" + std::to_string(k));
+			}
+			registry.emplace<Components::Scale>(cell, cellDimensions);
 			registry.emplace<Components::Position>(cell);
 			registry.emplace<Components::DerivePositionFromCoordinates>(cell, parentEntity);
-			//registry.emplace<Components::Renderable>(cell, Components::renderLayer_t::RL_CELL, Model("./data/block/darkgrey.obj"));
+			//registry.emplace<Components::Renderable>(cell, Components::renderLayer_t::RL_CELL, "./data/block/darkgrey.obj");
 			//registry.emplace<Components::ScaleToCellDimensions>(cell, parentEntity);
 			registry.emplace<Components::Orientation>(cell);
 			registry.emplace<Components::ReferenceEntity>(cell, parentEntity);
 			registry.emplace<Components::InheritScalingFromParent>(cell, false);
 			//registry.emplace<Components::DerivePositionFromParent>(cell, parentEntity);
+
+			registry.get<Components::Container>(parentEntity).SetCellAt(glm::uvec2(i, k), cell);
 		}
 	}
 
-	auto cellView = registry.view<Components::Cell, Components::Coordinate>();
-	for (auto entity1 : cellView)
+	// Wire up neighbours straight from the cell index. North is +y, east is +x.
+	const auto& container = registry.get<Components::Container>(parentEntity);
+	for (unsigned int i = 0; i < gridDimensions.x; i++)
 	{
-		auto& cell1 = cellView.get<Components::Cell>(entity1);
-		auto& coordinate1 = cellView.get<Components::Coordinate>(entity1);
-		for (auto entity2 : cellView)
+		for (unsigned int k = 0; k < gridDimensions.y; k++)
 		{
-			if (entity1 == entity2)
-				continue;
-
-			auto& cell2 = cellView.get<Components::Cell>(entity2);
-			auto& coordinate2 = cellView.get<Components::Coordinate>(entity2);
-
-			if (coordinate1.GetParent() != coordinate2.GetParent())
-				continue;
+			auto& cell = registry.get<Components::Cell>(container.GetCellAt(glm::uvec2(i, k)));
+
+			if (i + 1 < gridDimensions.x)
+				cell.SetEast(container.GetCellAt(glm::uvec2(i + 1, k)));
+			if (i > 0)
+				cell.SetWest(container.GetCellAt(glm::uvec2(i - 1, k)));
+			if (k + 1 < gridDimensions.y)
+				cell.SetNorth(container.GetCellAt(glm::uvec2(i, k + 1)));
+			if (k > 0)
+				cell.SetSouth(container.GetCellAt(glm::uvec2(i, k - 1)));
+		}
+	}
+}
 
-			if (coordinate1.Get().y == coordinate2.Get().y)
-			{
-				if (coordinate1.Get().x + 1 == coordinate2.Get().x)
-				{
-					cell1.SetEast(entity2);
-				}
+const std::string GetCellDebugName(entt::registry& registry, const entt::entity& cellEnt)
+{
+	if (!registry.all_of<Components::Cell, Components::Coordinate>(cellEnt))
+		return "";
 
-				if (coordinate1.Get().x - 1 == coordinate2.Get().x)
-				{
-					cell1.SetWest(entity2);
-				}
-			}
-			if (coordinate1.Get().x == coordinate2.Get().x)
-			{
-				if (coordinate1.Get().y + 1 == coordinate2.Get().y)
-				{
-					cell1.SetNorth(entity2);
-				}
+	if (registry.all_of<Components::Tag>(cellEnt))
+		return GetTagOfEntity(registry, cellEnt);
 
-				if (coordinate1.Get().y - 1 == coordinate2.Get().y)
-				{
-					cell1.SetSouth(entity2);
-				}
-			}
-		}
-	}
+	const auto& coordinate = registry.get<Components::Coordinate>(cellEnt);
+	return GetTagOfEntity(registry, coordinate.GetParent()) + ":Grid:" + std::to_string(coordinate.Get().x) + "-" + std::to_string(coordinate.Get().y);
 }
 
 // We'll want to spawn whole tetrominoes later, not just blocks.
@@ -835,7 +861,6 @@ entt::entity SpawnBlock(entt::registry& registry, const std::string& containerTa
 
 		if (container2.IsEnabled() && tag.IsEnabled())
 		{
-			Components::Container container2 = registry.get<Components::Container>(entity);
 			Components::Position parentPosition = registry.get<Components::Position>(entity);
 
 			const auto piece1 = registry.create();
@@ -843,8 +868,9 @@ entt::entity SpawnBlock(entt::registry& registry, const std::string& containerTa
 			registry.emplace<Components::Position>(piece1);
 			registry.emplace<Components::DerivePositionFromCoordinates>(piece1, entity);
 			registry.emplace<Components::Scale>(piece1, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, Model("./data/block/yellow.obj"));
+			registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, "./data/block/yellow.obj");
 			registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), registry.get<Components::Coordinate>(piece1));
+			registry.emplace<Components::Awake>(piece1);
 			//registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), Components::Coordinate(glm::uvec2(1, 0)));// registry.get<Components::Coordinate>(piece1));
 			if (isControllable)
 			{
@@ -857,14 +883,89 @@ entt::entity SpawnBlock(entt::registry& registry, const std::string& containerTa
 			registry.emplace<Components::Orientation>(piece1);
 			registry.emplace<Components::ReferenceEntity>(piece1, entity);
 
-			return piece1;
-		}
+			SetOccupantAtCoordinates(registry, spawnCoordinate, piece1);
+
+			return piece1;
+		}
+	}
+
+	return entt::null;
+}
+
+template<typename... Component>
+static void ReserveAdditionalStorage(entt::registry& registry, const size_t& count)
+{
+	(registry.reserve<Component>(registry.size<Component>() + count), ...);
+}
+
+void ReserveBlockStorage(entt::registry& registry, const size_t& blockCount)
+{
+	registry.reserve(registry.size() + blockCount);
+	// Everything a block carries in play, so the pool can fill the board without any of it growing.
+	ReserveAdditionalStorage<Components::Coordinate, Components::Position, Components::DerivePositionFromCoordinates, Components::Scale,
+		Components::Moveable, Components::Awake, Components::Locked, Components::Block, Components::Obstructable, Components::Obstructs,
+		Components::Follower, Components::Orientation, Components::ReferenceEntity, Components::Hittable,
+		Components::Renderable, Components::PooledBlock, Components::Parked>(registry, blockCount);
+
+	for (auto& parked : GetGameContext(registry).parkedBlocks)
+		parked.reserve(parked.size() + blockCount);
+}
+
+// A parked block of the given type, taken out of the pool. Null if there isn't one, in which case a new block has to be made.
+static entt::entity AcquireParkedBlock(entt::registry& registry, const tetrominoType_t& type)
+{
+	auto& parked = GetGameContext(registry).parkedBlocks[static_cast<int>(type)];
+	if (parked.empty())
+		return entt::null;
+
+	const entt::entity entity = parked.back();
+	parked.pop_back();
+	registry.remove<Components::Parked>(entity);
+
+	// It keeps its Renderable, so no signal fires as it rejoins the render group at the end, out of layer order.
+	GetGameContext(registry).renderOrderDirty = true;
+	return entity;
+}
+
+void ReleaseBlock(entt::registry& registry, const entt::entity& blockEnt)
+{
+	if (!registry.all_of<Components::PooledBlock, Components::Renderable>(blockEnt))
+	{
+		registry.destroy(blockEnt);
+		return;
+	}
+
+	// Only the model stays. Without a Position or Coordinate, the block drops out of the render group and every system's view.
+	registry.remove_if_exists<Components::Coordinate, Components::Position, Components::DerivePositionFromCoordinates, Components::Scale,
+		Components::Moveable, Components::Awake, Components::Locked, Components::Block, Components::Obstructable, Components::Obstructs,
+		Components::Follower, Components::Orientation, Components::ReferenceEntity, Components::Hittable>(blockEnt);
+	registry.emplace<Components::Parked>(blockEnt);
+
+	auto& context = GetGameContext(registry);
+	context.parkedBlocks[static_cast<int>(registry.get<Components::PooledBlock>(blockEnt).GetType())].push_back(blockEnt);
+	context.renderOrderDirty = true; // Leaving the group moves another entity into its place, and the Renderable stays, so nothing else marks it.
+}
+
+void ReleaseTetromino(entt::registry& registry, const entt::entity& tetrominoEnt)
+{
+	auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
+	if (tetromino == NULL)
+		return;
+
+	for (int i = 0; i < 4; i++)
+	{
+		const entt::entity blockEnt = tetromino->GetBlock(i);
+		if (blockEnt == entt::null || !registry.valid(blockEnt))
+			continue;
+
+		ClearOccupantAtCoordinates(registry, GetCoordinateOfEntity(registry, blockEnt), blockEnt);
+		ReleaseBlock(registry, blockEnt);
 	}
 
-	return entt::null;
+	registry.destroy(tetrominoEnt);
 }
 
-entt::entity SpawnFollowerBlock(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& spawnCoordinate, entt::entity followedEntity, const std::string& blockModelPath)
+entt::entity SpawnFollowerBlock(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& spawnCoordinate, entt::entity followedEntity, const tetrominoType_t& type)
 {
 	auto containerView = registry.view<Components::Container, Components::Tag>();
 	for (auto entity : containerView)
@@ -876,16 +977,23 @@ entt::entity SpawnFollowerBlock(entt::registry& registry, const std::string& con
 
 		if (container2.IsEnabled() && tag.IsEnabled())
 		{
-			Components::Container container2 = registry.get<Components::Container>(entity);
 			Components::Position parentPosition = registry.get<Components::Position>(entity);
 
-			const auto piece1 = registry.create();
+			// Reuse a parked block of the same type when there is one, so steady play neither loads models nor grows the registry.
+			entt::entity piece1 = AcquireParkedBlock(registry, type);
+			if (piece1 == entt::null)
+			{
+				piece1 = registry.create();
+				registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, Components::TetrominoTables::BlockModelPaths[static_cast<int>(type)]);
+				registry.emplace<Components::PooledBlock>(piece1, type);
+			}
+
 			registry.emplace<Components::Coordinate>(piece1, spawnCoordinate.GetParent(), spawnCoordinate.Get());
 			registry.emplace<Components::Position>(piece1);
 			registry.emplace<Components::DerivePositionFromCoordinates>(piece1);
 			registry.emplace<Components::Scale>(piece1, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, Model(blockModelPath));
 			registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), registry.get<Components::Coordinate>(piece1));
+			registry.emplace<Components::Awake>(piece1);
 			//registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), Components::Coordinate(glm::uvec2(1, 0)));// registry.get<Components::Coordinate>(piece1));
 
 			registry.emplace<Components::Block>(piece1, entity);
@@ -896,6 +1004,8 @@ entt::entity SpawnFollowerBlock(entt::registry& registry, const std::string& con
 			registry.emplace<Components::Orientation>(piece1);
 			registry.emplace<Components::ReferenceEntity>(piece1, entity);
 
+			SetOccupantAtCoordinates(registry, spawnCoordinate, piece1);
+
 			return piece1;
 		}
 	}
@@ -903,49 +1013,78 @@ entt::entity SpawnFollowerBlock(entt::registry& registry, const std::string& con
 	return entt::null;
 }
 
-void LinkCoordinates(entt::registry& registry, const Components::Coordinate& origin, const Components::Coordinate& destination, const moveDirection_t& moveDir, const moveDirection_t& moveDirReverse)
+void LinkCoordinates(entt::registry& registry, const Components::Coordinate& origin, const Components::Coordinate& destination, const moveDirection_t& moveDir, const moveDirection_t& moveDirReverse, const bool& placeMarker)
 {
-	auto originCoordView = registry.view<Components::Cell, Components::Coordinate>();
-	auto destinationCoordView = registry.view<Components::Cell, Components::Coordinate>();
-	for (auto originEnt : originCoordView)
-	{
-		const auto originCoord = originCoordView.get<Components::Coordinate>(originEnt);
-		const auto originCell = originCoordView.get<Components::Cell>(originEnt);
+	entt::entity originEnt = GetCellAtCoordinates2(registry, origin);
+	entt::entity destinationEnt = GetCellAtCoordinates2(registry, destination);
+	if (originEnt == entt::null || destinationEnt == entt::null || originEnt == destinationEnt)
+		return;
 
-		if (originCoord.Get() != origin.Get())
-			continue;
+	// Resolve the link onto the origin cell itself, so moving across it never has to go looking.
+	auto& originCell = registry.get<Components::Cell>(originEnt);
+	originCell.SetLink(moveDir, destinationEnt);
 
-		if (originCoord.GetParent() != origin.GetParent())
-			continue;
+	if (!placeMarker)
+		return;
 
-		for (auto destinationEnt : destinationCoordView)
-		{
-			if (originEnt == destinationEnt)
-				continue;
+	const auto marker1 = registry.create();
+	registry.emplace<Components::CellLink>(marker1, originEnt, destinationEnt, moveDir);
 
-			const auto destinationCoord = destinationCoordView.get<Components::Coordinate>(destinationEnt);
-			const auto destinationCell = destinationCoordView.get<Components::Cell>(destinationEnt);
+	registry.emplace<Components::Coordinate>(marker1, origin.GetParent(), origin.Get());
+	registry.emplace<Components::Position>(marker1);
+	registry.emplace<Components::DerivePositionFromCoordinates>(marker1);// , originCoord.GetParent());
 
-			if (destinationCoord.Get() != destination.Get())
-				continue;
+	auto& container = registry.get<Components::Container>(origin.GetParent());
+	registry.emplace<Components::Scale>(marker1, container.GetCellDimensions3());
+	registry.emplace<Components::Renderable>(marker1, Components::renderLayer_t::RL_MARKER_UNDER, "./data/block/green.obj");
+}
 
-			if (destinationCoord.GetParent() != destination.GetParent())
-				continue;
+// The coordinates of the index-th cell along one edge of a grid. North and south edges run along x, east and west edges along y.
+static glm::uvec2 GetEdgeCoordinates(const glm::uvec2& dimensions, const moveDirection_t& edge, const unsigned int& index)
+{
+	switch (edge)
+	{
+	case moveDirection_t::NORTH:
+		return glm::uvec2(index, dimensions.y - 1);
+	case moveDirection_t::SOUTH:
+		return glm::uvec2(index, 0);
+	case moveDirection_t::EAST:
+		return glm::uvec2(dimensions.x - 1, index);
+	case moveDirection_t::WEST:
+		return glm::uvec2(0, index);
+	}
 
-			const auto marker1 = registry.create();
-			registry.emplace<Components::CellLink>(marker1, originEnt, destinationEnt, moveDir);
+	throw std::runtime_error("GetEdgeCoordinates(): This should never be reached. Direction not handled.");
+}
 
-			registry.emplace<Components::Coordinate>(marker1, originCoord.GetParent(), originCoord.Get());
-			registry.emplace<Components::Position>(marker1);
-			registry.emplace<Components::DerivePositionFromCoordinates>(marker1);// , originCoord.GetParent());
+static unsigned int GetEdgeLength(const glm::uvec2& dimensions, const moveDirection_t& edge)
+{
+	if (edge == moveDirection_t::NORTH || edge == moveDirection_t::SOUTH)
+		return dimensions.x;
 
-			if (registry.all_of<Components::Container>(originCell.GetParent()))
-			{
-				auto& container = registry.get<Components::Container>(originCoord.GetParent());
-				registry.emplace<Components::Scale>(marker1, container.GetCellDimensions3());
-			}
-			registry.emplace<Components::Renderable>(marker1, Components::renderLayer_t::RL_MARKER_UNDER, Model("./data/block/green.obj"));
-		}
+	return dimensions.y;
+}
+
+/*
+* Link every cell along the lhsConnectDir edge of lhs with its counterpart along the rhsConnectDir edge of rhs, both ways.
+* eg: lhs NORTH, rhs SOUTH, lets blocks move north off the top of lhs into the bottom of rhs, and south back again.
+*/
+void ConnectGrids(entt::registry& registry, const entt::entity& lhs, const moveDirection_t& lhsConnectDir, const entt::entity& rhs, const moveDirection_t& rhsConnectDir, const bool& placeMarkers)
+{
+	const glm::uvec2 lhsDimensions = registry.get<Components::Container>(lhs).GetGridDimensions();
+	const glm::uvec2 rhsDimensions = registry.get<Components::Container>(rhs).GetGridDimensions();
+
+	const unsigned int edgeLength = GetEdgeLength(lhsDimensions, lhsConnectDir);
+	if (edgeLength != GetEdgeLength(rhsDimensions, rhsConnectDir))
+		throw std::runtime_error("Grid edges must be the same length to be connected!");
+
+	for (unsigned int i = 0; i < edgeLength; i++)
+	{
+		const auto lhsCoordinate = Components::Coordinate(lhs, GetEdgeCoordinates(lhsDimensions, lhsConnectDir, i));
+		const auto rhsCoordinate = Components::Coordinate(rhs, GetEdgeCoordinates(rhsDimensions, rhsConnectDir, i));
+
+		LinkCoordinates(registry, lhsCoordinate, rhsCoordinate, lhsConnectDir, rhsConnectDir, placeMarkers);
+		LinkCoordinates(registry, rhsCoordinate, lhsCoordinate, rhsConnectDir, lhsConnectDir, placeMarkers);
 	}
 }
 
@@ -955,8 +1094,10 @@ void RelocateBlock(entt::registry& registry, const Components::Coordinate& newCo
 		return;
 
 	auto& coordinate = registry.get<Components::Coordinate>(blockEnt);
+	ClearOccupantAtCoordinates(registry, coordinate, blockEnt);
 	coordinate.Set(newCoordinate.Get());
 	coordinate.SetParent(newCoordinate.GetParent());
+	SetOccupantAtCoordinates(registry, coordinate, blockEnt);
 
 	auto& derivePositionFromCoordinates = registry.get<Components::DerivePositionFromCoordinates>(blockEnt);
 	derivePositionFromCoordinates.Set(newCoordinate.GetParent());
@@ -1046,8 +1187,9 @@ entt::entity SpawnProjectedFollowerBlock(entt::registry& registry, const Compone
 		registry.emplace<Components::Position>(piece1);
 		registry.emplace<Components::DerivePositionFromCoordinates>(piece1);
 		registry.emplace<Components::Scale>(piece1, container.GetCellDimensions3());
-		registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, Model(blockModelPath));
+		registry.emplace<Components::Renderable>(piece1, Components::renderLayer_t::RL_BLOCK, blockModelPath);
 		registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), registry.get<Components::Coordinate>(piece1));
+		registry.emplace<Components::Awake>(piece1);
 		//registry.emplace<Components::Moveable>(piece1, registry.get<Components::Coordinate>(piece1), Components::Coordinate(glm::uvec2(1, 0)));// registry.get<Components::Coordinate>(piece1));
 
 		registry.emplace<Components::Block>(piece1, spawnCoordinate.GetParent());
@@ -1081,32 +1223,7 @@ entt::entity SpawnProjectedTetromino(entt::registry& registry, const entt::entit
 	registry.emplace<Components::Coordinate>(projectionEnt, tetCoord.GetParent(), tetCoord.Get());
 	registry.emplace<Components::Position>(projectionEnt);
 
-	switch (tetType)
-	{
-	case tetrominoType_t::O:
-		registry.emplace<Components::OTetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::I:
-		registry.emplace<Components::ITetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::T:
-		registry.emplace<Components::TTetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::L:
-		registry.emplace<Components::LTetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::J:
-		registry.emplace<Components::JTetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::S:
-		registry.emplace<Components::STetromino>(projectionEnt, currentOrientation);
-		break;
-	case tetrominoType_t::Z:
-		registry.emplace<Components::ZTetromino>(projectionEnt, currentOrientation);
-		break;
-	default:
-		assert(false);
-	}
+	registry.emplace<Components::Tetromino>(projectionEnt, tetType, currentOrientation);
 
 	//GetDesiredDirectionOfTetromino(registry, originCoordinate.GetParent());
 
@@ -1134,8 +1251,9 @@ entt::entity SpawnProjectedTetromino(entt::registry& registry, const entt::entit
 		projection->AddBlock(blockEnt);
 	}
 	
-	//registry.emplace<Components::Renderable>(tetrominoEnt, Components::renderLayer_t::RL_TETROMINO, Model("./data/block/purple.obj"));
+	//registry.emplace<Components::Renderable>(tetrominoEnt, Components::renderLayer_t::RL_TETROMINO, "./data/block/purple.obj");
 	registry.emplace<Components::Moveable>(projectionEnt, projCoord, projCoord);
+	registry.emplace<Components::Awake>(projectionEnt);
 	registry.emplace<Components::Obstructable>(projectionEnt, projCoord.GetParent());
 	registry.emplace<Components::ProjectionOf>(projectionEnt, tetrominoEnt);
 
@@ -1164,32 +1282,7 @@ entt::entity SpawnTetromino(entt::registry& registry, const std::string& contain
 		currentDirection = playAreaDirection.GetCurrentOrientation();
 	}
 
-	switch (tetrominoType)
-	{
-	case tetrominoType_t::O:
-		registry.emplace<Components::OTetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::I:
-		registry.emplace<Components::ITetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::T:
-		registry.emplace<Components::TTetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::L:
-		registry.emplace<Components::LTetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::J:
-		registry.emplace<Components::JTetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::S:
-		registry.emplace<Components::STetromino>(tetrominoEnt, currentDirection);
-		break;
-	case tetrominoType_t::Z:
-		registry.emplace<Components::ZTetromino>(tetrominoEnt, currentDirection);
-		break;
-	default:
-		assert(false);
-	}
+	registry.emplace<Components::Tetromino>(tetrominoEnt, tetrominoType, currentDirection);
 
 	auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
 	
@@ -1211,20 +1304,19 @@ entt::entity SpawnTetromino(entt::registry& registry, const std::string& contain
 		auto spawnPoint = Components::Coordinate(spawnCoordinate.GetParent(),
 			(glm::vec2)spawnCoordinate.Get() + tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i));
 
-		entt::entity blockEnt = SpawnFollowerBlock(registry, containerTag, spawnPoint, tetrominoEnt, tetromino->GetBlockModelPath());
+		entt::entity blockEnt = SpawnFollowerBlock(registry, containerTag, spawnPoint, tetrominoEnt, tetromino->GetType());
 		tetromino->AddBlock(blockEnt);
 	}
 
-	int width = tetromino->GetPatternWidth();
-	string modelpath = tetromino->GetBlockModelPath();
-
 	if (isControllable)
 	{
 		registry.emplace<Components::Controllable>(tetrominoEnt, spawnCoordinate.GetParent());
+		GetGameContext(registry).activePiece = tetrominoEnt;
 	}
-	//registry.emplace<Components::Renderable>(tetrominoEnt, Components::renderLayer_t::RL_TETROMINO, Model("./data/block/purple.obj"));
+	//registry.emplace<Components::Renderable>(tetrominoEnt, Components::renderLayer_t::RL_TETROMINO, "./data/block/purple.obj");
 	registry.emplace<Components::Orientation>(tetrominoEnt);
 	registry.emplace<Components::Moveable>(tetrominoEnt, registry.get<Components::Coordinate>(tetrominoEnt), registry.get<Components::Coordinate>(tetrominoEnt));
+	registry.emplace<Components::Awake>(tetrominoEnt);
 	registry.emplace<Components::Obstructable>(tetrominoEnt, spawnCoordinate.GetParent());
 	registry.emplace<Components::ReferenceEntity>(tetrominoEnt, spawnCoordinate.GetParent());
 
@@ -1244,78 +1336,78 @@ bool AreCoordinatesObstructed(entt::registry& registry, const Components::Coordi
 	if (!probeObstructable.IsEnabled())
 		return false;
 
-	// Go through all the obstructing entities with these coordinates. Any positive match will obstruct.
-	auto coordinateView = registry.view<Components::Coordinate, Components::Obstructs>();
-	for (auto entity : coordinateView)
-	{
-		const auto& obstructs = coordinateView.get<Components::Obstructs>(entity);
-		const auto& obstructsCoordinate = coordinateView.get<Components::Coordinate>(entity);
+	const auto& parentEnt = coordinate.GetParent();
+	if (parentEnt == entt::null || !registry.valid(parentEnt) || !registry.all_of<Components::Container>(parentEnt))
+		return false;
 
-		// Don't self-obstruct
-		if(entity == probeEntity)
-			continue;
+	// Walls and settled blocks are on the container's occupancy bitmask. Any of those will obstruct, so long as it's not ourselves.
+	const auto& container = registry.get<Components::Container>(parentEnt);
+	if (container.IsWallBitSet(coordinate.Get()))
+		return true;
 
-		// We only care about matching coordinates.
-		if (obstructsCoordinate != coordinate)
-			continue;
+	entt::entity entity = GetOccupantAtCoordinates(registry, coordinate);
+	if (container.IsBlockBitSet(coordinate.Get()) && entity != probeEntity)
+		return true;
 
-		if (!obstructsCoordinate.IsEnabled() || !obstructs.IsEnabled())
-			continue;
+	// Whatever's left is a block following a tetromino, which might be one we're a part of.
+	if (entity == entt::null || entity == probeEntity)
+		return false;
+
+	const auto& obstructs = registry.get<Components::Obstructs>(entity);
+	if (!obstructs.IsEnabled())
+		return false;
 
-		if (registry.all_of<Components::ProjectionOf>(probeEntity))
+	if (registry.all_of<Components::ProjectionOf>(probeEntity))
+	{
+		const auto& probeProjectionOf = registry.get<Components::ProjectionOf>(probeEntity);
+		if (probeProjectionOf.IsEnabled())
 		{
-			const auto& probeProjectionOf = registry.get<Components::ProjectionOf>(probeEntity);
-			if (probeProjectionOf.IsEnabled())
+			if (probeProjectionOf.Get() == entity)
+			{ // We only care if we're not a projection of this obstruction
+				return false;
+			}
+
+			if (registry.all_of<Components::Follower>(entity))
 			{
-				if (probeProjectionOf.Get() == entity)
-				{ // We only care if we're not a projection of this obstruction
-					continue;
-				}
+				const auto& obstructsFollower = registry.get<Components::Follower>(entity);
 
-				if (registry.all_of<Components::Follower>(entity))
+				if (probeProjectionOf.Get() == obstructsFollower.Get())
 				{
-					const auto& obstructsFollower = registry.get<Components::Follower>(entity);
-
-					if (probeProjectionOf.Get() == obstructsFollower.Get())
-					{
-						continue;
-					}
+					return false;
 				}
 			}
 		}
+	}
 
-		if (registry.all_of<Components::Follower>(entity) && registry.all_of<Components::Follower>(probeEntity))
-		{
-			const auto& probeFollower = registry.get<Components::Follower>(probeEntity);
-			const auto& obstructsFollower = registry.get<Components::Follower>(entity);
-
-			if (!probeFollower.IsEnabled() || !obstructsFollower.IsEnabled())
-			{
-				// At least one follower isn't enabled. Obstruct.
-				return true;
-			}
+	if (registry.all_of<Components::Follower>(entity) && registry.all_of<Components::Follower>(probeEntity))
+	{
+		const auto& probeFollower = registry.get<Components::Follower>(probeEntity);
+		const auto& obstructsFollower = registry.get<Components::Follower>(entity);
 
-			if (probeFollower.Get() == entt::null || obstructsFollower.Get() == entt::null)
-			{
-				// At least one follower, isn't following anything. Obstruct.
-				return true;
-			}
+		if (!probeFollower.IsEnabled() || !obstructsFollower.IsEnabled())
+		{
+			// At least one follower isn't enabled. Obstruct.
+			return true;
+		}
 
-			if (probeFollower.Get() != obstructsFollower.Get())
-			{ // Followers are not the same. Obstruct.
-				return true;
-			}
+		if (probeFollower.Get() == entt::null || obstructsFollower.Get() == entt::null)
+		{
+			// At least one follower, isn't following anything. Obstruct.
+			return true;
 		}
-		else
-		{ // One or both are not followers. Obstruct.
+
+		if (probeFollower.Get() != obstructsFollower.Get())
+		{ // Followers are not the same. Obstruct.
 			return true;
 		}
+
+		return false;
 	}
 
-	return false;
+	// One or both are not followers. Obstruct.
+	return true;
 }
 
-
 glm::uvec2 GetTetrominoSpawnCoordinates(entt::registry& registry, const std::string& containerTag, const tetrominoType_t& tetrominoType)
 {
 	entt::entity foundEntity = entt::null;
@@ -1383,25 +1475,12 @@ glm::uvec2 GetTetrominoSpawnCoordinates(entt::registry& registry, const entt::en
 
 glm::uvec2 GetTetrominoSpawnCoordinates(const tetrominoType_t& type)
 {
-	switch (type)
-	{
-	case tetrominoType_t::T:
-	case tetrominoType_t::L:
-	case tetrominoType_t::J:
-	case tetrominoType_t::S:
-	case tetrominoType_t::Z:
-		return glm::uvec2(4, 17);
-		break;
-	case tetrominoType_t::I:
-		return glm::uvec2(4, 18);
-	case tetrominoType_t::O:
-		return glm::uvec2(4, 17);
-		break;
-	default:
+	const int typeIndex = static_cast<int>(type);
+	if (typeIndex < 0 || typeIndex >= Components::TetrominoTables::TypeCount)
 		throw std::runtime_error("Invalid tetrominoType_t!");
-	}
 
-	assert(false);
+	const auto& spawnCoordinates = Components::TetrominoTables::SpawnCoordinates[typeIndex];
+	return glm::uvec2(spawnCoordinates.x, spawnCoordinates.y);
 }
 
 glm::mat4 GetModelMatrixOfEntity(entt::registry& registry, entt::entity entity, const bool& inheritScaling, const bool& childCall)
@@ -1475,45 +1554,7 @@ void LinkNodes(entt::registry& registry, Components::NodeOrder& nodeOrder, entt:
 
 int CountTetrominos(entt::registry& registry)
 {
-	int tetCount = 0;
-
-	auto itets = registry.view<Components::ITetromino>();
-	for (auto entity : itets)
-	{
-		tetCount++;
-	}
-	auto jtets = registry.view<Components::JTetromino>();
-	for (auto entity : jtets)
-	{
-		tetCount++;
-	}
-	auto ltets = registry.view<Components::LTetromino>();
-	for (auto entity : ltets)
-	{
-		tetCount++;
-	}
-	auto otets = registry.view<Components::OTetromino>();
-	for (auto entity : otets)
-	{
-		tetCount++;
-	}
-	auto stets = registry.view<Components::STetromino>();
-	for (auto entity : stets)
-	{
-		tetCount++;
-	}
-	auto ztets = registry.view<Components::ZTetromino>();
-	for (auto entity : ztets)
-	{
-		tetCount++;
-	}
-	auto ttets = registry.view<Components::TTetromino>();
-	for (auto entity : ttets)
-	{
-		tetCount++;
-	}
-
-	return tetCount;
+	return static_cast<int>(registry.view<Components::Tetromino>().size());
 }
 
 void RotatePlayArea(entt::registry& registry, const rotationDirection_t& rotationDirection)
@@ -1542,11 +1583,27 @@ void RotatePlayArea(entt::registry& registry, const rotationDirection_t& rotatio
 	}
 }
 
+static void SetWallBitOfEntity(entt::registry& registry, const entt::entity& wallEnt, const bool& set)
+{
+	const auto& coordinate = registry.get<Components::Coordinate>(wallEnt);
+	if (registry.valid(coordinate.GetParent()) && registry.all_of<Components::Container>(coordinate.GetParent()))
+		registry.get<Components::Container>(coordinate.GetParent()).SetWallBit(coordinate.Get(), set);
+}
+
 void UpdateDirectionalWalls(entt::registry& registry)
 {
 	auto& cardinalDir = registry.get<Components::CardinalDirection>(FindEntityByTag(registry, GetTagFromContainerType(containerType_t::PLAY_AREA)));
 
 	auto wallView = registry.view<Components::Wall, Components::DirectionallyActive, Components::Obstructs, Components::Renderable>();
+	for (auto entity : wallView)
+	{
+		auto& dirActive = wallView.get<Components::DirectionallyActive>(entity);
+
+		// A coordinate can hold more than one wall, so clear everything first and set whatever remains active afterwards.
+		if (dirActive.IsEnabled())
+			SetWallBitOfEntity(registry, entity, false);
+	}
+
 	for (auto entity : wallView)
 	{
 		auto& wall = wallView.get<Components::Wall>(entity);
@@ -1568,6 +1625,13 @@ void UpdateDirectionalWalls(entt::registry& registry)
 			}
 		}
 	}
+
+	auto obstructingWallView = registry.view<Components::Wall, Components::Obstructs>();
+	for (auto entity : obstructingWallView)
+	{
+		if (obstructingWallView.get<Components::Obstructs>(entity).IsEnabled())
+			SetWallBitOfEntity(registry, entity, true);
+	}
 }
 
 void UpdateCensors(entt::registry& registry)
@@ -1600,6 +1664,12 @@ void UpdateCensors(entt::registry& registry)
 }
 
 rotationDirection_t ChooseBoardRotationDirection(entt::registry& registry, const std::vector<BlockLockData>& blockLockData, const moveDirection_t& playAreaDirection, const int& linesMatched)
+{
+	return ChooseBoardRotationDirection(blockLockData, playAreaDirection, linesMatched);
+}
+
+// Needs nothing from the registry, so a board being simulated off to the side can be asked the same question.
+rotationDirection_t ChooseBoardRotationDirection(const std::vector<BlockLockData>& blockLockData, const moveDirection_t& playAreaDirection, const int& linesMatched)
 {
 	if (linesMatched < minimumLinesMatchedToTriggerBoardRotation)
 		return rotationDirection_t::NONE;
@@ -1674,10 +1744,136 @@ rotationDirection_t ChooseBoardRotationDirection(entt::registry& registry, const
 }
 
 // This isn't being setup to work with plain non-Tetromino blocks, currently.
-// This has severe potential issues. SPIN-27
-// FIXME TODO
-// DO NOT USE THIS FOR NOW
-glm::uvec2 FindLowestCell(entt::registry& registry, entt::entity tetrominoEnt)
+glm::ivec2 GetDirectionOffset(const moveDirection_t& direction)
+{
+	switch (direction)
+	{
+	case moveDirection_t::NORTH:
+		return glm::ivec2(0, 1);
+	case moveDirection_t::SOUTH:
+		return glm::ivec2(0, -1);
+	case moveDirection_t::EAST:
+		return glm::ivec2(1, 0);
+	case moveDirection_t::WEST:
+		return glm::ivec2(-1, 0);
+	default:
+		return glm::ivec2(0, 0);
+	}
+}
+
+// How many steps the cells can all move by step before one of them leaves the container or runs into something. Doesn't follow cell links.
+// Moving along a column tests one obstruction word per row the cells cover at each step. Moving along a row finds each cell's nearest
+// obstruction in its row's word straight off.
+unsigned int GetDropDistance(const Components::Container& container, const std::array<glm::ivec2, 4>& cells, const glm::ivec2& step)
+{
+	if (container.GetBlockRowData() == nullptr)
+		return 0;
+
+	for (const auto& cell : cells)
+	{
+		if (cell.x < 0 || cell.y < 0 || !container.IsWithinBounds(glm::uvec2(cell)))
+			return 0;
+	}
+
+	const glm::uvec2& dimensions = container.GetGridDimensions();
+
+	if (step.y != 0)
+	{
+		std::array<unsigned int, 4> rows;
+		std::array<unsigned int, 4> words;
+		std::array<uint64_t, 4> masks;
+		size_t used = 0;
+		unsigned int maxDistance = dimensions.y;
+
+		for (const auto& cell : cells)
+		{
+			const unsigned int word = cell.x / 64;
+			const uint64_t bit = uint64_t(1) << (cell.x % 64);
+			maxDistance = std::min(maxDistance, step.y < 0 ? static_cast<unsigned int>(cell.y) : dimensions.y - 1 - cell.y);
+
+			size_t i = 0;
+			for (; i < used; i++)
+			{
+				if (rows[i] == static_cast<unsigned int>(cell.y) && words[i] == word)
+				{
+					masks[i] |= bit;
+					break;
+				}
+			}
+
+			if (i == used)
+			{
+				rows[used] = cell.y;
+				words[used] = word;
+				masks[used] = bit;
+				used++;
+			}
+		}
+
+		for (unsigned int distance = 1; distance <= maxDistance; distance++)
+		{
+			for (size_t i = 0; i < used; i++)
+			{
+				const unsigned int row = static_cast<unsigned int>(static_cast<int>(rows[i]) + step.y * static_cast<int>(distance));
+				if ((container.GetObstructionWord(row, words[i]) & masks[i]) != 0)
+					return distance - 1;
+			}
+		}
+
+		return maxDistance;
+	}
+
+	if (step.x == 0)
+		return 0;
+
+	if (container.GetWordsPerRow() != 1)
+	{ // Too wide to look along a row in one word. Step it out instead.
+		auto moved = cells;
+		unsigned int distance = 0;
+		for (; distance < dimensions.x; distance++)
+		{
+			for (auto& cell : moved)
+			{
+				cell += step;
+			}
+
+			if (!AreTetrominoCellsFree(container, moved))
+				break;
+		}
+
+		return distance;
+	}
+
+	// Everything past the edge of the row counts as in the way.
+	const uint64_t outside = ~Bitboard::SpanMask(0, dimensions.x);
+	unsigned int distance = dimensions.x;
+
+	for (const auto& cell : cells)
+	{
+		const uint64_t row = container.GetObstructionWord(cell.y, 0) | outside;
+		const unsigned int x = cell.x;
+		unsigned int free;
+
+		if (step.x > 0)
+		{
+			const uint64_t ahead = x < 63 ? row >> (x + 1) : 0;
+			free = ahead != 0 ? Bitboard::LowestBit(ahead) : 63 - x;
+		}
+		else
+		{
+			const uint64_t ahead = row & Bitboard::SpanMask(0, x);
+			free = ahead != 0 ? x - Bitboard::HighestBit(ahead) - 1 : x;
+		}
+
+		distance = std::min(distance, free);
+	}
+
+	return distance;
+}
+
+// How many cells this tetromino can fall in the play area's current down direction before it's obstructed.
+// Works purely off the container's occupancy bitmasks; no entities are created. Doesn't follow cell links.
+unsigned int GetDropDistance(entt::registry& registry, const entt::entity& tetrominoEnt)
 {
 	if (!IsEntityTetromino(registry, tetrominoEnt))
 		throw std::runtime_error("Entity is not a tetromino!");
@@ -1685,37 +1881,57 @@ glm::uvec2 FindLowestCell(entt::registry& registry, entt::entity tetrominoEnt)
 	auto* tetromino = GetTetrominoFromEntity(registry, tetrominoEnt);
 	const auto& tetCoordinate = registry.get<Components::Coordinate>(tetrominoEnt);
 
-	auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(tetCoordinate.GetParent());
-	auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
+	const auto& containerEnt = tetCoordinate.GetParent();
+	if (containerEnt == entt::null || !registry.all_of<Components::Container, Components::ReferenceEntity>(containerEnt))
+		return 0;
+
+	const auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(containerEnt);
+	const auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
+
+	std::array<glm::ivec2, 4> cells;
+	for (int i = 0; i < 4; i++)
+	{
+		cells[i] = glm::ivec2(tetCoordinate.Get()) + glm::ivec2(tetromino->GetBlockOffsetCoordinates(tetromino->GetCurrentOrientation(), i));
+	}
+
+	return GetDropDistance(registry.get<Components::Container>(containerEnt), cells, GetDirectionOffset(playAreaDirection.GetCurrentDownDirection()));
+}
+
+// Where this tetromino's origin would come to rest if dropped straight down from where it is now.
+Components::Coordinate GetLandingCoordinate(entt::registry& registry, const entt::entity& tetrominoEnt)
+{
+	const auto& tetCoordinate = registry.get<Components::Coordinate>(tetrominoEnt);
+	const auto distance = GetDropDistance(registry, tetrominoEnt);
 
-	entt::entity tempTetEnt = SpawnProjectedTetromino(registry, tetrominoEnt);
-	auto* tempTet = GetTetrominoFromEntity(registry, tempTetEnt);
-	if (!IsEntityTetromino(registry, tempTetEnt))
-		throw std::runtime_error("Temporary tetromino not a tetromino!");
-	auto& tempTetCoord = registry.get<Components::Coordinate>(tempTetEnt);
+	const auto& playAreaRefEnt = registry.get<Components::ReferenceEntity>(tetCoordinate.GetParent());
+	const auto& playAreaDirection = registry.get<Components::CardinalDirection>(playAreaRefEnt.Get());
 
-	entt::entity lowestCellEnt = MoveBlockInDirection(registry, tempTetEnt, playAreaDirection.GetCurrentDownDirection(), PlayAreaHeight + (BufferAreaDepth * 2)); // PlayAreaHeight is a const of 20. This is fine to be excessive with when the height is lower.
-	if (lowestCellEnt == entt::null)
-		throw std::runtime_error("Lowest cell entity is null!");
+	const glm::ivec2 landing = glm::ivec2(tetCoordinate.Get()) + GetDirectionOffset(playAreaDirection.GetCurrentDownDirection()) * static_cast<int>(distance);
 
-	const auto& lowestCell = registry.get<Components::Cell>(lowestCellEnt);
-	const auto& lowestCellCoord = registry.get<Components::Coordinate>(lowestCellEnt);
+	return Components::Coordinate(tetCoordinate.GetParent(), glm::uvec2(landing));
+}
 
-	auto& tempTetMoveable = registry.get<Components::Moveable>(tempTetEnt);
+glm::uvec2 FindLowestCell(entt::registry& registry, entt::entity tetrominoEnt)
+{
+	return GetLandingCoordinate(registry, tetrominoEnt).Get();
+}
 
-	tempTetCoord.Set(lowestCellCoord.Get());
-	tempTetCoord.SetParent(lowestCellCoord.GetParent());
-	tempTetMoveable.SetCurrentCoordinate(lowestCellCoord);
-	tempTetMoveable.SetDesiredCoordinate(tempTetMoveable.GetCurrentCoordinate());
+// The ghost piece is four plain renderable blocks, with no Block or Obstructs, so nothing else treats them as occupying a cell.
+void SpawnGhostBlocks(entt::registry& registry, const entt::entity& containerEnt)
+{
+	const auto& container = registry.get<Components::Container>(containerEnt);
 
-	// Destroy the temporary Tetromino and all its blocks.
 	for (int i = 0; i < 4; i++)
 	{
-		registry.destroy(tempTet->GetBlock(i));
+		const auto ghostEnt = registry.create();
+		registry.emplace<Components::Coordinate>(ghostEnt, containerEnt, glm::uvec2(0, 0));
+		registry.emplace<Components::Position>(ghostEnt);
+		registry.emplace<Components::DerivePositionFromCoordinates>(ghostEnt, containerEnt);
+		registry.emplace<Components::Scale>(ghostEnt, container.GetCellDimensions3());
+		registry.emplace<Components::Renderable>(ghostEnt, Components::renderLayer_t::RL_MARKER_UNDER, "./data/block/darkgrey.obj", false);
+		registry.emplace<Components::Orientation>(ghostEnt);
+		registry.emplace<Components::Ghost>(ghostEnt, i);
 	}
-	registry.destroy(tempTetEnt);
-
-	return lowestCellCoord.Get();
 }
 
 double CalculateFallSpeed(int level)
@@ -1746,7 +1962,7 @@ void PlaceWall(entt::registry& registry, const Components::Coordinate& coordinat
 			registry.emplace<Components::Position>(wall);
 			registry.emplace<Components::DerivePositionFromCoordinates>(wall);
 			registry.emplace<Components::Scale>(wall, container2.GetCellDimensions3());
-			registry.emplace<Components::Renderable>(wall, Components::renderLayer_t::RL_MARKER_OVER, Model("./data/block/grey.obj"));
+			registry.emplace<Components::Renderable>(wall, Components::renderLayer_t::RL_MARKER_OVER, "./data/block/grey.obj");
 			registry.emplace<Components::Obstructs>(wall);
 			registry.emplace<Components::Orientation>(wall);
 			registry.emplace<Components::ReferenceEntity>(wall, coordinate.GetParent());
@@ -1754,6 +1970,75 @@ void PlaceWall(entt::registry& registry, const Components::Coordinate& coordinat
 			{
 				registry.emplace<Components::DirectionallyActive>(wall, directions);
 			}
+
+			container2.SetWallBit(coordinate.Get(), true);
+		}
+	}
+}
+
+entt::entity PlaceBagMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const Components::renderLayer_t& layer)
+{
+	auto containerView = registry.view<Components::Container, Components::Tag>();
+	for (auto entity : containerView)
+	{
+		auto& container2 = containerView.get<Components::Container>(entity);
+		auto& containerTag2 = containerView.get<Components::Tag>(entity);
+
+		if (container2.IsEnabled() && containerTag2.IsEnabled())
+		{
+			if (containerTag2.Get() != containerTag)
+				continue;
+
+			entt::entity cellEnt = GetCellAtCoordinates2(registry, markerCoordinate);
+
+			if (cellEnt == entt::null)
+				continue;
+
+			const auto marker = registry.create();
+			registry.emplace<Components::QueueNode>(marker, marker); // Don't attempt to link nodes at first
+			registry.emplace<Components::Coordinate>(marker, markerCoordinate.GetParent(), markerCoordinate.Get());
+			registry.emplace<Components::Position>(marker);
+			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
+			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
+			registry.emplace<Components::Renderable>(marker, layer, "./data/block/green.obj");
+			registry.emplace<Components::Orientation>(marker);
+			registry.emplace<Components::ReferenceEntity>(marker, entity);
+
+			return marker;
+		}
+	}
+
+	return entt::null;
+}
+
+void PlaceSpawnMarker(entt::registry& registry, const std::string& containerTag, const Components::Coordinate& markerCoordinate, const spawnType_t& spawnType, const moveDirection_t& activeDirection, const Components::renderLayer_t& layer)
+{
+	auto containerView = registry.view<Components::Container, Components::Tag>();
+	for (auto entity : containerView)
+	{
+		auto& container2 = containerView.get<Components::Container>(entity);
+		auto& containerTag2 = containerView.get<Components::Tag>(entity);
+
+		if (container2.IsEnabled() && containerTag2.IsEnabled())
+		{
+			if (containerTag2.Get() != containerTag)
+				continue;
+
+			entt::entity cellEnt = GetCellAtCoordinates2(registry, markerCoordinate);
+
+			if (cellEnt == entt::null)
+				continue;
+
+			const auto marker = registry.create();
+			registry.emplace<Components::SpawnMarker>(marker, entity, spawnType);
+			registry.emplace<Components::Coordinate>(marker, markerCoordinate.GetParent(), markerCoordinate.Get());
+			registry.emplace<Components::Position>(marker);
+			registry.emplace<Components::DerivePositionFromCoordinates>(marker);
+			registry.emplace<Components::Scale>(marker, container2.GetCellDimensions3());
+			//registry.emplace<Components::Renderable>(marker, layer, "./data/block/lightblue.obj");
+			registry.emplace<Components::Orientation>(marker);
+			registry.emplace<Components::ReferenceEntity>(marker, entity);
+			registry.emplace<Components::DirectionallyActive>(marker, activeDirection);
 		}
 	}
 }
\ No newline at end of file
@@ -33,6 +33,8 @@
 #include "GameTime.h"
 #include "Globals.h"
 #include "Utility.h"
+#include "Bitboard.h"
+#include "Randomizer.h"
 
 #include "Systems/GenerationSystem.h"
 #include "Systems/FallingSystem.h"
@@ -44,12 +46,21 @@
 #include "Systems/DetachSystem.h"
 #include "Systems/CompletionSystem.h"
 #include "Systems/SoundSystem.h"
+#include "Systems/GhostSystem.h"
 
 #include "Input/InputHandler.h"
 #include "Input/GameInput.h"
+#include "Input/InputSource.h"
+#include "Input/BotInput.h"
+#include "Bot/PlacementSearch.h"
+#include "Bot/Expectimax.h"
 #include "AudioManager.h"
 
 #include "GameState.h"
+#include "Game.h"
+#include "Replay.h"
+#include "Checksum.h"
+#include "ThreadPool.h"
 
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
@@ -379,6 +390,92 @@ TEST(GridTest, Grid3x3) {
 	}
 }
 
+TEST(GridTest, Grid500x1000) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Position>(playArea, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(playArea);
+	registry.emplace<Components::Container>(playArea, glm::uvec2(500, 1000), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::MATRIX));
+
+	BuildGrid(registry, playArea, false);
+
+	EXPECT_EQ(registry.size<Components::Cell>(), 500 * 1000);
+	EXPECT_EQ(registry.size<Components::Tag>(), 1); // Only the container itself.
+
+	entt::entity originEnt = GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(0, 0)));
+	entt::entity cornerEnt = GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(499, 999)));
+	entt::entity middleEnt = GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(250, 500)));
+
+	const auto& origin = registry.get<Components::Cell>(originEnt);
+	EXPECT_TRUE(origin.GetSouth() == entt::null);
+	EXPECT_TRUE(origin.GetWest() == entt::null);
+	EXPECT_EQ(origin.GetNorth(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(0, 1))));
+	EXPECT_EQ(origin.GetEast(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(1, 0))));
+
+	const auto& corner = registry.get<Components::Cell>(cornerEnt);
+	EXPECT_TRUE(corner.GetNorth() == entt::null);
+	EXPECT_TRUE(corner.GetEast() == entt::null);
+	EXPECT_EQ(corner.GetSouth(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(499, 998))));
+	EXPECT_EQ(corner.GetWest(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(498, 999))));
+
+	const auto& middle = registry.get<Components::Cell>(middleEnt);
+	EXPECT_EQ(middle.GetNorth(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(250, 501))));
+	EXPECT_EQ(middle.GetSouth(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(250, 499))));
+	EXPECT_EQ(middle.GetEast(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(251, 500))));
+	EXPECT_EQ(middle.GetWest(), GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(249, 500))));
+	EXPECT_EQ(GetCellDebugName(registry, middleEnt), GetTagFromContainerType(containerType_t::MATRIX) + ":Grid:250-500");
+}
+
+TEST(GridTest, CellIndex3x3) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Position>(playArea, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(playArea);
+	registry.emplace<Components::Container>(playArea, glm::uvec2(3, 3), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::MATRIX));
+
+
+	BuildGrid(registry, playArea);
+
+	auto gridCellView = registry.view<Components::Cell, Components::Coordinate>();
+	for (auto entity : gridCellView)
+	{
+		auto& coordinate = gridCellView.get<Components::Coordinate>(entity);
+
+		EXPECT_TRUE(GetCellAtCoordinates2(registry, coordinate) == entity);
+		EXPECT_TRUE(&GetCellAtCoordinates(registry, GetTagFromContainerType(containerType_t::MATRIX), coordinate) == &gridCellView.get<Components::Cell>(entity));
+	}
+
+	EXPECT_TRUE(GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(3, 0))) == entt::null);
+	EXPECT_TRUE(GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(0, 3))) == entt::null);
+	EXPECT_TRUE(GetCellAtCoordinates2(registry, Components::Coordinate(playArea, glm::uvec2(-1, 0))) == entt::null);
+}
+
+TEST(GridTest, OccupantIndex3x3) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Position>(playArea, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(playArea);
+	registry.emplace<Components::Container>(playArea, glm::uvec2(3, 3), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::MATRIX));
+
+
+	BuildGrid(registry, playArea);
+
+	entt::entity blockEnt = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(playArea, glm::uvec2(1, 1)));
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(playArea, glm::uvec2(1, 1))) == blockEnt);
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(playArea, glm::uvec2(0, 0))) == entt::null);
+
+	RelocateBlock(registry, Components::Coordinate(playArea, glm::uvec2(2, 0)), blockEnt);
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(playArea, glm::uvec2(1, 1))) == entt::null);
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(playArea, glm::uvec2(2, 0))) == blockEnt);
+	EXPECT_TRUE(&GetBlockAtCoordinates(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(playArea, glm::uvec2(2, 0))) == &registry.get<Components::Block>(blockEnt));
+}
+
 TEST(ObstructionTest, Step1EastClear) {
 	entt::registry registry;
 
@@ -752,6 +849,158 @@ TEST(PatternTest, Pattern4LinesFound) {
 	EXPECT_TRUE(linesFound == 4);
 }
 
+TEST(PatternTest, FillCountersFollowBlocks) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(3, 3), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0, 0)), false);
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0, 1)), false);
+	auto block = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1, 0)), false);
+
+	auto& container = registry.get<Components::Container>(matrix);
+	EXPECT_EQ(container.GetRowFill(0), 2);
+	EXPECT_EQ(container.GetColumnFill(0), 2);
+
+	RelocateBlock(registry, Components::Coordinate(matrix, glm::uvec2(0, 2)), block);
+	EXPECT_EQ(container.GetRowFill(0), 1);
+	EXPECT_EQ(container.GetRowFill(2), 1);
+	EXPECT_EQ(container.GetColumnFill(0), 3);
+	EXPECT_EQ(container.GetColumnFill(1), 0);
+
+	auto blockView = registry.view<Components::Block, Components::Moveable>();
+	for (auto entity : blockView)
+	{
+		auto& moveable = blockView.get<Components::Moveable>(entity);
+		moveable.SetMovementState(Components::movementStates_t::LOCKED);
+	}
+
+	// North facing matches rows; a full column only counts once the board faces east or west.
+	EXPECT_EQ(Systems::PatternSystem(registry, 3, 0), 0);
+	registry.get<Components::CardinalDirection>(playArea).SetCurrentOrientation(moveDirection_t::EAST);
+	EXPECT_EQ(Systems::PatternSystem(registry, 3, 0), 1);
+	EXPECT_EQ(registry.size<Components::Hittable>(), 3);
+}
+
+TEST(BitboardTest, FindFullLines) {
+	// 5 wide board, 7 rows, so every kernel runs its scalar tail too.
+	uint64_t rows[7] = { 0x1F, 0x1B, 0x1F, 0x3F, 0x00, 0x1F, 0x0F };
+
+	EXPECT_EQ(Bitboard::FindFullRows(rows, 7, Bitboard::SpanMask(0, 5)), uint64_t(0x2D));
+	EXPECT_EQ(Bitboard::FindFullRows(rows, 7, Bitboard::SpanMask(1, 3)), uint64_t(0x6D)); // 0x1B has a gap at bit 2, 0x0F covers the span.
+	EXPECT_EQ(Bitboard::FindFullColumns(rows, 4, Bitboard::SpanMask(0, 5)), uint64_t(0x1B));
+	EXPECT_EQ(Bitboard::FindFullColumns(rows, 7, Bitboard::SpanMask(0, 5)), uint64_t(0x00));
+
+	EXPECT_EQ(Bitboard::FindRowsWithCount(rows, 7, 5), uint64_t(0x25));
+	EXPECT_EQ(Bitboard::FindRowsWithCount(rows, 7, 4), uint64_t(0x42));
+	EXPECT_EQ(Bitboard::FindColumnsWithCount(rows, 7, 5), uint64_t(0x14));
+	EXPECT_EQ(Bitboard::FindColumnsWithCount(rows, 7, 1), uint64_t(0x20));
+}
+
+TEST(BitboardTest, CompactLines) {
+	uint64_t rows[5] = { 0x1, 0x2, 0x3, 0x4, 0x5 };
+	Bitboard::CompactRows(rows, 5, 0x0A, true); // Clear rows 1 and 3.
+	EXPECT_EQ(rows[0], uint64_t(0x1));
+	EXPECT_EQ(rows[1], uint64_t(0x3));
+	EXPECT_EQ(rows[2], uint64_t(0x5));
+	EXPECT_EQ(rows[3], uint64_t(0x0));
+	EXPECT_EQ(rows[4], uint64_t(0x0));
+
+	uint64_t rows2[5] = { 0x1, 0x2, 0x3, 0x4, 0x5 };
+	Bitboard::CompactRows(rows2, 5, 0x0A, false);
+	EXPECT_EQ(rows2[0], uint64_t(0x0));
+	EXPECT_EQ(rows2[1], uint64_t(0x0));
+	EXPECT_EQ(rows2[2], uint64_t(0x1));
+	EXPECT_EQ(rows2[3], uint64_t(0x3));
+	EXPECT_EQ(rows2[4], uint64_t(0x5));
+
+	// Columns 1 to 6 are the span. Clearing column 3 slides the span's other bits across it; bits outside the span stay put.
+	EXPECT_EQ(Bitboard::CompactColumnsOfRow(0xDB, 0x08, Bitboard::SpanMask(1, 6), true), uint64_t(0xAB));
+	EXPECT_EQ(Bitboard::CompactColumnsOfRow(0xDB, 0x08, Bitboard::SpanMask(1, 6), false), uint64_t(0xD5));
+}
+
+TEST(CellLinkTest, LinkResolvedOntoCell) {
+	entt::registry registry;
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(3, 2), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+
+	const auto buffer = registry.create();
+	registry.emplace<Components::Position>(buffer, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(buffer);
+	registry.emplace<Components::Container>(buffer, glm::uvec2(3, 2), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(buffer, GetTagFromContainerType(containerType_t::BUFFER));
+
+	BuildGrid(registry, matrix);
+	BuildGrid(registry, buffer);
+
+	LinkCoordinates(registry, Components::Coordinate(buffer, glm::uvec2(1, 0)), Components::Coordinate(matrix, glm::uvec2(1, 1)), moveDirection_t::SOUTH, moveDirection_t::SOUTH);
+
+	entt::entity bufferCellEnt = GetCellAtCoordinates2(registry, Components::Coordinate(buffer, glm::uvec2(1, 0)));
+	entt::entity matrixCellEnt = GetCellAtCoordinates2(registry, Components::Coordinate(matrix, glm::uvec2(1, 1)));
+	const auto& bufferCell = registry.get<Components::Cell>(bufferCellEnt);
+
+	EXPECT_EQ(bufferCell.GetLink(moveDirection_t::SOUTH), matrixCellEnt);
+	EXPECT_TRUE(bufferCell.GetLink(moveDirection_t::NORTH) == entt::null);
+	EXPECT_TRUE(registry.get<Components::Cell>(matrixCellEnt).GetLink(moveDirection_t::NORTH) == entt::null);
+}
+
+TEST(CellLinkTest, ConnectGridsNorthToSouth) {
+	entt::registry registry;
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(3, 2), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+
+	const auto buffer = registry.create();
+	registry.emplace<Components::Position>(buffer, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(buffer);
+	registry.emplace<Components::Container>(buffer, glm::uvec2(3, 2), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(buffer, GetTagFromContainerType(containerType_t::BUFFER));
+
+	BuildGrid(registry, matrix);
+	BuildGrid(registry, buffer);
+
+	ConnectGrids(registry, matrix, moveDirection_t::NORTH, buffer, moveDirection_t::SOUTH);
+
+	// No debug markers unless asked for.
+	EXPECT_EQ(registry.size<Components::CellLink>(), 0);
+
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		const auto& matrixCell = registry.get<Components::Cell>(GetCellAtCoordinates2(registry, Components::Coordinate(matrix, glm::uvec2(i, 1))));
+		const auto& bufferCell = registry.get<Components::Cell>(GetCellAtCoordinates2(registry, Components::Coordinate(buffer, glm::uvec2(i, 0))));
+
+		EXPECT_EQ(matrixCell.GetLink(moveDirection_t::NORTH), GetCellAtCoordinates2(registry, Components::Coordinate(buffer, glm::uvec2(i, 0))));
+		EXPECT_EQ(bufferCell.GetLink(moveDirection_t::SOUTH), GetCellAtCoordinates2(registry, Components::Coordinate(matrix, glm::uvec2(i, 1))));
+	}
+
+	entt::entity blockEnt = SpawnBlock(registry, GetTagFromContainerType(containerType_t::BUFFER), Components::Coordinate(buffer, glm::uvec2(2, 1)));
+	entt::entity endCellEnt = MoveBlockInDirection(registry, blockEnt, moveDirection_t::SOUTH, 2);
+	Components::Coordinate endCoord = GetCoordinateOfEntity(registry, endCellEnt);
+	EXPECT_EQ(endCoord.GetParent(), matrix);
+	EXPECT_TRUE(endCoord.Get() == glm::uvec2(2, 1));
+
+	ConnectGrids(registry, matrix, moveDirection_t::WEST, buffer, moveDirection_t::EAST, true);
+	EXPECT_EQ(registry.size<Components::CellLink>(), 4);
+}
+
 TEST(CellLinkTest, Step1SouthFromOutClear) {
 	entt::registry registry;
 
@@ -1185,7 +1434,7 @@ TEST(TetrominoMovementTest, Step1EastClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1197,7 +1446,7 @@ TEST(TetrominoMovementTest, Step1EastClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1254,7 +1503,7 @@ TEST(TetrominoMovementTest, Step1SouthClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1266,7 +1515,7 @@ TEST(TetrominoMovementTest, Step1SouthClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1323,7 +1572,7 @@ TEST(TetrominoMovementTest, Step1WestClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1335,7 +1584,7 @@ TEST(TetrominoMovementTest, Step1WestClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1392,7 +1641,7 @@ TEST(TetrominoMovementObstructionTest, Step1EastObstructedByNull) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1404,7 +1653,7 @@ TEST(TetrominoMovementObstructionTest, Step1EastObstructedByNull) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1461,7 +1710,7 @@ TEST(TetrominoMovementObstructionTest, Step1EastObstructedByWall) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1473,7 +1722,7 @@ TEST(TetrominoMovementObstructionTest, Step1EastObstructedByWall) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1530,6 +1779,144 @@ TEST(TetrominoMovementObstructionTest, Step1EastObstructedByWall) {
 	EXPECT_TRUE(ValidateBlockPositions(registry, glm::uvec2(8, 6), glm::uvec2(9, 6), glm::uvec2(10, 6), glm::uvec2(11, 6)));
 }
 
+TEST(TetrominoMovementObstructionTest, FitAgainstOccupancyBitmask) {
+	entt::registry registry;
+
+	int testPlayAreaWidth = 6;
+	int testPlayAreaHeight = 6;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(testPlayAreaWidth + (BufferAreaDepth * 2), testPlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	for (int i = 0; i < testPlayAreaHeight + (BufferAreaDepth * 2); i++)
+	{
+		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(13, i)), false, {});
+	}
+
+	auto tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 6)), tetrominoType_t::I);
+	auto block = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 5)), false);
+
+	// The piece's own blocks are never on the bitmask.
+	EXPECT_TRUE(ValidateBlockPositions(registry, glm::uvec2(8, 6), glm::uvec2(9, 6), glm::uvec2(10, 6), glm::uvec2(11, 6)));
+	EXPECT_TRUE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(9, 6)), moveDirection_t::NORTH));
+	EXPECT_TRUE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(10, 6)), moveDirection_t::NORTH));
+
+	// Walls, settled blocks, and the edge of the grid all get in the way.
+	EXPECT_FALSE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(11, 6)), moveDirection_t::NORTH));
+	EXPECT_FALSE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(9, 5)), moveDirection_t::NORTH));
+	EXPECT_FALSE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(0, 6)), moveDirection_t::NORTH));
+
+	RelocateBlock(registry, Components::Coordinate(matrix, glm::uvec2(2, 2)), block);
+	EXPECT_TRUE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(9, 5)), moveDirection_t::NORTH));
+	EXPECT_FALSE(DoesTetrominoFit(registry, tet, Components::Coordinate(matrix, glm::uvec2(3, 2)), moveDirection_t::NORTH));
+}
+
+TEST(TetrominoMovementObstructionTest, DropDistanceAndGhost) {
+	entt::registry registry;
+
+	int testPlayAreaWidth = 6;
+	int testPlayAreaHeight = 6;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(testPlayAreaWidth + (BufferAreaDepth * 2), testPlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+	SpawnGhostBlocks(registry, matrix);
+
+	auto tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 6)), tetrominoType_t::I);
+
+	// Nothing beneath; falls to the bottom edge of the grid.
+	EXPECT_EQ(GetDropDistance(registry, tet), 6);
+
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(11, 2)), false);
+	EXPECT_EQ(GetDropDistance(registry, tet), 3);
+	EXPECT_EQ(GetLandingCoordinate(registry, tet).Get(), glm::uvec2(9, 3));
+	EXPECT_EQ(registry.size<Components::Block>(), 5); // No temporary entities left behind.
+
+	Systems::GhostSystem(registry, 0.0);
+
+	auto ghostView = registry.view<Components::Ghost, Components::Coordinate, Components::Renderable>();
+	for (auto entity : ghostView)
+	{
+		EXPECT_TRUE(ghostView.get<Components::Renderable>(entity).IsEnabled());
+		EXPECT_EQ(ghostView.get<Components::Coordinate>(entity).Get().y, 3);
+	}
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(matrix, glm::uvec2(9, 3))) == entt::null); // Ghosts never occupy a cell.
+}
+
+TEST(TetrominoMovementObstructionTest, DropDistanceMatchesSteppingInEveryDirection) {
+	entt::registry registry;
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(12, 14), glm::uvec2(cellWidth, cellHeight));
+	BuildGrid(registry, matrix, false);
+
+	auto& container = registry.get<Components::Container>(matrix);
+	for (unsigned int y = 0; y < 14; y++)
+	{
+		for (unsigned int x = 0; x < 12; x++)
+		{
+			if ((x * 7 + y * 13) % 9 == 0)
+				container.SetBlockBit(glm::uvec2(x, y), true);
+		}
+	}
+
+	const std::array<glm::ivec2, 4> shape = { glm::ivec2(0, 0), glm::ivec2(1, 0), glm::ivec2(2, 0), glm::ivec2(1, 1) };
+	const std::array<glm::ivec2, 4> steps = { glm::ivec2(0, -1), glm::ivec2(0, 1), glm::ivec2(-1, 0), glm::ivec2(1, 0) };
+
+	for (const auto& step : steps)
+	{
+		for (int y = 0; y < 13; y++)
+		{
+			for (int x = 0; x < 10; x++)
+			{
+				std::array<glm::ivec2, 4> cells;
+				for (int i = 0; i < 4; i++)
+					cells[i] = shape[i] + glm::ivec2(x, y);
+
+				if (!AreTetrominoCellsFree(container, cells))
+					continue;
+
+				unsigned int stepped = 0;
+				auto moved = cells;
+				while (true)
+				{
+					for (auto& cell : moved)
+						cell += step;
+					if (!AreTetrominoCellsFree(container, moved))
+						break;
+					stepped++;
+				}
+
+				EXPECT_EQ(GetDropDistance(container, cells, step), stepped);
+			}
+		}
+	}
+}
+
 TEST(TetrominoRotationTest, Rotate1ClockwiseClear) {
 	entt::registry registry;
 
@@ -1537,7 +1924,7 @@ TEST(TetrominoRotationTest, Rotate1ClockwiseClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1549,7 +1936,7 @@ TEST(TetrominoRotationTest, Rotate1ClockwiseClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1606,7 +1993,7 @@ TEST(TetrominoRotationTest, Rotate2ClockwiseClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1618,7 +2005,7 @@ TEST(TetrominoRotationTest, Rotate2ClockwiseClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1680,7 +2067,7 @@ TEST(TetrominoRotationTest, Rotate3ClockwiseClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1692,7 +2079,7 @@ TEST(TetrominoRotationTest, Rotate3ClockwiseClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1759,7 +2146,7 @@ TEST(TetrominoRotationTest, Rotate4ClockwiseClear) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1771,7 +2158,7 @@ TEST(TetrominoRotationTest, Rotate4ClockwiseClear) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1843,7 +2230,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1ClockwiseObstructedByNull) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1855,7 +2242,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1ClockwiseObstructedByNull) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -1925,7 +2312,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1CounterClockwiseObstructedByNull)
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -1937,7 +2324,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1CounterClockwiseObstructedByNull)
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2007,7 +2394,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1ClockwiseObstructedByWall) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2019,7 +2406,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1ClockwiseObstructedByWall) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2095,7 +2482,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1CounterClockwiseObstructedByWall)
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2107,7 +2494,7 @@ TEST(TetrominoRotationObstructionTest, Rotate1CounterClockwiseObstructedByWall)
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2183,7 +2570,7 @@ TEST(TetrominoMovementObstructionTest, Step1SouthObstructedByBlock) {
 	int testPlayAreaHeight = 6;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2195,7 +2582,7 @@ TEST(TetrominoMovementObstructionTest, Step1SouthObstructedByBlock) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2254,7 +2641,7 @@ TEST(CollapseTest, Collapse1Test) {
 	int testPlayAreaHeight = 3;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2266,7 +2653,7 @@ TEST(CollapseTest, Collapse1Test) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2331,7 +2718,7 @@ TEST(CollapseTest, Collapse2Test) {
 	int testPlayAreaHeight = 4;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2343,7 +2730,7 @@ TEST(CollapseTest, Collapse2Test) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2411,7 +2798,7 @@ TEST(CollapseTest, Collapse1GapTest) {
 	int testPlayAreaHeight = 5;
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2423,7 +2810,7 @@ TEST(CollapseTest, Collapse1GapTest) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2490,13 +2877,64 @@ TEST(CollapseTest, Collapse1GapTest) {
 	EXPECT_TRUE(ValidateBlockPositions(registry, glm::uvec2(0, 1), glm::uvec2(1, 1), glm::uvec2(0, 2), glm::uvec2(1, 2)));
 }
 
+TEST(CollapseTest, CollapseColumnEastTest) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+	registry.get<Components::CardinalDirection>(playArea).SetCurrentOrientation(moveDirection_t::EAST);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(4, 3), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	// This column is going to be eliminated
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(3, 0)), false);
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(3, 1)), false);
+	SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(3, 2)), false);
+
+	// These shift east by one
+	auto block1 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1, 0)), false);
+	auto block2 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(2, 1)), false);
+
+	auto blockView = registry.view<Components::Block, Components::Moveable>();
+	for (auto entity : blockView)
+	{
+		blockView.get<Components::Moveable>(entity).SetMovementState(Components::movementStates_t::LOCKED);
+	}
+
+	EXPECT_EQ(Systems::PatternSystem(registry, 3, 0), 1);
+	Systems::EliminateSystem(registry, 0);
+
+	EXPECT_EQ(registry.get<Components::Coordinate>(block1).Get(), glm::uvec2(2, 0));
+	EXPECT_EQ(registry.get<Components::Coordinate>(block2).Get(), glm::uvec2(3, 1));
+	EXPECT_EQ(registry.get<Components::Moveable>(block2).GetCurrentCoordinate().Get(), glm::uvec2(3, 1));
+
+	// The occupancy index, bitmask and fill counts all moved with them.
+	const auto& container = registry.get<Components::Container>(matrix);
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(matrix, glm::uvec2(3, 1))) == block2);
+	EXPECT_TRUE(GetOccupantAtCoordinates(registry, Components::Coordinate(matrix, glm::uvec2(1, 0))) == entt::null);
+	EXPECT_TRUE(container.IsBlockBitSet(glm::uvec2(2, 0)));
+	EXPECT_FALSE(container.IsBlockBitSet(glm::uvec2(3, 0)));
+	EXPECT_EQ(container.GetColumnFill(3), 1);
+	EXPECT_EQ(container.GetColumnFill(2), 1);
+	EXPECT_EQ(container.GetColumnFill(1), 0);
+	EXPECT_EQ(container.GetRowFill(0), 1);
+}
+
 TEST(PlayAreaRotationTest, BlockPositionsTest) {
 	entt::registry registry;
 
 	// Some of the things we're testing aren't written to be simplfied, so we need to use a full-size board with buffers and walls, or it won't work properly.
 
 	const auto playArea = registry.create();
-	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));//"./data/quads/block.obj"));
+	registry.emplace<Components::Renderable>(playArea, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");//"./data/quads/block.obj"));
 	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * PlayAreaWidth, cellHeight * PlayAreaHeight));
 	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
 	//registry.emplace<Components::Scale>(playArea);
@@ -2508,7 +2946,7 @@ TEST(PlayAreaRotationTest, BlockPositionsTest) {
 	registry.emplace<Components::CardinalDirection>(playArea);
 
 	const auto matrix = registry.create();
-	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, Model("./data/block/block.obj"));
+	//registry.emplace<Components::Renderable>(matrix, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
 	//registry.emplace<Components::Scale>(matrix, glm::uvec2(1, 1));
 	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (PlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (PlayAreaHeight + (BufferAreaDepth * 2))));
 	registry.emplace<Components::Position>(matrix);
@@ -2594,4 +3032,975 @@ TEST(PlayAreaRotationTest, BlockPositionsTest) {
 		glm::uvec2(9 + BufferAreaDepth, 0 + BufferAreaDepth),
 		glm::uvec2(8 + BufferAreaDepth, 1 + BufferAreaDepth),
 		glm::uvec2(9 + BufferAreaDepth, 1 + BufferAreaDepth)));
+}
+
+TEST(PlayAreaRotationTest, DetachNonAdjacentRowsTest) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * PlayAreaWidth, cellHeight * PlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (PlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (PlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth * 2), PlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	for (int i = BufferAreaDepth - 1; i < PlayAreaWidth + BufferAreaDepth + 1; i++)
+	{
+		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))), true, { moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::WEST });
+	}
+
+	UpdateDirectionalWalls(registry);
+
+	// Blocks separated by empty rows, in two columns.
+	auto block1 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + BufferAreaDepth, 2 + BufferAreaDepth)), false);
+	auto block2 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + BufferAreaDepth, 5 + BufferAreaDepth)), false);
+	auto block3 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1 + BufferAreaDepth, 0 + BufferAreaDepth)), false);
+	auto block4 = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1 + BufferAreaDepth, 4 + BufferAreaDepth)), false);
+
+	auto blockView = registry.view<Components::Block, Components::Obstructable>();
+	for (auto entity : blockView)
+	{
+		blockView.get<Components::Obstructable>(entity).SetIsObstructed(true);
+	}
+
+	Systems::DetachSystem(registry, 10000);
+
+	EXPECT_EQ(registry.get<Components::Moveable>(block1).GetDesiredCoordinate().Get(), glm::uvec2(0 + BufferAreaDepth, 0 + BufferAreaDepth));
+	EXPECT_EQ(registry.get<Components::Moveable>(block2).GetDesiredCoordinate().Get(), glm::uvec2(0 + BufferAreaDepth, 1 + BufferAreaDepth));
+	EXPECT_EQ(registry.get<Components::Moveable>(block3).GetDesiredCoordinate().Get(), glm::uvec2(1 + BufferAreaDepth, 0 + BufferAreaDepth));
+	EXPECT_EQ(registry.get<Components::Moveable>(block4).GetDesiredCoordinate().Get(), glm::uvec2(1 + BufferAreaDepth, 1 + BufferAreaDepth));
+	EXPECT_TRUE(registry.get<Components::Moveable>(block4).GetMovementState() == Components::movementStates_t::HARD_DROP);
+}
+
+TEST(PlayAreaRotationTest, DetachWakesOnlyFallingBlocks) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * PlayAreaWidth, cellHeight * PlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (PlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (PlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(PlayAreaWidth + (BufferAreaDepth * 2), PlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	// The floor the blocks settle on. Detaching only stops at active walls and the edge of the matrix.
+	for (int i = BufferAreaDepth - 1; i < PlayAreaWidth + BufferAreaDepth + 1; i++)
+	{
+		PlaceWall(registry, Components::Coordinate(matrix, glm::uvec2(i, 0 + (BufferAreaDepth - 1))), true, { moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::WEST });
+	}
+
+	UpdateDirectionalWalls(registry);
+
+	auto floorBlock = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0 + BufferAreaDepth, 0 + BufferAreaDepth)), false);
+	auto hoveringBlock = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1 + BufferAreaDepth, 3 + BufferAreaDepth)), false);
+
+	auto blockView = registry.view<Components::Block, Components::Moveable, Components::Obstructable>();
+	for (auto entity : blockView)
+	{
+		blockView.get<Components::Moveable>(entity).SetMovementState(Components::movementStates_t::LOCKED);
+		blockView.get<Components::Obstructable>(entity).SetIsObstructed(true);
+	}
+
+	EXPECT_EQ(registry.size<Components::Awake>(), 2);
+
+	// Once settled, nothing is left for the per-tick systems to visit.
+	std::vector<BlockLockData> blockLockData;
+	Systems::StateChangeSystem(registry, 10000, blockLockData);
+	EXPECT_EQ(registry.size<Components::Awake>(), 0);
+
+	Systems::DetachSystem(registry, 10000);
+	EXPECT_FALSE(registry.all_of<Components::Awake>(floorBlock));
+	EXPECT_TRUE(registry.all_of<Components::Awake>(hoveringBlock));
+
+	Systems::MovementSystem(registry, 10000);
+	Systems::StateChangeSystem(registry, 10000, blockLockData);
+	EXPECT_EQ(registry.get<Components::Coordinate>(hoveringBlock).Get(), glm::uvec2(1 + BufferAreaDepth, 0 + BufferAreaDepth));
+	EXPECT_TRUE(registry.get<Components::Moveable>(hoveringBlock).GetMovementState() == Components::movementStates_t::LOCKED);
+	EXPECT_EQ(registry.size<Components::Awake>(), 0);
+}
+
+TEST(PlayAreaRotationTest, SettledBlocksLeaveAwakeGroup) {
+	entt::registry registry;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Position>(matrix, glm::vec3(displayData.x / 2, displayData.y / 2, 0.0f));
+	registry.emplace<Components::Scale>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(3, 3), glm::vec2(25, 25));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+
+	auto settledBlock = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(0, 0)), false);
+	auto parkedBlock = SpawnBlock(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(1, 0)), false);
+	registry.get<Components::Moveable>(settledBlock).SetMovementState(Components::movementStates_t::LOCKED);
+
+	EXPECT_EQ(GetAwakeGroup(registry).size(), 2);
+
+	std::vector<BlockLockData> blockLockData;
+	Systems::StateChangeSystem(registry, 0, blockLockData);
+
+	// Both have come to rest, but only the settled one is part of the stack.
+	EXPECT_EQ(GetAwakeGroup(registry).size(), 0);
+	EXPECT_TRUE(registry.all_of<Components::Locked>(settledBlock));
+	EXPECT_FALSE(registry.all_of<Components::Locked>(parkedBlock));
+
+	WakeEntity(registry, settledBlock);
+	EXPECT_EQ(GetAwakeGroup(registry).size(), 1);
+	EXPECT_FALSE(registry.all_of<Components::Locked>(settledBlock));
+}
+
+TEST(RenderOrderTest, GroupSortedByLayer) {
+	entt::registry registry;
+	TrackRenderOrder(registry);
+
+	const Components::renderLayer_t layers[] = { Components::renderLayer_t::RL_BLOCK, Components::renderLayer_t::RL_CONTAINER, Components::renderLayer_t::RL_MARKER_OVER, Components::renderLayer_t::RL_CELL, Components::renderLayer_t::RL_MARKER_UNDER };
+	for (const auto& layer : layers)
+	{
+		const auto entity = registry.create();
+		registry.emplace<Components::Renderable>(entity, layer, "./data/block/block.obj");
+		registry.emplace<Components::Position>(entity);
+		registry.emplace<Components::Orientation>(entity);
+		registry.emplace<Components::Scale>(entity);
+	}
+
+	// Not drawn without all four components, so left out of the group.
+	registry.emplace<Components::Renderable>(registry.create(), Components::renderLayer_t::RL_CELL, "./data/block/block.obj");
+
+	SortRenderGroup(registry);
+
+	auto renderGroup = GetRenderGroup(registry);
+	EXPECT_EQ(renderGroup.size(), 5);
+
+	int previousLayer = Components::renderLayer_t::RL_MIN;
+	for (auto entity : renderGroup)
+	{
+		const int layer = renderGroup.get<Components::Renderable>(entity).GetLayer();
+		EXPECT_GE(layer, previousLayer);
+		previousLayer = layer;
+	}
+
+	// A late arrival on a low layer still gets drawn before everything above it.
+	const auto lateEntity = registry.create();
+	registry.emplace<Components::Renderable>(lateEntity, Components::renderLayer_t::RL_CONTAINER, "./data/block/block.obj");
+	registry.emplace<Components::Position>(lateEntity);
+	registry.emplace<Components::Orientation>(lateEntity);
+	registry.emplace<Components::Scale>(lateEntity);
+
+	SortRenderGroup(registry);
+
+	previousLayer = Components::renderLayer_t::RL_MIN;
+	for (auto entity : renderGroup)
+	{
+		const int layer = renderGroup.get<Components::Renderable>(entity).GetLayer();
+		EXPECT_GE(layer, previousLayer);
+		previousLayer = layer;
+	}
+	EXPECT_EQ(renderGroup.size(), 6);
+}
+
+TEST(RenderOrderTest, SameModelsAdjacentWithinLayer) {
+	entt::registry registry;
+	TrackRenderOrder(registry);
+
+	const std::string models[] = { "./data/block/red.obj", "./data/block/grey.obj", "./data/block/red.obj", "./data/block/grey.obj", "./data/block/red.obj" };
+	for (const auto& model : models)
+	{
+		const auto entity = registry.create();
+		registry.emplace<Components::Renderable>(entity, Components::renderLayer_t::RL_BLOCK, model);
+		registry.emplace<Components::Position>(entity);
+		registry.emplace<Components::Orientation>(entity);
+		registry.emplace<Components::Scale>(entity);
+	}
+
+	SortRenderGroup(registry);
+
+	// Each model only starts once, so its draws all come together.
+	std::vector<std::string> runs;
+	auto renderGroup = GetRenderGroup(registry);
+	for (auto entity : renderGroup)
+	{
+		const auto& path = renderGroup.get<Components::Renderable>(entity).GetModelPath();
+		if (runs.empty() || runs.back() != path)
+			runs.push_back(path);
+	}
+	EXPECT_EQ(runs.size(), 2);
+}
+
+TEST(TetrominoTableTest, RotationEntriesMatchTargetOrientation) {
+	// Rotation entries are the pattern of the orientation turned into, for every type.
+	for (int type = 0; type < Components::TetrominoTables::TypeCount; type++)
+	{
+		const Components::Tetromino tetromino(static_cast<tetrominoType_t>(type), moveDirection_t::NORTH);
+		const moveDirection_t orientations[] = { moveDirection_t::NORTH, moveDirection_t::EAST, moveDirection_t::SOUTH, moveDirection_t::WEST };
+		for (const auto& orientation : orientations)
+		{
+			const rotationDirection_t rotations[] = { rotationDirection_t::CLOCKWISE, rotationDirection_t::COUNTERCLOCKWISE };
+			for (const auto& rotation : rotations)
+			{
+				const moveDirection_t target = tetromino.GetNewOrientation(rotation, orientation);
+				for (int i = 0; i < 4; i++)
+				{
+					EXPECT_EQ(tetromino.GetBlockOffsetCoordinates(orientation, i, rotation), tetromino.GetBlockOffsetCoordinates(target, i));
+				}
+			}
+		}
+	}
+
+	// T pointing north, measured from its center.
+	const Components::Tetromino tTetromino(tetrominoType_t::T, moveDirection_t::NORTH);
+	EXPECT_EQ(tTetromino.GetBlockOffsetCoordinates(moveDirection_t::NORTH, 0), glm::vec2(-1, 0));
+	EXPECT_EQ(tTetromino.GetBlockOffsetCoordinates(moveDirection_t::NORTH, 3), glm::vec2(0, 1));
+	EXPECT_EQ(tTetromino.GetPatternWidth(), 3);
+
+	const Components::Tetromino iTetromino(tetrominoType_t::I, moveDirection_t::NORTH);
+	EXPECT_EQ(iTetromino.GetBlockOffsetCoordinates(moveDirection_t::EAST, 0), glm::vec2(1, -2));
+	EXPECT_EQ(iTetromino.GetPatternHeight(), 4);
+	EXPECT_EQ(GetTetrominoSpawnCoordinates(tetrominoType_t::I), glm::uvec2(4, 18));
+}
+
+TEST(BlockPoolTest, ClearedBlocksAreReused) {
+	entt::registry registry;
+
+	int testPlayAreaWidth = 6;
+	int testPlayAreaHeight = 6;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(testPlayAreaWidth + (BufferAreaDepth * 2), testPlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	BuildGrid(registry, matrix);
+	ReserveBlockStorage(registry, 16);
+
+	auto tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 6)), tetrominoType_t::I);
+	std::vector<entt::entity> blocks;
+	for (int i = 0; i < 4; i++)
+		blocks.push_back(GetTetrominoFromEntity(registry, tet)->GetBlock(i));
+
+	const auto entityCount = registry.size();
+	const auto coordinateCapacity = registry.capacity<Components::Coordinate>();
+
+	registry.destroy(tet);
+	for (const auto& block : blocks)
+	{
+		ClearOccupantAtCoordinates(registry, registry.get<Components::Coordinate>(block), block);
+		ReleaseBlock(registry, block);
+
+		// Parked blocks keep their model, and nothing else.
+		EXPECT_TRUE(registry.valid(block));
+		EXPECT_TRUE(registry.all_of<Components::Parked>(block));
+		EXPECT_TRUE(registry.all_of<Components::Renderable>(block));
+		EXPECT_FALSE(registry.any_of<Components::Block>(block));
+		EXPECT_FALSE(registry.any_of<Components::Coordinate>(block));
+	}
+
+	// Parked by the type of piece they came from, ready for the next piece of that type.
+	EXPECT_EQ(GetGameContext(registry).parkedBlocks[static_cast<int>(tetrominoType_t::I)].size(), 4);
+	EXPECT_TRUE(GetGameContext(registry).parkedBlocks[static_cast<int>(tetrominoType_t::T)].empty());
+
+	// The next piece with the same model takes the parked blocks back, without the registry growing.
+	tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 6)), tetrominoType_t::I);
+	for (int i = 0; i < 4; i++)
+	{
+		const auto block = GetTetrominoFromEntity(registry, tet)->GetBlock(i);
+		EXPECT_NE(std::find(blocks.begin(), blocks.end(), block), blocks.end());
+		EXPECT_FALSE(registry.all_of<Components::Parked>(block));
+		EXPECT_TRUE((registry.all_of<Components::Block, Components::Follower, Components::Awake>(block)));
+	}
+	EXPECT_TRUE(ValidateBlockPositions(registry, glm::uvec2(8, 6), glm::uvec2(9, 6), glm::uvec2(10, 6), glm::uvec2(11, 6)));
+	EXPECT_EQ(registry.size(), entityCount);
+	EXPECT_EQ(registry.capacity<Components::Coordinate>(), coordinateCapacity);
+	EXPECT_EQ(registry.view<Components::Parked>().size(), 0);
+	EXPECT_TRUE(GetGameContext(registry).parkedBlocks[static_cast<int>(tetrominoType_t::I)].empty());
+
+	// Recycling a piece's blocks leaves the render group the same size, so the pool has to mark the draw order stale itself.
+	SortRenderGroup(registry);
+	EXPECT_FALSE(GetGameContext(registry).renderOrderDirty);
+	ReleaseTetromino(registry, tet);
+	tet = SpawnTetromino(registry, GetTagFromContainerType(containerType_t::MATRIX), Components::Coordinate(matrix, glm::uvec2(9, 6)), tetrominoType_t::I);
+	EXPECT_TRUE(GetGameContext(registry).renderOrderDirty);
+
+	SortRenderGroup(registry);
+	auto renderGroup = GetRenderGroup(registry);
+	int previousLayer = Components::renderLayer_t::RL_MIN;
+	for (auto entity : renderGroup)
+	{
+		const int layer = renderGroup.get<Components::Renderable>(entity).GetLayer();
+		EXPECT_GE(layer, previousLayer);
+		previousLayer = layer;
+	}
+}
+
+TEST(PreviewQueueTest, RingWrapsAndNodesFollowQueue) {
+	Components::PreviewQueue ring(Components::PreviewQueue::MaximumDepth);
+	EXPECT_THROW(ring.SetDepth(0), std::runtime_error);
+	EXPECT_THROW(ring.SetDepth(Components::PreviewQueue::MaximumDepth + 1), std::runtime_error);
+
+	// Well past the end of the ring, the order still comes back out as it went in.
+	for (int i = 0; i < 50; i++)
+	{
+		while (!ring.IsFull())
+			ring.Push(static_cast<tetrominoType_t>((i + ring.GetSize()) % Components::TetrominoTables::TypeCount));
+
+		EXPECT_EQ(ring.Peek(1), static_cast<tetrominoType_t>((i + 1) % Components::TetrominoTables::TypeCount));
+		EXPECT_EQ(ring.Pop(), static_cast<tetrominoType_t>(i % Components::TetrominoTables::TypeCount));
+	}
+
+	entt::registry registry;
+
+	int testPlayAreaWidth = 10;
+	int testPlayAreaHeight = 10;
+
+	const auto playArea = registry.create();
+	registry.emplace<Components::Scale>(playArea, glm::vec2(cellWidth * testPlayAreaWidth, cellHeight * testPlayAreaHeight));
+	registry.emplace<Components::Position>(playArea, glm::vec2(displayData.x / 2, displayData.y / 2));
+	registry.emplace<Components::Tag>(playArea, GetTagFromContainerType(containerType_t::PLAY_AREA));
+	registry.emplace<Components::CardinalDirection>(playArea);
+
+	const auto matrix = registry.create();
+	registry.emplace<Components::Scale>(matrix, glm::uvec2(cellWidth * (testPlayAreaWidth + (BufferAreaDepth * 2)), cellHeight * (testPlayAreaHeight + (BufferAreaDepth * 2))));
+	registry.emplace<Components::Position>(matrix);
+	registry.emplace<Components::Container>(matrix, glm::uvec2(testPlayAreaWidth + (BufferAreaDepth * 2), testPlayAreaHeight + (BufferAreaDepth * 2)), glm::uvec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(matrix, GetTagFromContainerType(containerType_t::MATRIX));
+	registry.emplace<Components::ReferenceEntity>(matrix, playArea);
+
+	const auto bagArea = registry.create();
+	registry.emplace<Components::Scale>(bagArea, glm::vec2(cellWidth * 4, cellHeight * 16));
+	registry.emplace<Components::Position>(bagArea);
+	registry.emplace<Components::Container>(bagArea, glm::uvec2(4, 16), glm::vec2(cellWidth, cellHeight));
+	registry.emplace<Components::Tag>(bagArea, GetTagFromContainerType(containerType_t::BAG_AREA));
+	registry.emplace<Components::Bag>(bagArea);
+	registry.emplace<Components::NodeOrder>(bagArea);
+	registry.emplace<Components::PreviewQueue>(bagArea, 7);
+
+	BuildGrid(registry, matrix);
+	BuildGrid(registry, bagArea);
+
+	const spawnType_t spawnTypes[] = { spawnType_t::WIDTH3, spawnType_t::ITETROMINO, spawnType_t::OTETROMINO };
+	for (const auto& spawnType : spawnTypes)
+	{
+		const auto marker = registry.create();
+		registry.emplace<Components::SpawnMarker>(marker, matrix, spawnType);
+		registry.emplace<Components::Coordinate>(marker, matrix, glm::uvec2(9, 12));
+	}
+
+	auto& nodeOrder = registry.get<Components::NodeOrder>(bagArea);
+	for (unsigned int y = 1; y < 16; y += 4)
+	{
+		const auto node = registry.create();
+		registry.emplace<Components::QueueNode>(node, node);
+		registry.emplace<Components::Coordinate>(node, bagArea, glm::uvec2(1, y));
+		nodeOrder.AddNode(node);
+	}
+	LinkNodes(registry, nodeOrder, bagArea, matrix);
+
+	// Every queued piece on show has a preview of the right type in its ring slot, and every other slot has none.
+	auto previewsMatchQueue = [&]()
+	{
+		const auto& previewQueue = registry.get<Components::PreviewQueue>(bagArea);
+		const unsigned int visibleCount = std::min<unsigned int>(static_cast<unsigned int>(nodeOrder.GetNodes().size()), previewQueue.GetSize());
+		for (unsigned int slot = 0; slot < Components::PreviewQueue::MaximumDepth; slot++)
+		{
+			const auto piece = previewQueue.GetPiece(slot);
+			const unsigned int position = previewQueue.GetPosition(slot);
+			if (position >= visibleCount)
+			{
+				if (piece != entt::null)
+					return false;
+				continue;
+			}
+
+			const auto* tetromino = GetTetrominoFromEntity(registry, piece);
+			if (tetromino == NULL || tetromino->GetType() != previewQueue.Peek(position))
+				return false;
+		}
+		return true;
+	};
+
+	auto previewAt = [&](const unsigned int& position)
+	{
+		const auto& previewQueue = registry.get<Components::PreviewQueue>(bagArea);
+		return previewQueue.GetPiece(previewQueue.GetSlot(position));
+	};
+
+	Systems::GenerationSystem(registry, 10.0);
+	EXPECT_EQ(registry.view<Components::Controllable>().size(), 1);
+	EXPECT_EQ(registry.get<Components::PreviewQueue>(bagArea).GetSize(), 7);
+	EXPECT_TRUE(previewsMatchQueue());
+	EXPECT_EQ(CountTetrominos(registry), 5);
+
+	// Nothing changes while a piece is in play.
+	const auto nextPiece = previewAt(0);
+	Systems::GenerationSystem(registry, 10.0);
+	EXPECT_EQ(previewAt(0), nextPiece);
+
+	// Each preview on show sits at the node for its place in the queue, and its blocks are the occupants of their own cells.
+	auto previewsOccupyTheirNodes = [&]()
+	{
+		const auto& previewQueue = registry.get<Components::PreviewQueue>(bagArea);
+		const auto& nodes = nodeOrder.GetNodes();
+		const auto& bagContainer = registry.get<Components::Container>(bagArea);
+		const unsigned int visibleCount = std::min<unsigned int>(static_cast<unsigned int>(nodes.size()), previewQueue.GetSize());
+		for (unsigned int position = 0; position < visibleCount; position++)
+		{
+			const auto piece = previewAt(position);
+			const auto* tetromino = GetTetrominoFromEntity(registry, piece);
+			if (tetromino == NULL || registry.get<Components::Coordinate>(piece).Get() != registry.get<Components::Coordinate>(nodes[nodes.size() - 1 - position]).Get())
+				return false;
+
+			for (int i = 0; i < 4; i++)
+			{
+				const auto block = tetromino->GetBlock(i);
+				if (bagContainer.GetOccupantAt(registry.get<Components::Coordinate>(block).Get()) != block)
+					return false;
+			}
+		}
+		return true;
+	};
+	EXPECT_TRUE(previewsOccupyTheirNodes());
+
+	// Once it's gone, the next piece moves into the matrix. The other previews keep their tetrominos and move a node along; only the newly shown one is spawned.
+	std::array<entt::entity, 3> keptPieces;
+	for (unsigned int position = 0; position < 3; position++)
+		keptPieces[position] = previewAt(position + 1);
+
+	const auto activePiece = GetActiveControllable(registry);
+	ReleaseTetromino(registry, activePiece);
+	Systems::GenerationSystem(registry, 10.0);
+	EXPECT_EQ(GetActiveControllable(registry), nextPiece);
+	EXPECT_TRUE(previewsMatchQueue());
+	EXPECT_TRUE(previewsOccupyTheirNodes());
+	EXPECT_EQ(CountTetrominos(registry), 5);
+	for (unsigned int position = 0; position < 3; position++)
+		EXPECT_EQ(previewAt(position), keptPieces[position]);
+
+	// And again, so every preview has moved at least once.
+	for (int advance = 0; advance < 3; advance++)
+	{
+		ReleaseTetromino(registry, GetActiveControllable(registry));
+		Systems::GenerationSystem(registry, 10.0);
+		EXPECT_TRUE(previewsMatchQueue());
+		EXPECT_TRUE(previewsOccupyTheirNodes());
+	}
+
+	// A shallower queue shows fewer previews.
+	registry.get<Components::PreviewQueue>(bagArea).SetDepth(2);
+	Systems::GenerationSystem(registry, 10.0);
+	EXPECT_TRUE(previewsMatchQueue());
+	EXPECT_EQ(CountTetrominos(registry), 3);
+}
+
+
+TEST(RandomizerTest, SeededSequencesRepeatAndDealInBulk) {
+	for (const auto& randomizerType : { randomizerType_t::SEVEN_BAG, randomizerType_t::FOURTEEN_BAG, randomizerType_t::TGM_HISTORY })
+	{
+		auto single = Randomizers::CreateRandomizer(randomizerType, 1234);
+		auto bulk = Randomizers::CreateRandomizer(randomizerType, 1234);
+
+		// Bulk dealing in odd sized chunks carries on the sequence exactly as single draws do.
+		std::array<tetrominoType_t, 140> dealt;
+		bulk->Generate(dealt.data(), 3);
+		bulk->Generate(dealt.data() + 3, 12);
+		bulk->Generate(dealt.data() + 15, dealt.size() - 15);
+		for (const auto& piece : dealt)
+			EXPECT_EQ(single->Next(), piece);
+
+		single->Seed(1234);
+		const auto first = single->Next();
+		EXPECT_EQ(first, dealt[0]);
+
+		if (randomizerType == randomizerType_t::TGM_HISTORY)
+		{
+			EXPECT_NE(first, tetrominoType_t::S);
+			EXPECT_NE(first, tetrominoType_t::Z);
+			EXPECT_NE(first, tetrominoType_t::O);
+			continue;
+		}
+
+		// Every bag holds each piece the same number of times.
+		const size_t bagSize = randomizerType == randomizerType_t::SEVEN_BAG ? 7 : 14;
+		for (size_t start = 0; start < dealt.size(); start += bagSize)
+		{
+			std::array<unsigned int, 7> counts = {};
+			for (size_t i = start; i < start + bagSize; i++)
+				counts[static_cast<unsigned int>(dealt[i])]++;
+			for (const auto& count : counts)
+				EXPECT_EQ(count, bagSize / 7);
+		}
+	}
+
+	// A bag dealt through the component follows its seed too.
+	Components::Bag seeded(randomizerType_t::SEVEN_BAG, 99);
+	auto reference = Randomizers::CreateRandomizer(randomizerType_t::SEVEN_BAG, 99);
+	for (unsigned int i = 0; i < 21; i++)
+		EXPECT_EQ(seeded.PopTetromino(), reference->Next());
+}
+
+TEST(GameContextTest, RegistriesKeepTheirOwnGameState) {
+	entt::registry first;
+	entt::registry second;
+
+	// Each registry gets its own tag lookup, so the same tag can name a different entity in each.
+	const auto firstMatrix = first.create();
+	first.emplace<Components::Tag>(firstMatrix, "Matrix");
+	second.create();
+	const auto secondMatrix = second.create();
+	second.emplace<Components::Tag>(secondMatrix, "Matrix");
+
+	EXPECT_EQ(FindEntityByTag(first, "Matrix"), firstMatrix);
+	EXPECT_EQ(FindEntityByTag(second, "Matrix"), secondMatrix);
+	EXPECT_NE(firstMatrix, secondMatrix);
+
+	// Scoring and game state in one game leave the other alone.
+	Systems::CompletionSystem(first, 1.0, 4);
+	GameState::SetState(first, gameState_t::GAME_OVER);
+
+	EXPECT_EQ(GetGameContext(first).gameScore, 800 * StartGameLevel);
+	EXPECT_EQ(GetGameContext(first).linesClearedTotal, 4);
+	EXPECT_EQ(GameState::GetState(first), gameState_t::GAME_OVER);
+
+	EXPECT_EQ(GetGameContext(second).gameScore, 0);
+	EXPECT_EQ(GetGameContext(second).linesClearedTotal, 0);
+	EXPECT_EQ(GameState::GetState(second), gameState_t::INIT);
+}
+
+TEST(GameTest, GamesRunAloneOnAnyThread) {
+	struct outcome_t
+	{
+		unsigned int ticks = 0;
+		unsigned int pieces = 0;
+		int score = 0;
+		gameState_t state = gameState_t::INIT;
+	};
+
+	const std::vector<playerInput_t> script = { playerInput_t::MOVE_LEFT, playerInput_t::ROTATE_CLOCKWISE, playerInput_t::HARD_DROP, playerInput_t::MOVE_RIGHT, playerInput_t::MOVE_RIGHT, playerInput_t::HARD_DROP };
+
+	auto play = [&](const uint32_t& seed)
+	{
+		entt::registry registry;
+		Game::Setup(registry);
+		registry.get<Components::Bag>(FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA))).Seed(seed);
+		GameState::SetState(registry, gameState_t::PLAY);
+
+		ScriptedInput input(script, 4);
+		outcome_t outcome;
+		for (; outcome.ticks < 6000 && GameState::GetState(registry) == gameState_t::PLAY; outcome.ticks++)
+		{
+			ApplyPlayerInput(registry, input.GetInput(registry, outcome.ticks));
+			Game::Tick(registry);
+		}
+
+		outcome.pieces = GetGameContext(registry).piecesDealt;
+		outcome.score = GetGameContext(registry).gameScore;
+		outcome.state = GameState::GetState(registry);
+		return outcome;
+	};
+
+	const unsigned int gameCount = 6;
+	std::vector<outcome_t> serial(gameCount);
+	for (unsigned int i = 0; i < gameCount; i++)
+		serial[i] = play(100 + i);
+
+	std::vector<outcome_t> parallel(gameCount);
+	ThreadPool pool(3);
+	pool.ParallelFor(gameCount, [&](size_t i) { parallel[i] = play(100 + static_cast<uint32_t>(i)); });
+
+	for (unsigned int i = 0; i < gameCount; i++)
+	{
+		EXPECT_EQ(parallel[i].ticks, serial[i].ticks);
+		EXPECT_EQ(parallel[i].pieces, serial[i].pieces);
+		EXPECT_EQ(parallel[i].score, serial[i].score);
+		EXPECT_EQ(parallel[i].state, serial[i].state);
+
+		// Pieces stacked without regard for lines reach the spawn area well within the tick limit, and spawning into the stack ends the game.
+		EXPECT_EQ(serial[i].state, gameState_t::GAME_OVER);
+		EXPECT_GT(serial[i].pieces, 4u);
+	}
+}
+
+TEST(BotTest, FindsEveryPlacementOnAnEmptyBoard) {
+	entt::registry registry;
+	Game::Setup(registry);
+
+	const Bot::field_t field = Bot::ReadField(registry);
+	const Bot::Board board = Bot::ReadBoard(registry, field);
+
+	// The play area is what the border walls fence in.
+	EXPECT_EQ(field.playAreaLower, glm::ivec2(BufferAreaDepth, BufferAreaDepth));
+	EXPECT_EQ(field.playAreaUpper, glm::ivec2(BufferAreaDepth + PlayAreaWidth, BufferAreaDepth + PlayAreaHeight));
+
+	// Every column each distinct shape can rest in across the ten wide play area.
+	const std::vector<std::pair<tetrominoType_t, size_t>> expected = { { tetrominoType_t::O, 9 }, { tetrominoType_t::I, 17 }, { tetrominoType_t::T, 34 } };
+	for (const auto& [type, count] : expected)
+	{
+		Bot::piece_t spawn;
+		ASSERT_TRUE(board.GetSpawn(type, spawn));
+		ASSERT_TRUE(board.Fits(spawn));
+
+		const auto placements = Bot::FindPlacements(board, spawn);
+		EXPECT_EQ(placements.size(), count);
+
+		for (const auto& placement : placements)
+		{
+			EXPECT_TRUE(board.Fits(placement));
+			EXPECT_EQ(board.Drop(placement), placement);
+			EXPECT_NE(Bot::NextInput(board, spawn, placement), playerInput_t::NONE);
+
+			// The path starts at the spawn, and the piece at the end of it drops onto the placement's cells.
+			Bot::path_t path;
+			ASSERT_TRUE(Bot::FindPath(board, spawn, placement, path));
+			ASSERT_EQ(path.pieces.size(), path.moves.size() + 1);
+			EXPECT_EQ(path.pieces.front(), spawn);
+			auto landed = Bot::Board::GetCells(board.Drop(path.pieces.back()));
+			auto wanted = Bot::Board::GetCells(placement);
+			const auto byCell = [](const glm::ivec2& a, const glm::ivec2& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; };
+			std::sort(landed.begin(), landed.end(), byCell);
+			std::sort(wanted.begin(), wanted.end(), byCell);
+			EXPECT_EQ(landed, wanted);
+		}
+	}
+
+	// The pool only changes who does the scoring, never the choice.
+	Bot::piece_t current;
+	ASSERT_TRUE(board.GetSpawn(tetrominoType_t::L, current));
+	const std::vector<tetrominoType_t> preview = { tetrominoType_t::I };
+
+	Bot::piece_t serialChoice;
+	ASSERT_TRUE(Bot::ChoosePlacement(board, current, preview, Bot::weights_t(), nullptr, serialChoice));
+
+	ThreadPool pool(3);
+	Bot::piece_t parallelChoice;
+	ASSERT_TRUE(Bot::ChoosePlacement(board, current, preview, Bot::weights_t(), &pool, parallelChoice));
+	EXPECT_EQ(parallelChoice, serialChoice);
+}
+
+TEST(BotTest, BotInputClearsLines) {
+	entt::registry registry;
+	Game::Setup(registry);
+	registry.get<Components::Bag>(FindEntityByTag(registry, GetTagFromContainerType(containerType_t::BAG_AREA))).Seed(7);
+	GameState::SetState(registry, gameState_t::PLAY);
+
+	BotInput input;
+	for (unsigned int tick = 0; tick < 3000 && GameState::GetState(registry) == gameState_t::PLAY; tick++)
+	{
+		ApplyPlayerInput(registry, input.GetInput(registry, tick));
+		Game::Tick(registry);
+	}
+
+	EXPECT_EQ(GameState::GetState(registry), gameState_t::PLAY);
+	EXPECT_GT(GetGameContext(registry).linesClearedTotal, 10);
+	EXPECT_GE(input.GetPlanCount(), GetGameContext(registry).piecesDealt);
+}
+
+TEST(BotTest, ExpectimaxSearchIsRepeatable) {
+	entt::registry registry;
+	Game::Setup(registry);
+
+	const Bot::field_t field = Bot::ReadField(registry);
+	Bot::Board board = Bot::ReadBoard(registry, field);
+
+	// A 7-bag with only the I and O left to deal, put back before two hidden preview pieces.
+	Bot::bagState_t bag;
+	bag.copies = 1;
+	bag.remaining[static_cast<int>(tetrominoType_t::I)] = 1;
+	bag.remaining[static_cast<int>(tetrominoType_t::O)] = 1;
+	const Bot::bagState_t rewound = Bot::RewindBag(bag, { tetrominoType_t::S, tetrominoType_t::Z });
+	EXPECT_EQ(rewound.remaining[static_cast<int>(tetrominoType_t::S)], 1);
+	EXPECT_EQ(rewound.remaining[static_cast<int>(tetrominoType_t::Z)], 1);
+	EXPECT_EQ(rewound.remaining[static_cast<int>(tetrominoType_t::T)], 0);
+
+	// Dealing out a whole bag and putting it back leaves the bag as empty as it started, which is as good as full.
+	const Bot::bagState_t emptied = Bot::RewindBag(Bot::bagState_t{ {}, 1 }, { tetrominoType_t::T });
+	EXPECT_EQ(emptied.remaining[static_cast<int>(tetrominoType_t::T)], 1);
+
+	Bot::expectimaxSettings_t settings;
+	settings.depth = 3;
+	settings.width = 3;
+	settings.tableSizeLog2 = 12;
+
+	const std::vector<tetrominoType_t> sequence = { tetrominoType_t::I, tetrominoType_t::O, tetrominoType_t::T, tetrominoType_t::L, tetrominoType_t::J, tetrominoType_t::I };
+	ThreadPool pool(3);
+	for (size_t i = 0; i + 1 < sequence.size(); i++)
+	{
+		Bot::piece_t current;
+		ASSERT_TRUE(board.GetSpawn(sequence[i], current));
+		const std::vector<tetrominoType_t> preview = { sequence[i + 1] };
+
+		// The pool and the table only change how fast the search goes, never the choice.
+		Bot::Expectimax serial(Bot::weights_t(), settings);
+		Bot::piece_t serialChoice;
+		ASSERT_TRUE(serial.Choose(board, current, preview, rewound, nullptr, serialChoice));
+		EXPECT_GT(serial.GetStats().nodes, 0u);
+
+		Bot::piece_t repeatChoice;
+		ASSERT_TRUE(serial.Choose(board, current, preview, rewound, nullptr, repeatChoice));
+		EXPECT_EQ(repeatChoice, serialChoice);
+		EXPECT_GT(serial.GetStats().tableHits, 0u);
+
+		Bot::Expectimax parallel(Bot::weights_t(), settings);
+		Bot::piece_t parallelChoice;
+		ASSERT_TRUE(parallel.Choose(board, current, preview, rewound, &pool, parallelChoice));
+		EXPECT_EQ(parallelChoice, serialChoice);
+
+		// The hash kept up through placing matches one worked out from scratch.
+		board.Place(serialChoice);
+		EXPECT_EQ(board.GetHash(), Bot::Board(field, board.GetBlockRows(), board.GetOrientation()).GetHash());
+	}
+}
+
+TEST(ThreadPoolTest, WaitsFinishAndHandBackFailures) {
+	ThreadPool pool(2);
+
+	// Nested ParallelFors finish from inside tasks, and the outer one from outside the pool.
+	std::atomic<int> sum{ 0 };
+	pool.ParallelFor(8, [&pool, &sum](size_t i)
+		{
+			pool.ParallelFor(8, [&sum, i](size_t j) { sum += static_cast<int>(i * 8 + j); });
+		});
+	EXPECT_EQ(sum, 64 * 63 / 2);
+
+	// A submitted task that throws doesn't take the pool down, and Wait hands the exception back once.
+	std::atomic<int> finished{ 0 };
+	pool.Submit([] { throw std::runtime_error("task failed"); });
+	for (int i = 0; i < 16; i++)
+		pool.Submit([&finished] { finished++; });
+	EXPECT_THROW(pool.Wait(), std::runtime_error);
+	EXPECT_EQ(finished, 16);
+	EXPECT_NO_THROW(pool.Wait());
+
+	EXPECT_THROW(pool.ParallelFor(4, [](size_t i) { if (i == 2) throw std::runtime_error("item failed"); }), std::runtime_error);
+}
+
+TEST(GameClockTest, TicksAdvanceTheSimulationClock) {
+	entt::registry registry;
+	Game::Setup(registry);
+	GameState::SetState(registry, gameState_t::PLAY);
+
+	auto& context = GetGameContext(registry);
+	context.tickLength = 0.02;
+
+	// The first piece comes in generationTimeDelay after the start, however quickly the ticks are run.
+	for (int i = 0; i < 5; i++)
+		Game::Tick(registry);
+	EXPECT_EQ(context.piecesDealt, 0u);
+
+	for (int i = 0; i < 10; i++)
+		Game::Tick(registry);
+	EXPECT_EQ(context.piecesDealt, 1u);
+	EXPECT_EQ(context.tick, 15u);
+	EXPECT_DOUBLE_EQ(GetSimulationTime(context), 15 * 0.02);
+
+	// Out of play, the clock stands still.
+	GameState::SetState(registry, gameState_t::MENU);
+	Game::Tick(registry);
+	EXPECT_EQ(context.tick, 15u);
+}
+
+TEST(ReplayTest, PlaybackMatchesTheRecordedGame) {
+	const std::string path = "replay_test.sbr";
+
+	Replay::header_t header;
+	header.seed = 1234;
+	header.tickLength = 0.02;
+
+	entt::registry registry;
+	Replay::StartGame(registry, header);
+	EXPECT_EQ(Replay::ReadHeader(registry).seed, header.seed);
+
+	auto& context = GetGameContext(registry);
+	const Bot::field_t field = Bot::ReadField(registry);
+	BotInput input(Bot::weights_t(), nullptr, 3);
+
+	const uint64_t midpoint = 700;
+	Bot::rows_t midpointRows{};
+	int midpointScore = 0;
+	size_t inputCount = 0;
+	{
+		Replay::Recorder recorder(path, Replay::ReadHeader(registry));
+		while (context.tick < 2000 && GameState::GetState(registry) == gameState_t::PLAY)
+		{
+			if (context.tick == midpoint)
+			{
+				midpointRows = Bot::ReadBoard(registry, field).GetBlockRows();
+				midpointScore = context.gameScore;
+			}
+
+			const playerInput_t playerInput = input.GetInput(registry, static_cast<unsigned int>(context.tick));
+			recorder.Record(context.tick, playerInput);
+			inputCount += playerInput != playerInput_t::NONE;
+			ApplyPlayerInput(registry, playerInput);
+			Game::Tick(registry);
+		}
+		recorder.Finish(context.tick);
+	}
+	ASSERT_GT(context.tick, midpoint);
+
+	const Replay::recording_t recording = Replay::Load(path);
+	std::remove(path.c_str());
+	EXPECT_EQ(recording.header.seed, header.seed);
+	EXPECT_EQ(recording.header.tickLength, header.tickLength);
+	EXPECT_EQ(recording.events.size(), inputCount);
+	EXPECT_EQ(recording.tickCount, context.tick);
+
+	Replay::Player player(recording, 200);
+	while (player.Step())
+	{
+	}
+
+	const auto& played = GetGameContext(player.GetRegistry());
+	EXPECT_EQ(player.GetTick(), context.tick);
+	EXPECT_EQ(played.piecesDealt, context.piecesDealt);
+	EXPECT_EQ(played.gameScore, context.gameScore);
+	EXPECT_EQ(played.linesClearedTotal, context.linesClearedTotal);
+	EXPECT_EQ(Bot::ReadBoard(player.GetRegistry(), field).GetBlockRows(), Bot::ReadBoard(registry, field).GetBlockRows());
+	EXPECT_GT(player.GetKeyframeCount(), 1u);
+
+	// Back to the middle from a keyframe, then on to the end again, through the same states as the straight run.
+	player.Seek(midpoint);
+	EXPECT_EQ(player.GetTick(), midpoint);
+	EXPECT_EQ(GetGameContext(player.GetRegistry()).gameScore, midpointScore);
+	EXPECT_EQ(Bot::ReadBoard(player.GetRegistry(), field).GetBlockRows(), midpointRows);
+
+	player.Seek(recording.tickCount);
+	EXPECT_EQ(GetGameContext(player.GetRegistry()).gameScore, context.gameScore);
+	EXPECT_EQ(Bot::ReadBoard(player.GetRegistry(), field).GetBlockRows(), Bot::ReadBoard(registry, field).GetBlockRows());
+}
+
+// CopyGame lists the pools it copies by hand, so this catches a component that's been added to the game but not to that list.
+TEST(ReplayTest, CopyGameCopiesEveryComponent) {
+	Replay::header_t header;
+	header.seed = 4321;
+	header.tickLength = 0.02;
+
+	entt::registry registry;
+	Replay::StartGame(registry, header);
+
+	auto& context = GetGameContext(registry);
+	BotInput input(Bot::weights_t(), nullptr, 2);
+
+	// Copied all through a game, so components that only come and go, like a lock or a parked block, are caught too.
+	size_t copies = 0;
+	while (context.tick < 1500 && GameState::GetState(registry) == gameState_t::PLAY)
+	{
+		ApplyPlayerInput(registry, input.GetInput(registry, static_cast<unsigned int>(context.tick)));
+		Game::Tick(registry);
+		if (context.tick % 50 != 0)
+			continue;
+
+		entt::registry copy;
+		Replay::CopyGame(registry, copy);
+		copies++;
+
+		registry.each([&](const entt::entity entity)
+		{
+			std::vector<std::string> missing;
+			registry.visit(entity, [&](const entt::type_info info)
+			{
+				bool copied = false;
+				copy.visit(entity, [&](const entt::type_info copiedInfo) { copied |= copiedInfo.hash() == info.hash(); });
+				if (!copied)
+					missing.push_back(std::string(info.name()));
+			});
+			EXPECT_TRUE(missing.empty()) << "Not copied at tick " << context.tick << ": " << (missing.empty() ? std::string() : missing.front());
+		});
+	}
+	EXPECT_GT(copies, 10u);
+}
+
+TEST(ChecksumTest, PlaybackFindsTheFirstDivergingTick) {
+	const std::string path = "checksum_test.sbr";
+
+	Replay::header_t header;
+	header.seed = 99;
+	header.tickLength = 0.02;
+	header.checksumInterval = 1;
+
+	entt::registry registry;
+	Replay::StartGame(registry, header);
+
+	auto& context = GetGameContext(registry);
+	BotInput input(Bot::weights_t(), nullptr, 2);
+	{
+		Replay::Recorder recorder(path, header);
+		while (context.tick < 900 && GameState::GetState(registry) == gameState_t::PLAY)
+		{
+			const playerInput_t playerInput = input.GetInput(registry, static_cast<unsigned int>(context.tick));
+			recorder.Record(context.tick, playerInput);
+			ApplyPlayerInput(registry, playerInput);
+			Game::Tick(registry);
+			recorder.RecordChecksum(context.tick, context.checksum);
+		}
+		recorder.Finish(context.tick);
+	}
+	ASSERT_GT(context.linesClearedTotal, 0);
+
+	// The hash the matrix keeps up as blocks come and go matches one worked out from scratch, line clears and all.
+	const auto& matrix = registry.get<Components::Container>(FindEntityByTag(registry, GetTagFromContainerType(containerType_t::MATRIX)));
+	const uint64_t* rows = matrix.GetBlockRowData();
+	uint64_t blockHash = 0;
+	for (unsigned int y = 0; y < matrix.GetGridDimensions().y; y++)
+	{
+		for (unsigned int x = 0; x < matrix.GetGridDimensions().x; x++)
+		{
+			if ((rows[y] >> x) & 1)
+				blockHash ^= Checksum::GetCellKey(x, y);
+		}
+	}
+	EXPECT_EQ(matrix.GetBlockHash(), blockHash);
+
+	const uint64_t checksum = Checksum::ComputeChecksum(registry);
+	EXPECT_EQ(checksum, context.checksum);
+	context.gameScore++;
+	EXPECT_NE(Checksum::ComputeChecksum(registry), checksum);
+	context.gameScore--;
+
+	Replay::recording_t recording = Replay::Load(path);
+	std::remove(path.c_str());
+	EXPECT_EQ(recording.header.checksumInterval, 1u);
+	ASSERT_EQ(recording.checkpoints.size(), context.tick);
+
+	Replay::Player player(recording, 100);
+	while (player.Step())
+	{
+	}
+	EXPECT_EQ(player.GetVerification().checked, recording.checkpoints.size());
+	EXPECT_FALSE(player.GetVerification().diverged);
+
+	// A game that's gone differently is caught at the first tick it differs by.
+	recording.checkpoints[400].checksum ^= 1;
+	Replay::Player tampered(recording, 100);
+	while (tampered.Step())
+	{
+	}
+	EXPECT_TRUE(tampered.GetVerification().diverged);
+	EXPECT_EQ(tampered.GetVerification().divergedTick, recording.checkpoints[400].tick);
+	EXPECT_EQ(tampered.GetVerification().lastMatchedTick, recording.checkpoints[399].tick);
 }
\ No newline at end of file